@@ -0,0 +1,494 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+// ============= FLUENT LIB C =============
+// clock_bench: built-in micro-benchmarks
+// ----------------------------------------
+// Usage: clock_bench [--format table|json|csv] [--filter TEXT] [--pin CPU]
+//                    [--samples N] [--target-ms N] [--warmup-ms N] [--quick]
+//                    [--accuracy] [--drift-s N]
+//
+// Benchmarks every clock source and every nanosecond conversion variant,
+// so regressions in `get_nano_time()` can be tracked per platform.
+//
+// With --accuracy it runs the correctness checks of checks/clock_checks.h
+// instead (the same ones the clock_tests ctest target runs), in the same
+// output formats, and exits with status 1 if any fails. --drift-s sets the
+// length of the TSC drift check (default 10).
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../clock.h"
+#include "../clock_bench.h"
+#include "../clock_cached.h"
+#include "../clock_deadline.h"
+#include "../clock_profile.h"
+#include "../clock_stats.h"
+#include "../clock_window.h"
+#include "../checks/clock_checks.h"
+
+#define BENCH_INPUTS 1024 // Power of two, indexes are masked
+#define BENCH_STAMP_BURST 64 // Typical packet burst for hr_clock_stamp_batch()
+
+static volatile long long bench_sink;
+static long long bench_inputs[BENCH_INPUTS];
+
+/**
+ * \brief Fills the conversion inputs with durations spread over ns .. days.
+ */
+static void bench_init_inputs()
+{
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < BENCH_INPUTS; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        bench_inputs[i] = (long long)(state >> (17 + state % 40)); // Up to ~2^47 ns (~1.6 days)
+    }
+}
+
+// ============= CLOCK SOURCES =============
+
+static void bench_get_nano_time(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        sum += get_nano_time();
+    }
+    bench_sink = sum;
+}
+
+static void bench_get_nano_time_ex(void *ctx, const unsigned long long n)
+{
+    const hr_clock_source_t source = *(const hr_clock_source_t *)ctx;
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        sum += get_nano_time_ex(source);
+    }
+    bench_sink = sum;
+}
+
+static void bench_ticks_now(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        const hr_ticks_t ticks = hr_ticks_now();
+        sum += ticks.ticks + ticks.nanos;
+    }
+    bench_sink = sum;
+}
+
+static void bench_cached_now(void *ctx, const unsigned long long n)
+{
+    (void)ctx; // The driver runs the ticker for this case only
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        sum += hr_clock_cached_now();
+    }
+    bench_sink = sum;
+}
+
+static void bench_clock_tick_distance(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    long long sum = 0;
+    hr_clock_t clock;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        hr_clock_tick(&clock);
+        sum += hr_clock_distance_from_now(&clock, CLOCK_NANOSECONDS);
+    }
+    bench_sink = sum;
+}
+
+// ============= CONVERSIONS =============
+
+static void bench_division_reference(void *ctx, const unsigned long long n)
+{
+    volatile long long divisor = hr_clock_unit_nanos[*(const hr_clock_time_unit_t *)ctx]; // Defeat constant folding
+    const long long d = divisor;
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        sum += bench_inputs[i & (BENCH_INPUTS - 1)] / d;
+    }
+    bench_sink = sum;
+}
+
+static void bench_nanos_to_unit(void *ctx, const unsigned long long n)
+{
+    const hr_clock_time_unit_t unit = *(const hr_clock_time_unit_t *)ctx;
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        sum += clock_nanos_to_unit(bench_inputs[i & (BENCH_INPUTS - 1)], unit);
+    }
+    bench_sink = sum;
+}
+
+static void bench_nanos_to_unit_mixed(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        const long long value = bench_inputs[i & (BENCH_INPUTS - 1)];
+        sum += clock_nanos_to_unit(value, (hr_clock_time_unit_t)((unsigned long long)value % 7));
+    }
+    bench_sink = sum;
+}
+
+static void bench_nanos_to_unit_f64(void *ctx, const unsigned long long n)
+{
+    const hr_clock_time_unit_t unit = *(const hr_clock_time_unit_t *)ctx;
+    double sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        sum += clock_nanos_to_unit_f64(bench_inputs[i & (BENCH_INPUTS - 1)], unit);
+    }
+    bench_sink = (long long)sum;
+}
+
+static void bench_nanos_to_unit_round(void *ctx, const unsigned long long n)
+{
+    const hr_clock_time_unit_t unit = *(const hr_clock_time_unit_t *)ctx;
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        sum += clock_nanos_to_unit_round(bench_inputs[i & (BENCH_INPUTS - 1)], unit);
+    }
+    bench_sink = sum;
+}
+
+static void bench_nanos_to_unit_ceil(void *ctx, const unsigned long long n)
+{
+    const hr_clock_time_unit_t unit = *(const hr_clock_time_unit_t *)ctx;
+    long long sum = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        sum += clock_nanos_to_unit_ceil(bench_inputs[i & (BENCH_INPUTS - 1)], unit);
+    }
+    bench_sink = sum;
+}
+
+static void bench_nanos_split(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    long long sum = 0;
+    hr_clock_split_t split;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        clock_nanos_split(bench_inputs[i & (BENCH_INPUTS - 1)], &split);
+        sum += split.days + split.hours + split.nanoseconds;
+    }
+    bench_sink = sum;
+}
+
+static void bench_nanos_to_unit_batch(void *ctx, const unsigned long long n)
+{
+    static long long out[BENCH_INPUTS];
+    const hr_clock_time_unit_t unit = *(const hr_clock_time_unit_t *)ctx;
+
+    // One iteration is one converted element
+    unsigned long long done = 0;
+    while (done < n)
+    {
+        const unsigned long long chunk = n - done < BENCH_INPUTS ? n - done : BENCH_INPUTS;
+        clock_nanos_to_unit_batch(bench_inputs, out, (size_t)chunk, unit);
+        done += chunk;
+    }
+    bench_sink = out[0];
+}
+
+static void bench_stamp_batch(void *ctx, const unsigned long long n)
+{
+    static long long out[BENCH_STAMP_BURST];
+    const hr_stamp_policy_t policy = *(const hr_stamp_policy_t *)ctx;
+
+    // One iteration is one stamped element
+    unsigned long long done = 0;
+    while (done < n)
+    {
+        const unsigned long long chunk = n - done < BENCH_STAMP_BURST ? n - done : BENCH_STAMP_BURST;
+        hr_clock_stamp_batch(out, (size_t)chunk, policy);
+        done += chunk;
+    }
+    bench_sink = out[0];
+}
+
+static void bench_stats_add(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    hr_duration_stats_t stats;
+    hr_duration_stats_init(&stats, 1, CLOCK_SECONDS);
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        hr_duration_stats_add_at(&stats, bench_inputs[i & (BENCH_INPUTS - 1)], (long long)i);
+    }
+    bench_sink = (long long)stats.mean;
+}
+
+static void bench_stats_add_batch(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    hr_duration_stats_t stats;
+    hr_duration_stats_init(&stats, 1, CLOCK_SECONDS);
+
+    // One iteration is one ingested sample
+    unsigned long long done = 0;
+    while (done < n)
+    {
+        const unsigned long long chunk = n - done < BENCH_INPUTS ? n - done : BENCH_INPUTS;
+        hr_duration_stats_add_batch(&stats, bench_inputs, (size_t)chunk, (long long)done);
+        done += chunk;
+    }
+    bench_sink = (long long)stats.mean;
+}
+
+static void bench_deadline_poll(void *ctx, const unsigned long long n)
+{
+    const hr_deadline_clock_t clock = *(const hr_deadline_clock_t *)ctx;
+    hr_deadline_t deadline = hr_deadline_in(1, CLOCK_HOURS);
+    hr_deadline_set_poll(&deadline, clock, 0);
+    int expired = 0;
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        expired += hr_deadline_poll(&deadline);
+    }
+    bench_sink = expired;
+}
+
+static void bench_timed_scope(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    static volatile int callsite = 0;
+    const unsigned int id = hr_profile_callsite(&callsite, "bench.scope");
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        const hr_timed_scope_t scope = hr_timed_scope_begin(id);
+        hr_timed_scope_end(&scope);
+    }
+}
+
+static void bench_window_record(void *ctx, const unsigned long long n)
+{
+    (void)ctx;
+    hr_window_series_t series;
+    if (!hr_window_series_init(&series, 64, 1, CLOCK_MICROSECONDS, 0))
+    {
+        return;
+    }
+
+    // Ten samples per window, so rotation is part of the cost
+    for (unsigned long long i = 0; i < n; i++)
+    {
+        hr_window_series_record_at(&series, bench_inputs[i & (BENCH_INPUTS - 1)], (long long)(i * 100));
+    }
+    bench_sink = (long long)series.buckets[0].count;
+    hr_window_series_destroy(&series);
+}
+
+// ============= DRIVER =============
+
+typedef struct
+{
+    char name[64];
+    hr_bench_fn_t fn;
+    int arg;
+} bench_case_t;
+
+static int bench_add(bench_case_t *const cases, const int count, const char *const name, const hr_bench_fn_t fn, const int arg)
+{
+    snprintf(cases[count].name, sizeof(cases[count].name), "%s", name);
+    cases[count].fn = fn;
+    cases[count].arg = arg;
+    return count + 1;
+}
+
+static void usage(const char *const program)
+{
+    fprintf(
+        stderr,
+        "Usage: %s [--format table|json|csv] [--filter TEXT] [--pin CPU]\n"
+        "          [--samples N] [--target-ms N] [--warmup-ms N] [--quick]\n"
+        "          [--accuracy] [--drift-s N]\n",
+        program
+    );
+}
+
+int main(const int argc, char **argv)
+{
+    hr_bench_options_t opts;
+    hr_bench_options_default(&opts);
+    const char *format = "table";
+    const char *filter = NULL;
+    int accuracy = 0;
+    long long drift_s = 10;
+    long long random_values = 1LL << 22;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const int has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--format") == 0 && has_value)
+        {
+            format = argv[++i];
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && has_value)
+        {
+            filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--pin") == 0 && has_value)
+        {
+            opts.pin_cpu = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--samples") == 0 && has_value)
+        {
+            opts.samples = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--target-ms") == 0 && has_value)
+        {
+            opts.target_ns = atoll(argv[++i]) * 1000000LL;
+        }
+        else if (strcmp(argv[i], "--warmup-ms") == 0 && has_value)
+        {
+            opts.warmup_ns = atoll(argv[++i]) * 1000000LL;
+        }
+        else if (strcmp(argv[i], "--quick") == 0)
+        {
+            opts.samples = 10;
+            opts.target_ns = 1000000LL;
+            opts.warmup_ns = 10000000LL;
+            drift_s = 2;
+            random_values = 1LL << 16;
+        }
+        else if (strcmp(argv[i], "--accuracy") == 0)
+        {
+            accuracy = 1;
+        }
+        else if (strcmp(argv[i], "--drift-s") == 0 && has_value)
+        {
+            drift_s = atoll(argv[++i]);
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    bench_init_inputs();
+    hr_clock_init();
+
+    if (accuracy)
+    {
+        return clock_run_checks(format, filter, drift_s, random_values);
+    }
+
+    bench_case_t cases[64];
+    int count = 0;
+    char name[64];
+
+    count = bench_add(cases, count, "get_nano_time", bench_get_nano_time, 0);
+    for (int s = 0; s < FLUENT_LIBC_CLOCK_SOURCE_COUNT; s++)
+    {
+        snprintf(name, sizeof(name), "get_nano_time_ex/%s", clock_check_source_names[s]);
+        count = bench_add(cases, count, name, bench_get_nano_time_ex, s);
+    }
+    count = bench_add(cases, count, "hr_ticks_now", bench_ticks_now, 0);
+    count = bench_add(cases, count, "hr_clock_cached_now", bench_cached_now, 0);
+    count = bench_add(cases, count, "hr_clock_tick+distance_from_now", bench_clock_tick_distance, 0);
+
+    for (int u = CLOCK_NANOSECONDS; u <= CLOCK_DAYS; u++)
+    {
+        snprintf(name, sizeof(name), "division_reference/%s", clock_check_unit_names[u]);
+        count = bench_add(cases, count, name, bench_division_reference, u);
+        snprintf(name, sizeof(name), "clock_nanos_to_unit/%s", clock_check_unit_names[u]);
+        count = bench_add(cases, count, name, bench_nanos_to_unit, u);
+    }
+    count = bench_add(cases, count, "clock_nanos_to_unit/mixed", bench_nanos_to_unit_mixed, 0);
+    count = bench_add(cases, count, "clock_nanos_to_unit_f64/ms", bench_nanos_to_unit_f64, CLOCK_MILLISECONDS);
+    count = bench_add(cases, count, "clock_nanos_to_unit_round/ms", bench_nanos_to_unit_round, CLOCK_MILLISECONDS);
+    count = bench_add(cases, count, "clock_nanos_to_unit_ceil/ms", bench_nanos_to_unit_ceil, CLOCK_MILLISECONDS);
+    count = bench_add(cases, count, "clock_nanos_split", bench_nanos_split, 0);
+    count = bench_add(cases, count, "clock_nanos_to_unit_batch/us", bench_nanos_to_unit_batch, CLOCK_MICROSECONDS);
+    count = bench_add(cases, count, "clock_nanos_to_unit_batch/s", bench_nanos_to_unit_batch, CLOCK_SECONDS);
+    count = bench_add(cases, count, "hr_clock_stamp_batch/shared", bench_stamp_batch, HR_STAMP_SHARED);
+    count = bench_add(cases, count, "hr_clock_stamp_batch/interpolated", bench_stamp_batch, HR_STAMP_INTERPOLATED);
+    count = bench_add(cases, count, "hr_clock_stamp_batch/serialized", bench_stamp_batch, HR_STAMP_SERIALIZED);
+    count = bench_add(cases, count, "hr_duration_stats_add_at", bench_stats_add, 0);
+    count = bench_add(cases, count, "hr_duration_stats_add_batch", bench_stats_add_batch, 0);
+    count = bench_add(cases, count, "hr_deadline_poll/precise", bench_deadline_poll, HR_DEADLINE_CLOCK_PRECISE);
+    count = bench_add(cases, count, "hr_deadline_poll/coarse", bench_deadline_poll, HR_DEADLINE_CLOCK_COARSE);
+    count = bench_add(cases, count, "hr_timed_scope_begin+end", bench_timed_scope, 0);
+    count = bench_add(cases, count, "hr_window_series_record_at", bench_window_record, 0);
+
+    hr_bench_result_t results[64];
+    size_t completed = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (filter != NULL && strstr(cases[i].name, filter) == NULL)
+        {
+            continue;
+        }
+
+        // Each case reads its argument through the type it was registered with
+        hr_clock_source_t source = (hr_clock_source_t)cases[i].arg;
+        hr_clock_time_unit_t unit = (hr_clock_time_unit_t)cases[i].arg;
+        hr_stamp_policy_t policy = (hr_stamp_policy_t)cases[i].arg;
+        hr_deadline_clock_t deadline_clock = (hr_deadline_clock_t)cases[i].arg;
+        void *ctx = &unit;
+        if (cases[i].fn == bench_get_nano_time_ex)
+        {
+            ctx = &source;
+        }
+        else if (cases[i].fn == bench_stamp_batch)
+        {
+            ctx = &policy;
+        }
+        else if (cases[i].fn == bench_deadline_poll)
+        {
+            ctx = &deadline_clock;
+        }
+
+        // The ticker wakes every millisecond; keep it from disturbing the other cases
+        const int ticker = cases[i].fn == bench_cached_now && hr_clock_cached_start(0);
+
+        opts.name = cases[i].name;
+        results[completed++] = hr_bench_run(cases[i].fn, ctx, &opts);
+        if (ticker)
+        {
+            hr_clock_cached_stop();
+        }
+    }
+
+    if (strcmp(format, "json") == 0)
+    {
+        hr_bench_write_json(stdout, results, completed);
+    }
+    else if (strcmp(format, "csv") == 0)
+    {
+        hr_bench_write_csv(stdout, results, completed);
+    }
+    else
+    {
+        hr_bench_write_table(stdout, results, completed);
+    }
+
+    return 0;
+}
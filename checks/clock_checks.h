@@ -0,0 +1,1107 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_CHECKS_H
+#define FLUENT_LIBC_CLOCK_CHECKS_H
+
+// ============= FLUENT LIB C =============
+// Correctness and Accuracy Checks
+// ----------------------------------------
+// Shared by the clock_tests ctest target and `clock_bench --accuracy`.
+//
+// Features:
+// - `conversion/<unit>`: every conversion against reference division
+// - `monotonic/<source>`: no read behind an earlier read, across threads
+// - `jitter/<source>`: step distribution between consecutive reads
+// - `drift/tsc_vs_monotonic`: TSC drift against CLOCK_MONOTONIC, in ppm
+// - `timer_wheel/*`: deterministic timer wheel ordering and lateness checks
+// - `stamps/*`, `rate_limit/*`, `window/*`, `stats/*`, `duration/*`, `sync/*`,
+//   `deadline/*`: deterministic checks of the clock_*.h utilities
+// - `clock_run_checks()`: Run the checks matching a filter and report them
+//
+// Example:
+// ----------------------------------------
+//   hr_clock_init();
+//   return clock_run_checks("table", "conversion/", 10, 1LL << 22);
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../clock.h"
+#include "../clock_bench.h"
+#include "../clock_deadline.h"
+#include "../clock_duration.h"
+#include "../clock_rate_limit.h"
+#include "../clock_sleep.h"
+#include "../clock_stamps.h"
+#include "../clock_stats.h"
+#include "../clock_sync.h"
+#include "../clock_thread.h"
+#include "../clock_timer_wheel.h"
+#include "../clock_window.h"
+
+static const char *const clock_check_source_names[FLUENT_LIBC_CLOCK_SOURCE_COUNT] = {
+    "monotonic", "tsc", "tscp", "monotonic_coarse", "monotonic_raw", "boottime", "thread_cputime", "process_cputime"
+};
+
+static const char *const clock_check_unit_names[CLOCK_DAYS + 1] = {
+    "ns", "us", "ms", "s", "min", "h", "days"
+};
+
+#define CLOCK_CHECK_JITTER_READS 65536 // Consecutive reads per source for the jitter distribution
+#define CLOCK_CHECK_MONOTONIC_THREADS 4
+#define CLOCK_CHECK_MONOTONIC_READS 1000000
+#define CLOCK_CHECK_DRIFT_LIMIT_PPM 100.0 // Far beyond calibration error; catches a wrong TSC frequency
+
+/**
+ * \struct clock_check_t
+ * \brief Outcome of one correctness or accuracy check.
+ */
+typedef struct
+{
+    char name[64];               ///< Check name
+    unsigned long long checked;  ///< Values, reads, or samples examined
+    unsigned long long failures; ///< Violations; any fails the run
+    double median;               ///< Median of the measured quantity (0 if none)
+    double p99;                  ///< 99th percentile of the measured quantity
+    double max;                  ///< Largest value of the measured quantity
+    const char *unit;            ///< Unit of median, p99 and max
+} clock_check_t;
+
+static clock_check_t clock_check_begin(const char *const name, const char *const unit)
+{
+    clock_check_t check;
+    memset(&check, 0, sizeof(check));
+    snprintf(check.name, sizeof(check.name), "%s", name);
+    check.unit = unit;
+    return check;
+}
+
+static unsigned long long clock_check_xorshift(unsigned long long *const state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/**
+ * \brief Compares every conversion of \p nanos against reference division.
+ */
+static void clock_check_value(clock_check_t *const check, const long long nanos, const hr_clock_time_unit_t unit)
+{
+    const long long length = hr_clock_unit_nanos[unit];
+    const long long quotient = nanos / length;
+    const long long remainder = nanos % length;
+    const long long magnitude = remainder < 0 ? -remainder : remainder;
+    const long long rounded = magnitude >= length - magnitude ? quotient + (remainder < 0 ? -1 : 1) : quotient;
+    long long batch;
+    clock_nanos_to_unit_batch(&nanos, &batch, 1, unit);
+
+    check->checked++;
+    check->failures += clock_nanos_to_unit(nanos, unit) != quotient
+                       || batch != quotient
+                       || clock_nanos_to_unit_round(nanos, unit) != rounded
+                       || clock_nanos_to_unit_ceil(nanos, unit) != quotient + (remainder > 0);
+}
+
+/**
+ * \brief Checks the conversions over every small value, every unit boundary
+ * and power of two (and their neighbours), the extremes, and random values.
+ */
+static clock_check_t clock_check_conversion(const hr_clock_time_unit_t unit, const long long random_values)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "conversion/%s", clock_check_unit_names[unit]);
+    clock_check_t check = clock_check_begin(name, "");
+
+    const long long length = hr_clock_unit_nanos[unit];
+    for (long long n = -(1LL << 20); n <= 1LL << 20; n++)
+    {
+        clock_check_value(&check, n, unit);
+    }
+
+    const long long multiples = 0x7FFFFFFFFFFFFFFFLL / length;
+    for (long long k = 0; k <= 65536 && k <= multiples; k++)
+    {
+        const long long low = k * length;
+        const long long high = (multiples - k) * length;
+        for (long long d = -1; d <= 1; d++)
+        {
+            clock_check_value(&check, low + d, unit);
+            clock_check_value(&check, -low - d, unit);
+            if (d >= 0 || high < 0x7FFFFFFFFFFFFFFFLL)
+            {
+                clock_check_value(&check, high - d, unit);
+            }
+            clock_check_value(&check, -high + d, unit);
+        }
+    }
+
+    for (int bit = 0; bit < 63; bit++)
+    {
+        const long long power = 1LL << bit;
+        clock_check_value(&check, power - 1, unit);
+        clock_check_value(&check, power, unit);
+        clock_check_value(&check, power + 1, unit);
+        clock_check_value(&check, -power, unit);
+    }
+
+    clock_check_value(&check, 0x7FFFFFFFFFFFFFFFLL, unit);
+    clock_check_value(&check, -0x7FFFFFFFFFFFFFFFLL - 1, unit);
+
+    unsigned long long state = 0x9E3779B97F4A7C15ULL + (unsigned long long)unit;
+    for (long long i = 0; i < random_values; i++)
+    {
+        const unsigned long long bits = clock_check_xorshift(&state);
+        clock_check_value(&check, (long long)(bits >> (bits & 63)), unit); // Spread over magnitudes
+        clock_check_value(&check, (long long)bits, unit);
+    }
+
+    return check;
+}
+
+static int clock_check_compare_ll(const void *const a, const void *const b)
+{
+    const long long x = *(const long long *)a;
+    const long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * \brief Fills the distribution fields of \p check from \p values (sorted in place).
+ */
+static void clock_check_distribution(clock_check_t *const check, long long *const values, const size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    qsort(values, count, sizeof(long long), clock_check_compare_ll);
+    check->median = (double)values[count / 2];
+    check->p99 = (double)values[count - 1 - count / 100];
+    check->max = (double)values[count - 1];
+}
+
+/**
+ * \brief Distribution of the step between consecutive reads of \p source.
+ *
+ * Steps are the clock's effective resolution plus read cost; a backwards
+ * step is a failure.
+ */
+static clock_check_t clock_check_jitter(const hr_clock_source_t source)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "jitter/%s", clock_check_source_names[source]);
+    clock_check_t check = clock_check_begin(name, "ns");
+
+    long long *const steps = (long long *)malloc(CLOCK_CHECK_JITTER_READS * sizeof(long long));
+    if (steps == NULL)
+    {
+        check.failures = 1;
+        return check;
+    }
+
+    long long previous = get_nano_time_ex(source);
+    for (size_t i = 0; i < CLOCK_CHECK_JITTER_READS; i++)
+    {
+        const long long now = get_nano_time_ex(source);
+        steps[i] = now - previous;
+        check.failures += now < previous;
+        previous = now;
+    }
+
+    check.checked = CLOCK_CHECK_JITTER_READS;
+    clock_check_distribution(&check, steps, CLOCK_CHECK_JITTER_READS);
+    free(steps);
+    return check;
+}
+
+typedef struct
+{
+    hr_clock_source_t source;            ///< Source being hammered
+    volatile unsigned long long *latest; ///< Last value published by any thread
+    unsigned long long failures;         ///< Reads behind this thread's or another thread's earlier read
+    long long worst;                     ///< Largest backwards step in nanoseconds
+} clock_check_monotonic_t;
+
+/**
+ * \brief Keeps the next counter read from starting before the preceding loads complete.
+ *
+ * rdtsc and cntvct_el0 are not ordered with earlier loads, so a plain read
+ * may sample the counter before the value another thread published arrives
+ * and look like a step backwards that never happened.
+ */
+static void clock_check_order_reads()
+{
+#if defined(FLUENT_LIBC_CLOCK_X86)
+    _mm_lfence();
+#elif defined(FLUENT_LIBC_CLOCK_ARM64)
+    __asm__ __volatile__("isb" : : : "memory");
+#endif
+}
+
+static void clock_check_monotonic_worker(void *const arg)
+{
+    clock_check_monotonic_t *const ctx = (clock_check_monotonic_t *)arg;
+    long long previous = 0;
+    for (int i = 0; i < CLOCK_CHECK_MONOTONIC_READS; i++)
+    {
+        // A value another thread published was read before this read began
+        const long long published = (long long)hr_atomic_load_u64(ctx->latest);
+        if (ctx->source == CLOCK_SOURCE_TSC)
+        {
+            clock_check_order_reads();
+        }
+
+        const long long now = get_nano_time_ex(ctx->source);
+        const long long floor = published > previous ? published : previous;
+        if (now < floor)
+        {
+            ctx->failures++;
+            ctx->worst = floor - now > ctx->worst ? floor - now : ctx->worst;
+        }
+
+        hr_atomic_store_u64(ctx->latest, (unsigned long long)now);
+        previous = now;
+    }
+}
+
+/**
+ * \brief Hammers \p source from several threads; no read may be behind a read that happened before it.
+ */
+static clock_check_t clock_check_monotonic(const hr_clock_source_t source)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "monotonic/%s", clock_check_source_names[source]);
+    clock_check_t check = clock_check_begin(name, "ns");
+
+    volatile unsigned long long latest = (unsigned long long)get_nano_time_ex(source);
+    clock_check_monotonic_t workers[CLOCK_CHECK_MONOTONIC_THREADS];
+    hr_thread_t threads[CLOCK_CHECK_MONOTONIC_THREADS];
+    int started[CLOCK_CHECK_MONOTONIC_THREADS];
+    for (int i = 0; i < CLOCK_CHECK_MONOTONIC_THREADS; i++)
+    {
+        workers[i].source = source;
+        workers[i].latest = &latest;
+        workers[i].failures = 0;
+        workers[i].worst = 0;
+        started[i] = hr_thread_create(&threads[i], clock_check_monotonic_worker, &workers[i]);
+    }
+
+    for (int i = 0; i < CLOCK_CHECK_MONOTONIC_THREADS; i++)
+    {
+        if (!started[i])
+        {
+            check.failures++;
+            continue;
+        }
+
+        hr_thread_join(&threads[i]);
+        check.checked += CLOCK_CHECK_MONOTONIC_READS;
+        check.failures += workers[i].failures;
+        check.max = (double)workers[i].worst > check.max ? (double)workers[i].worst : check.max;
+    }
+
+    return check;
+}
+
+/**
+ * \brief Drift of the TSC clock against CLOCK_MONOTONIC over \p seconds, in ppm.
+ *
+ * The median is the end-to-end drift; max is the largest drift seen at any
+ * of the intermediate samples (one every 100 ms) after the first second.
+ */
+static clock_check_t clock_check_drift(const long long seconds)
+{
+    clock_check_t check = clock_check_begin("drift/tsc_vs_monotonic", "ppm");
+#if defined(FLUENT_LIBC_CLOCK_HAS_TSC)
+    if (!hr_clock_tsc_calibrate() || seconds <= 0)
+    {
+        return check; // Nothing to compare; checked stays 0
+    }
+
+    const long long base_tsc = get_nano_time_ex(CLOCK_SOURCE_TSC);
+    const long long base_mono = get_nano_time_ex(CLOCK_SOURCE_MONOTONIC);
+    const long long end = base_mono + seconds * 1000000000LL;
+    double drift = 0.0;
+    for (long long mono = base_mono; mono < end;)
+    {
+        hr_sleep_os_until(mono + 100000000LL);
+        const long long tsc = get_nano_time_ex(CLOCK_SOURCE_TSC);
+        mono = get_nano_time_ex(CLOCK_SOURCE_MONOTONIC);
+
+        const long long elapsed = mono - base_mono;
+        drift = (double)((tsc - base_tsc) - elapsed) * 1e6 / (double)elapsed;
+        check.checked++;
+        if (elapsed >= 1000000000LL && (drift < 0 ? -drift : drift) > check.max)
+        {
+            check.max = drift < 0 ? -drift : drift; // Early samples are dominated by read skew
+        }
+    }
+
+    check.median = drift;
+    check.failures = check.max > CLOCK_CHECK_DRIFT_LIMIT_PPM;
+#else
+    (void)seconds;
+#endif
+    return check;
+}
+
+/**
+ * \brief Counts one assertion of a deterministic check.
+ */
+static void clock_check_expect(clock_check_t *const check, const int condition)
+{
+    check->checked++;
+    check->failures += !condition;
+}
+
+/**
+ * \struct clock_check_timer_t
+ * \brief One timer tracked by the timer wheel checks.
+ */
+typedef struct
+{
+    long long deadline; ///< Deadline it was added with
+    int pending;        ///< Non-zero until it fires or is cancelled
+    hr_timer_id_t id;   ///< Id returned by hr_timer_wheel_add()
+} clock_check_timer_t;
+
+static long long clock_check_timer_now;       // Time the wheel is being advanced to
+static unsigned long long clock_check_timer_early; // Timers fired before their deadline
+
+static void clock_check_timer_fire(void *const arg, const hr_timer_id_t id, const long long deadline)
+{
+    clock_check_timer_t *const timer = (clock_check_timer_t *)arg;
+    (void)id;
+    timer->pending = 0;
+    clock_check_timer_early += deadline > clock_check_timer_now;
+}
+
+/**
+ * \brief A timer added after the wheel advanced past its deadline fires on the next advance to the same time.
+ */
+static clock_check_t clock_check_timer_overdue()
+{
+    clock_check_t check = clock_check_begin("timer_wheel/overdue", "");
+    hr_timer_wheel_t wheel;
+    clock_check_timer_t timer = {3744668769418LL, 1, 0};
+    clock_check_timer_now = 3744668771232LL;
+    clock_check_timer_early = 0;
+    if (!hr_timer_wheel_init(&wheel, 16, 1000, clock_check_timer_now - 10000))
+    {
+        check.failures = 1;
+        return check;
+    }
+
+    hr_timer_wheel_advance(&wheel, clock_check_timer_now);
+    timer.id = hr_timer_wheel_add(&wheel, timer.deadline, 0, clock_check_timer_fire, &timer);
+    clock_check_expect(&check, timer.id != 0);
+    clock_check_expect(&check, hr_timer_wheel_next_expiry(&wheel) <= clock_check_timer_now);
+    clock_check_expect(&check, hr_timer_wheel_advance(&wheel, clock_check_timer_now) == 1);
+    clock_check_expect(&check, timer.pending == 0 && hr_timer_wheel_active(&wheel) == 0);
+    clock_check_expect(&check, clock_check_timer_early == 0);
+
+    // Cancelling an overdue timer before it fires
+    timer.pending = 1;
+    timer.id = hr_timer_wheel_add(&wheel, timer.deadline, 0, clock_check_timer_fire, &timer);
+    clock_check_expect(&check, hr_timer_wheel_cancel(&wheel, timer.id));
+    clock_check_expect(&check, hr_timer_wheel_advance(&wheel, clock_check_timer_now) == 0);
+    clock_check_expect(&check, hr_timer_wheel_next_expiry(&wheel) == -1);
+    hr_timer_wheel_destroy(&wheel);
+    return check;
+}
+
+/**
+ * \brief Random adds (some overdue), cancels and advances; no timer may fire
+ * before its deadline or stay pending a full tick after it.
+ */
+static clock_check_t clock_check_timer_fuzz()
+{
+    enum { capacity = 256, tick = 1000 };
+    clock_check_t check = clock_check_begin("timer_wheel/fuzz", "");
+    clock_check_timer_t timers[capacity];
+    hr_timer_wheel_t wheel;
+    clock_check_timer_now = 3744668760000LL;
+    clock_check_timer_early = 0;
+    if (!hr_timer_wheel_init(&wheel, capacity, tick, clock_check_timer_now))
+    {
+        check.failures = 1;
+        return check;
+    }
+
+    memset(timers, 0, sizeof(timers));
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    for (int step = 0; step < 200000; step++)
+    {
+        const unsigned long long bits = clock_check_xorshift(&state);
+        clock_check_timer_t *const timer = &timers[bits % capacity];
+        switch ((bits >> 8) % 4)
+        {
+        case 0:
+        case 1:
+            if (!timer->pending)
+            {
+                // Up to 10 ticks overdue, most within a few levels, some bound to cascade
+                const long long ahead = (bits >> 16) % 8 == 0 ? (long long)((bits >> 20) % 1000000000ULL) : (long long)((bits >> 20) % 3000000ULL);
+                timer->deadline = clock_check_timer_now - 10 * tick + ahead;
+                timer->pending = 1;
+                timer->id = hr_timer_wheel_add(&wheel, timer->deadline, 0, clock_check_timer_fire, timer);
+                clock_check_expect(&check, timer->id != 0);
+            }
+            break;
+        case 2:
+            if (timer->pending)
+            {
+                clock_check_expect(&check, hr_timer_wheel_cancel(&wheel, timer->id));
+                timer->pending = 0;
+            }
+            break;
+        default:
+            clock_check_timer_now += (bits >> 16) % 64 == 0 ? (long long)((bits >> 24) % 100000000ULL) : (long long)((bits >> 24) % 5000ULL);
+            hr_timer_wheel_advance(&wheel, clock_check_timer_now);
+            for (int i = 0; i < capacity; i++)
+            {
+                clock_check_expect(&check, !timers[i].pending || timers[i].deadline + tick > clock_check_timer_now);
+            }
+            break;
+        }
+    }
+
+    clock_check_expect(&check, clock_check_timer_early == 0);
+    hr_timer_wheel_destroy(&wheel);
+    return check;
+}
+
+/**
+ * \brief Writes \p count stamps to \p path in blocks of 64 and opens them for reading.
+ *
+ * \return Non-zero if the file was written and opened.
+ */
+static int clock_check_stamps_file(
+    const char *const path,
+    const long long *const stamps,
+    const size_t count,
+    hr_stamp_reader_t *const reader
+)
+{
+    hr_stamp_writer_t writer;
+    if (!hr_stamp_writer_open(&writer, path, CLOCK_SOURCE_MONOTONIC, 64))
+    {
+        return 0;
+    }
+
+    const int appended = hr_stamp_writer_append_batch(&writer, stamps, count);
+    return hr_stamp_writer_close(&writer) && appended && hr_stamp_reader_open(reader, path);
+}
+
+/**
+ * \brief After hr_stamp_reader_seek(), the first stamp at or after \p from must be the first one in the file.
+ */
+static void clock_check_stamps_seek(
+    clock_check_t *const check,
+    hr_stamp_reader_t *const reader,
+    const long long *const stamps,
+    const size_t count,
+    const long long from
+)
+{
+    size_t expected = 0;
+    while (expected < count && stamps[expected] < from)
+    {
+        expected++;
+    }
+
+    long long stamp = 0;
+    int found = hr_stamp_reader_seek(reader, from);
+    while (found && (found = hr_stamp_reader_next(reader, &stamp)) && stamp < from)
+    {
+        // Skip the stamps of the first block that precede from
+    }
+
+    clock_check_expect(check, expected == count ? !found : found && stamp == stamps[expected]);
+}
+
+/**
+ * \brief hr_stamp_range() must count the stamps of [\p from, \p to] like a linear scan.
+ */
+static void clock_check_stamps_range(
+    clock_check_t *const check,
+    hr_stamp_reader_t *const reader,
+    const long long *const stamps,
+    const size_t count,
+    const long long from,
+    const long long to
+)
+{
+    unsigned long long expected = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        expected += stamps[i] >= from && stamps[i] <= to;
+    }
+
+    clock_check_expect(check, hr_stamp_reader_range(reader, from, to, NULL, 0) == expected);
+}
+
+/**
+ * \brief Writes and re-reads stamp files: exact round trip, seeks and ranges
+ * against a linear scan, in time order and with the blocks reversed.
+ */
+static clock_check_t clock_check_stamps()
+{
+    enum { count = 5000 };
+    static const char *const path = "clock_checks.hrstamp";
+    clock_check_t check = clock_check_begin("stamps/roundtrip", "");
+    static long long stamps[count];
+    unsigned long long state = 0x2545F4914F6CDD1DULL;
+    long long stamp = 3744668760000LL;
+    for (size_t i = 0; i < count; i++)
+    {
+        // Mostly short steps, a few small steps back and a few long jumps
+        const unsigned long long bits = clock_check_xorshift(&state);
+        stamp += bits % 16 == 0 ? -(long long)(bits >> 60) : bits % 97 == 0 ? (long long)(bits >> 24) : (long long)((bits >> 8) % 5000);
+        stamps[i] = stamp;
+    }
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            // Reverse the blocks, so the seek has to scan instead of bisecting
+            for (size_t block = 0; block < count / 64 / 2; block++)
+            {
+                for (size_t i = 0; i < 64; i++)
+                {
+                    const long long swap = stamps[block * 64 + i];
+                    stamps[block * 64 + i] = stamps[(count / 64 - 1 - block) * 64 + i];
+                    stamps[(count / 64 - 1 - block) * 64 + i] = swap;
+                }
+            }
+        }
+
+        hr_stamp_reader_t reader;
+        if (!clock_check_stamps_file(path, stamps, count, &reader))
+        {
+            check.failures++;
+            break;
+        }
+
+        size_t read = 0;
+        int matches = 1;
+        while (hr_stamp_reader_next(&reader, &stamp))
+        {
+            matches &= read < count && stamp == stamps[read];
+            read++;
+        }
+
+        clock_check_expect(&check, matches && read == count && reader.count == count);
+        clock_check_expect(&check, reader.ordered == (pass == 0));
+        clock_check_stamps_seek(&check, &reader, stamps, count, stamps[0] - 1);
+        clock_check_stamps_seek(&check, &reader, stamps, count, 0x7FFFFFFFFFFFFFFFLL);
+        for (int i = 0; i < 200; i++)
+        {
+            const long long from = stamps[clock_check_xorshift(&state) % count] + (long long)(clock_check_xorshift(&state) % 3) - 1;
+            const long long to = from + (long long)(clock_check_xorshift(&state) % 2000000ULL);
+            clock_check_stamps_seek(&check, &reader, stamps, count, from);
+            clock_check_stamps_range(&check, &reader, stamps, count, from, to);
+        }
+
+        hr_stamp_reader_close(&reader);
+    }
+
+    remove(path);
+    return check;
+}
+
+/**
+ * \brief Token bucket and GCRA limits on a simulated timeline: bursts,
+ * whole-token refills, carried-over remainders and retry hints.
+ */
+static clock_check_t clock_check_rate_limit()
+{
+    clock_check_t check = clock_check_begin("rate_limit/token_bucket_gcra", "");
+    const long long start = 3744668760000LL;
+
+    // 1000/s: one token per millisecond, bursts of 10
+    hr_token_bucket_t bucket;
+    clock_check_expect(&check, hr_token_bucket_init(&bucket, 1000, 10, CLOCK_SOURCE_MONOTONIC));
+    hr_atomic_store_u64(&bucket.last, (unsigned long long)start);
+    clock_check_expect(&check, hr_token_bucket_try_acquire_n_at(&bucket, 10, start));
+    clock_check_expect(&check, !hr_token_bucket_try_acquire_n_at(&bucket, 1, start));
+    clock_check_expect(&check, !hr_token_bucket_try_acquire_n_at(&bucket, 1, start + 999999));
+    clock_check_expect(&check, hr_token_bucket_try_acquire_n_at(&bucket, 1, start + 1000000));
+    clock_check_expect(&check, !hr_token_bucket_try_acquire_n_at(&bucket, 1, start + 1000000));
+    clock_check_expect(&check, hr_token_bucket_try_acquire_n_at(&bucket, 1, start + 2500000));
+    clock_check_expect(&check, hr_token_bucket_try_acquire_n_at(&bucket, 1, start + 3000000)); // Half a token carried over
+    clock_check_expect(&check, !hr_token_bucket_try_acquire_n_at(&bucket, 1, start + 2000000)); // Earlier reading
+    clock_check_expect(&check, hr_token_bucket_take(&bucket, 100, 0, start + 1000000000000LL) == 10); // Capped at the burst
+    clock_check_expect(&check, !hr_token_bucket_try_acquire_n_at(&bucket, 11, start + 2000000000000LL));
+    clock_check_expect(&check, hr_token_bucket_try_acquire_n_at(&bucket, 0, start));
+    clock_check_expect(&check, !hr_token_bucket_init(&bucket, 0, 10, CLOCK_SOURCE_MONOTONIC));
+
+    hr_gcra_t gcra;
+    long long retry = 0;
+    clock_check_expect(&check, hr_gcra_init(&gcra, 1000, 10, CLOCK_SOURCE_MONOTONIC));
+    for (int i = 0; i < 10; i++)
+    {
+        clock_check_expect(&check, hr_gcra_try_acquire_n_at(&gcra, 1, start, &retry));
+    }
+    clock_check_expect(&check, !hr_gcra_try_acquire_n_at(&gcra, 1, start, &retry) && retry == 1000000);
+    clock_check_expect(&check, !hr_gcra_try_acquire_n_at(&gcra, 1, start + 999999, &retry) && retry == 1);
+    clock_check_expect(&check, hr_gcra_try_acquire_n_at(&gcra, 1, start + 1000000, &retry));
+    clock_check_expect(&check, !hr_gcra_try_acquire_n_at(&gcra, 11, start + 1000000000LL, &retry) && retry == -1);
+    clock_check_expect(&check, hr_gcra_try_acquire_n_at(&gcra, 10, start + 1000000000LL, &retry));
+    return check;
+}
+
+/**
+ * \brief Window series on a simulated timeline: per-window aggregates, slot
+ * recycling, dropped late samples and the snapshot's window selection.
+ */
+static clock_check_t clock_check_window()
+{
+    clock_check_t check = clock_check_begin("window/rotation", "");
+    hr_window_series_t series;
+    hr_window_t windows[4];
+    hr_histogram_t hist;
+    if (!hr_window_series_init(&series, 4, 1000, CLOCK_NANOSECONDS, 1))
+    {
+        check.failures = 1;
+        return check;
+    }
+
+    clock_check_expect(&check, hr_window_series_record_at(&series, 10, 500));
+    clock_check_expect(&check, hr_window_series_record_at(&series, -5, 999));
+    clock_check_expect(&check, hr_window_series_record_at(&series, 7, 1500));
+    clock_check_expect(&check, hr_window_series_snapshot(&series, 1999, windows, 4) == 2);
+    clock_check_expect(&check, windows[0].start == 0 && windows[0].count == 2 && windows[0].sum == 5);
+    clock_check_expect(&check, windows[0].min == -5 && windows[0].max == 10 && windows[0].complete);
+    clock_check_expect(&check, windows[1].start == 1000 && windows[1].count == 1 && !windows[1].complete);
+
+    // Window 4 recycles window 0's slot; a late sample for window 0 is dropped
+    clock_check_expect(&check, hr_window_series_record_at(&series, 3, 4500));
+    clock_check_expect(&check, !hr_window_series_record_at(&series, 1, 600));
+    clock_check_expect(&check, hr_window_series_dropped(&series) == 1);
+    clock_check_expect(&check, hr_window_series_snapshot(&series, 4999, windows, 4) == 2);
+    clock_check_expect(&check, windows[0].start == 1000 && windows[0].sum == 7 && windows[0].complete);
+    clock_check_expect(&check, windows[1].start == 4000 && windows[1].sum == 3 && windows[1].min == 3 && !windows[1].complete);
+    clock_check_expect(&check, hr_window_series_snapshot(&series, 4999, windows, 1) == 1 && windows[0].start == 1000);
+    clock_check_expect(&check, hr_window_series_histogram(&series, 4000, &hist) && hr_histogram_count(&hist) == 1);
+    clock_check_expect(&check, !hr_window_series_histogram(&series, 0, &hist));
+
+    // Far past every retained window: only the current one is reported
+    clock_check_expect(&check, hr_window_series_record_at(&series, 1, 1000000));
+    clock_check_expect(&check, hr_window_series_snapshot(&series, 1000000, windows, 4) == 1 && windows[0].start == 1000000);
+    clock_check_expect(&check, !hr_window_series_record_at(&series, 1, -1));
+    hr_window_series_destroy(&series);
+    return check;
+}
+
+/**
+ * \brief Checks an accumulator against moments computed exactly from the samples.
+ */
+static void clock_check_stats_moments(
+    clock_check_t *const check,
+    const hr_duration_stats_t *const stats,
+    const long long *const samples,
+    const size_t n
+)
+{
+    long double sum = 0.0L;
+    long long min = samples[0], max = samples[0];
+    for (size_t i = 0; i < n; i++)
+    {
+        sum += (long double)samples[i];
+        min = samples[i] < min ? samples[i] : min;
+        max = samples[i] > max ? samples[i] : max;
+    }
+
+    const long double mean = sum / (long double)n;
+    long double squares = 0.0L;
+    for (size_t i = 0; i < n; i++)
+    {
+        squares += ((long double)samples[i] - mean) * ((long double)samples[i] - mean);
+    }
+
+    const double variance = (double)(squares / (long double)(n - 1));
+    const double mean_error = hr_duration_stats_mean(stats, CLOCK_NANOSECONDS) - (double)mean;
+    const double variance_error = hr_duration_stats_variance(stats, CLOCK_NANOSECONDS) - variance;
+    clock_check_expect(check, hr_duration_stats_count(stats) == n);
+    clock_check_expect(check, (mean_error < 0 ? -mean_error : mean_error) <= 1e-15 * (double)(mean < 0 ? -mean : mean) + 1e-3);
+    clock_check_expect(check, (variance_error < 0 ? -variance_error : variance_error) <= 1e-9 * variance + 1e-6);
+    clock_check_expect(check, hr_duration_stats_min(stats, CLOCK_NANOSECONDS) == min);
+    clock_check_expect(check, hr_duration_stats_max(stats, CLOCK_NANOSECONDS) == max);
+}
+
+/**
+ * \brief Welford updates, the batch path and merges against exact moments,
+ * on samples with a large offset that breaks the naive sum-of-squares formula.
+ */
+static clock_check_t clock_check_stats()
+{
+    enum { count = 3000 };
+    clock_check_t check = clock_check_begin("stats/welford_merge", "");
+    static long long samples[count];
+    unsigned long long state = 0xD1B54A32D192ED03ULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        samples[i] = 1000000000000LL + (long long)(clock_check_xorshift(&state) % 100000ULL);
+    }
+
+    hr_duration_stats_t single, batch, merged, part;
+    hr_duration_stats_init(&single, 1, CLOCK_SECONDS);
+    hr_duration_stats_init(&batch, 1, CLOCK_SECONDS);
+    hr_duration_stats_init(&merged, 1, CLOCK_SECONDS);
+    for (size_t i = 0; i < count; i++)
+    {
+        hr_duration_stats_add_at(&single, samples[i], 1000);
+    }
+    hr_duration_stats_add_batch(&batch, samples, count, 1000);
+    clock_check_stats_moments(&check, &single, samples, count);
+    clock_check_stats_moments(&check, &batch, samples, count);
+
+    // Uneven parts, including an empty one, merged in order
+    static const size_t cuts[] = {0, 1, 1, 1000, 2999, 3000};
+    for (size_t c = 1; c < sizeof(cuts) / sizeof(cuts[0]); c++)
+    {
+        hr_duration_stats_init(&part, 1, CLOCK_SECONDS);
+        hr_duration_stats_add_batch(&part, samples + cuts[c - 1], cuts[c] - cuts[c - 1], 1000);
+        hr_duration_stats_merge(&merged, &part);
+    }
+    clock_check_stats_moments(&check, &merged, samples, count);
+
+    // EWMA: a sample one half-life old weighs half as much as a new one
+    hr_duration_stats_t ewma;
+    hr_duration_stats_init(&ewma, 1, CLOCK_SECONDS);
+    clock_check_expect(&check, hr_duration_stats_ewma(&ewma, CLOCK_NANOSECONDS) == 0.0);
+    hr_duration_stats_add_at(&ewma, 300, 0);
+    hr_duration_stats_add_at(&ewma, 600, 1000000000LL);
+    const double expected = (300.0 * 0.5 + 600.0) / 1.5;
+    const double error = hr_duration_stats_ewma(&ewma, CLOCK_NANOSECONDS) - expected;
+    clock_check_expect(&check, (error < 0 ? -error : error) < 1e-9);
+    clock_check_expect(&check, hr_duration_stats_variance(&ewma, CLOCK_NANOSECONDS) == 45000.0);
+    return check;
+}
+
+/**
+ * \brief Saturating arithmetic and unit conversions at the edges of the 64-bit range.
+ */
+static clock_check_t clock_check_duration()
+{
+    clock_check_t check = clock_check_begin("duration/saturation", "");
+    const long long max = HR_DURATION_NANOS_MAX, min = HR_DURATION_NANOS_MIN;
+    long long product = 0;
+    hr_duration_t duration = {0};
+    hr_uduration_t unsigned_duration = {0};
+
+    clock_check_expect(&check, hr_sat_add_i64(max, 1) == max && hr_sat_add_i64(min, -1) == min);
+    clock_check_expect(&check, hr_sat_add_i64(max, min) == -1 && hr_sat_add_i64(1, 2) == 3);
+    clock_check_expect(&check, hr_sat_sub_i64(min, 1) == min && hr_sat_sub_i64(max, -1) == max);
+    clock_check_expect(&check, hr_sat_sub_i64(0, min) == max && hr_sat_sub_i64(-1, min) == max && hr_sat_sub_i64(5, 3) == 2);
+    clock_check_expect(&check, hr_mul_overflow_i64(max, 2, &product) && product == max);
+    clock_check_expect(&check, hr_mul_overflow_i64(min, -1, &product) && product == max);
+    clock_check_expect(&check, hr_mul_overflow_i64(max, -2, &product) && product == min);
+    clock_check_expect(&check, !hr_mul_overflow_i64(min, 1, &product) && product == min);
+    clock_check_expect(&check, !hr_mul_overflow_i64(max / 2 + 1, -2, &product) && product == min);
+    clock_check_expect(&check, !hr_mul_overflow_i64(-3, 4, &product) && product == -12);
+    clock_check_expect(&check, hr_sat_add_u64(~0ULL, 1) == ~0ULL && hr_sat_sub_u64(1, 2) == 0);
+
+    clock_check_expect(&check, hr_duration_from_unit(106751, CLOCK_DAYS, &duration) == HR_CLOCK_OK);
+    clock_check_expect(&check, hr_duration_from_unit(106752, CLOCK_DAYS, &duration) == HR_CLOCK_ERROR_RANGE && duration.nanos == max);
+    clock_check_expect(&check, hr_duration_from_unit(-106752, CLOCK_DAYS, &duration) == HR_CLOCK_ERROR_RANGE && duration.nanos == min);
+    clock_check_expect(&check, hr_duration_from_unit(1, (hr_clock_time_unit_t)(CLOCK_DAYS + 1), &duration) == HR_CLOCK_ERROR_UNIT);
+    clock_check_expect(&check, hr_duration_from_unit(1, CLOCK_SECONDS, NULL) == HR_CLOCK_ERROR_NULL);
+    clock_check_expect(&check, hr_duration_to_unit(hr_duration_from_nanos(min), CLOCK_DAYS, &product) == HR_CLOCK_OK && product == -106751);
+    clock_check_expect(&check, hr_duration_abs(hr_duration_from_nanos(min)).nanos == 1ULL << 63);
+    clock_check_expect(&check, hr_duration_to_unsigned(hr_duration_from_nanos(-1), &unsigned_duration) == HR_CLOCK_ERROR_RANGE && unsigned_duration.nanos == 0);
+    clock_check_expect(&check, hr_duration_mul(hr_duration_from_nanos(max / 3), 4).nanos == max);
+
+    hr_instant_t instant = {max - 1};
+    clock_check_expect(&check, hr_instant_add(instant, hr_duration_from_nanos(5)).nanos == max);
+    instant.nanos = min + 1;
+    clock_check_expect(&check, hr_instant_sub(instant, hr_duration_from_nanos(5)).nanos == min);
+    const hr_instant_t later = {max}, earlier = {min};
+    clock_check_expect(&check, hr_instant_diff(later, earlier).nanos == max && hr_instant_diff(earlier, later).nanos == min);
+    return check;
+}
+
+/**
+ * \brief Offset and drift fit on simulated exchanges with a known remote clock.
+ *
+ * The remote clock runs 80 ppm fast with a fixed offset; every fifth exchange
+ * is delayed on one leg only, which skews its offset and must be filtered out.
+ */
+static clock_check_t clock_check_sync()
+{
+    clock_check_t check = clock_check_begin("sync/fit", "ns");
+    const double drift = 80e-6;
+    const long long offset = -123456789LL;
+    const long long base = 1000000000000LL;
+    hr_clock_sync_t sync;
+    hr_clock_sync_model_t model;
+    hr_clock_sync_init(&sync);
+    clock_check_expect(&check, !hr_clock_sync_model(&sync, &model));
+    clock_check_expect(&check, !hr_clock_sync_add(&sync, 10, 0, 0, 5) && sync.failures == 1);
+
+    for (int i = 0; i < 64; i++)
+    {
+        const long long t1 = base + (long long)i * 100000000LL;
+        const long long queued = i % 5 == 4 ? 2000000 : 0;
+        const long long receive = t1 + 20000 + queued;
+        const long long send = receive + 5000;
+        const long long t4 = send + 20000;
+        const long long t2 = receive + offset + (long long)((double)(receive - base) * drift);
+        const long long t3 = send + offset + (long long)((double)(send - base) * drift);
+        clock_check_expect(&check, hr_clock_sync_add(&sync, t1, t2, t3, t4));
+    }
+
+    clock_check_expect(&check, hr_clock_sync_model(&sync, &model) && model.valid);
+    clock_check_expect(&check, model.uncertainty_ns == 20000);
+    const double drift_error = sync.drift - drift;
+    clock_check_expect(&check, (drift_error < 0 ? -drift_error : drift_error) < 1e-7);
+    for (long long local = base; local <= base + 8000000000LL; local += 500000000LL)
+    {
+        const long long remote = local + offset + (long long)((double)(local - base) * drift);
+        const long long error = hr_clock_sync_to_remote(&model, local) - remote;
+        const long long back = hr_clock_sync_to_local(&model, remote) - local;
+        const double magnitude = (double)(error < 0 ? -error : error);
+        check.max = magnitude > check.max ? magnitude : check.max;
+        clock_check_expect(&check, magnitude < 1000.0 && (back < 0 ? -back : back) <= 4);
+    }
+
+    return check;
+}
+
+/**
+ * \brief Deadline expiry, saturation, child deadlines and the amortized poll.
+ */
+static clock_check_t clock_check_deadline()
+{
+    clock_check_t check = clock_check_begin("deadline/expiry", "");
+    hr_deadline_t deadline = hr_deadline_at(1000);
+    clock_check_expect(&check, !hr_deadline_expired_at(&deadline, 999));
+    clock_check_expect(&check, hr_deadline_expired_at(&deadline, 1000));
+    clock_check_expect(&check, hr_deadline_expired_at(&deadline, 0)); // Sticky once observed
+
+    hr_deadline_t never = hr_deadline_in(0x7FFFFFFFFFFFFFFFLL, CLOCK_DAYS);
+    clock_check_expect(&check, never.at == HR_DEADLINE_NEVER && !hr_deadline_expired(&never));
+    hr_deadline_set_poll(&never, HR_DEADLINE_CLOCK_PRECISE, 0);
+    int polled = 0;
+    for (int i = 0; i < 100000; i++)
+    {
+        polled |= hr_deadline_poll(&never);
+    }
+    clock_check_expect(&check, !polled && never.countdown <= FLUENT_LIBC_CLOCK_DEADLINE_MAX_STRIDE);
+
+    const hr_deadline_t invalid = hr_deadline_in(1, (hr_clock_time_unit_t)(CLOCK_DAYS + 1));
+    clock_check_expect(&check, invalid.expired);
+    clock_check_expect(&check, hr_deadline_remaining(&deadline, CLOCK_NANOSECONDS) == 0);
+    clock_check_expect(&check, hr_deadline_remaining(&deadline, (hr_clock_time_unit_t)(CLOCK_DAYS + 1)) == -1);
+
+    // Children never outlive the parent, and inherit its expiry
+    hr_deadline_t parent = hr_deadline_in(10, CLOCK_SECONDS);
+    const hr_deadline_t half = hr_deadline_child(&parent, 0.5);
+    const hr_deadline_t longer = hr_deadline_child_in(&parent, 1, CLOCK_HOURS);
+    const hr_deadline_t shorter = hr_deadline_child_in(&parent, 1, CLOCK_MILLISECONDS);
+    clock_check_expect(&check, !half.expired && half.at < parent.at && half.at > parent.at - 6000000000LL);
+    clock_check_expect(&check, longer.at == parent.at && shorter.at < parent.at);
+    clock_check_expect(&check, hr_deadline_child(&parent, 2.0).at == parent.at);
+    clock_check_expect(&check, hr_deadline_child(&never, 0.5).at == HR_DEADLINE_NEVER);
+    clock_check_expect(&check, hr_deadline_child(&deadline, 0.5).expired && hr_deadline_child_in(&deadline, 1, CLOCK_SECONDS).expired);
+    clock_check_expect(&check, hr_deadline_child(NULL, 0.5).expired && hr_deadline_poll(NULL));
+
+    // A deadline in the past is seen on the first poll
+    hr_deadline_t past = hr_deadline_at(get_nano_time() - 1);
+    hr_deadline_set_poll(&past, HR_DEADLINE_CLOCK_PRECISE, 0);
+    clock_check_expect(&check, hr_deadline_poll(&past) && hr_deadline_poll(&past));
+
+    // The stride at most doubles per read and stays within bounds
+    hr_deadline_t future = hr_deadline_in(1, CLOCK_HOURS);
+    hr_deadline_set_poll(&future, HR_DEADLINE_CLOCK_PRECISE, 0);
+    unsigned int stride = future.stride;
+    int bounded = 1;
+    for (int i = 0; i < 1000000; i++)
+    {
+        bounded &= !hr_deadline_poll(&future);
+        bounded &= future.stride <= 2 * stride && future.stride <= FLUENT_LIBC_CLOCK_DEADLINE_MAX_STRIDE;
+        stride = future.stride;
+    }
+    clock_check_expect(&check, bounded);
+    return check;
+}
+
+static void clock_write_checks(FILE *const out, const char *const format, const clock_check_t *const checks, const size_t count)
+{
+    if (strcmp(format, "json") == 0)
+    {
+        fputs("[", out);
+        for (size_t i = 0; i < count; i++)
+        {
+            const clock_check_t *const c = &checks[i];
+            fputs(i == 0 ? "\n  {\"name\":" : ",\n  {\"name\":", out);
+            hr_bench_write_json_string(out, c->name);
+            fprintf(
+                out,
+                ",\"checked\":%llu,\"failures\":%llu,"
+                "\"median\":%.4f,\"p99\":%.4f,\"max\":%.4f,\"unit\":\"%s\",\"passed\":%s}",
+                c->checked,
+                c->failures,
+                c->median,
+                c->p99,
+                c->max,
+                c->unit,
+                c->failures == 0 ? "true" : "false"
+            );
+        }
+        fputs("\n]\n", out);
+    }
+    else if (strcmp(format, "csv") == 0)
+    {
+        fputs("name,checked,failures,median,p99,max,unit,passed\n", out);
+        for (size_t i = 0; i < count; i++)
+        {
+            const clock_check_t *const c = &checks[i];
+            hr_bench_write_csv_string(out, c->name);
+            fprintf(
+                out,
+                ",%llu,%llu,%.4f,%.4f,%.4f,%s,%d\n",
+                c->checked,
+                c->failures,
+                c->median,
+                c->p99,
+                c->max,
+                c->unit,
+                c->failures == 0
+            );
+        }
+    }
+    else
+    {
+        fprintf(out, "%-36s %12s %10s %10s %10s %10s %-4s %s\n", "check", "checked", "failures", "median", "p99", "max", "unit", "result");
+        for (size_t i = 0; i < count; i++)
+        {
+            const clock_check_t *const c = &checks[i];
+            fprintf(
+                out,
+                "%-36s %12llu %10llu %10.3f %10.3f %10.3f %-4s %s\n",
+                c->name,
+                c->checked,
+                c->failures,
+                c->median,
+                c->p99,
+                c->max,
+                c->unit,
+                c->failures == 0 ? "ok" : "FAIL"
+            );
+        }
+    }
+}
+
+/**
+ * \brief Runs every check whose name contains \p filter and writes them in \p format.
+ *
+ * \return The process exit status: 0 if every check passed, 1 if any failed or none matched.
+ */
+static int clock_run_checks(const char *const format, const char *const filter, const long long drift_s, const long long random_values)
+{
+    static const hr_clock_source_t monotonic_sources[] = {
+        CLOCK_SOURCE_MONOTONIC, CLOCK_SOURCE_TSC, CLOCK_SOURCE_TSCP,
+        CLOCK_SOURCE_MONOTONIC_COARSE, CLOCK_SOURCE_MONOTONIC_RAW, CLOCK_SOURCE_BOOTTIME
+    };
+
+    clock_check_t checks[48];
+    size_t count = 0;
+    char name[64];
+    for (int u = CLOCK_NANOSECONDS; u <= CLOCK_DAYS; u++)
+    {
+        snprintf(name, sizeof(name), "conversion/%s", clock_check_unit_names[u]);
+        if (filter == NULL || strstr(name, filter) != NULL)
+        {
+            checks[count++] = clock_check_conversion((hr_clock_time_unit_t)u, random_values);
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(monotonic_sources) / sizeof(monotonic_sources[0]); i++)
+    {
+        snprintf(name, sizeof(name), "monotonic/%s", clock_check_source_names[monotonic_sources[i]]);
+        if (filter == NULL || strstr(name, filter) != NULL)
+        {
+            checks[count++] = clock_check_monotonic(monotonic_sources[i]);
+        }
+    }
+
+    for (int s = 0; s < FLUENT_LIBC_CLOCK_SOURCE_COUNT; s++)
+    {
+        snprintf(name, sizeof(name), "jitter/%s", clock_check_source_names[s]);
+        if (filter == NULL || strstr(name, filter) != NULL)
+        {
+            checks[count++] = clock_check_jitter((hr_clock_source_t)s);
+        }
+    }
+
+    if (filter == NULL || strstr("drift/tsc_vs_monotonic", filter) != NULL)
+    {
+        checks[count++] = clock_check_drift(drift_s);
+    }
+
+    if (filter == NULL || strstr("timer_wheel/overdue", filter) != NULL)
+    {
+        checks[count++] = clock_check_timer_overdue();
+    }
+
+    if (filter == NULL || strstr("timer_wheel/fuzz", filter) != NULL)
+    {
+        checks[count++] = clock_check_timer_fuzz();
+    }
+
+    static const struct
+    {
+        const char *name;
+        clock_check_t (*run)();
+    } deterministic[] = {
+        {"stamps/roundtrip", clock_check_stamps},
+        {"rate_limit/token_bucket_gcra", clock_check_rate_limit},
+        {"window/rotation", clock_check_window},
+        {"stats/welford_merge", clock_check_stats},
+        {"duration/saturation", clock_check_duration},
+        {"sync/fit", clock_check_sync},
+        {"deadline/expiry", clock_check_deadline},
+    };
+
+    for (size_t i = 0; i < sizeof(deterministic) / sizeof(deterministic[0]); i++)
+    {
+        if (filter == NULL || strstr(deterministic[i].name, filter) != NULL)
+        {
+            checks[count++] = deterministic[i].run();
+        }
+    }
+
+    if (count == 0)
+    {
+        fprintf(stderr, "No check matches \"%s\"\n", filter);
+        return 1; // A mistyped filter must not pass silently
+    }
+
+    clock_write_checks(stdout, format, checks, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (checks[i].failures != 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+#endif //FLUENT_LIBC_CLOCK_CHECKS_H
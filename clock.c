@@ -9,3 +9,131 @@
 */
 
 #include "clock.h"
+#include "clock_bench.h"
+#include "clock_cached.h"
+#include "clock_deadline.h"
+#include "clock_duration.h"
+#include "clock_histogram.h"
+#include "clock_perf.h"
+#include "clock_profile.h"
+#include "clock_rate_limit.h"
+#include "clock_skew.h"
+#include "clock_sleep.h"
+#include "clock_stamps.h"
+#include "clock_stats.h"
+#include "clock_stopwatch.h"
+#include "clock_sync.h"
+#include "clock_thread.h"
+#include "clock_timer_loop.h"
+#include "clock_timer_wheel.h"
+#include "clock_trace.h"
+#include "clock_wallclock.h"
+#include "clock_window.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ============= SHARED LIBRARY DISPATCH =============
+// hr_clock_dispatch_now() jumps through hr_clock_dispatch_fn, which starts at
+// the resolver and is replaced by the chosen reader on first use. The
+// pointer is written whole, so a racing reader sees either value; resolving
+// twice is harmless.
+
+typedef long long (*hr_clock_dispatch_fn_t)();
+
+static long long hr_clock_dispatch_resolve();
+
+static long long hr_clock_dispatch_monotonic() { return get_nano_time_ex(CLOCK_SOURCE_MONOTONIC); }
+static long long hr_clock_dispatch_tsc() { return get_nano_time_ex(CLOCK_SOURCE_TSC); }
+static long long hr_clock_dispatch_tscp() { return get_nano_time_ex(CLOCK_SOURCE_TSCP); }
+static long long hr_clock_dispatch_coarse() { return get_nano_time_ex(CLOCK_SOURCE_MONOTONIC_COARSE); }
+static long long hr_clock_dispatch_raw() { return get_nano_time_ex(CLOCK_SOURCE_MONOTONIC_RAW); }
+static long long hr_clock_dispatch_boottime() { return get_nano_time_ex(CLOCK_SOURCE_BOOTTIME); }
+static long long hr_clock_dispatch_thread() { return get_nano_time_ex(CLOCK_SOURCE_THREAD_CPUTIME); }
+static long long hr_clock_dispatch_process() { return get_nano_time_ex(CLOCK_SOURCE_PROCESS_CPUTIME); }
+
+/**
+ * \brief Reader for every \p hr_clock_source_t, indexed by source.
+ */
+static const hr_clock_dispatch_fn_t hr_clock_dispatch_readers[FLUENT_LIBC_CLOCK_SOURCE_COUNT] = {
+    hr_clock_dispatch_monotonic,
+    hr_clock_dispatch_tsc,
+    hr_clock_dispatch_tscp,
+    hr_clock_dispatch_coarse,
+    hr_clock_dispatch_raw,
+    hr_clock_dispatch_boottime,
+    hr_clock_dispatch_thread,
+    hr_clock_dispatch_process,
+};
+
+static volatile hr_clock_dispatch_fn_t hr_clock_dispatch_fn = hr_clock_dispatch_resolve;
+static volatile int hr_clock_dispatch_selected = -1; ///< Source in hr_clock_dispatch_fn, -1 until resolved
+
+/**
+ * \brief Maps a FLUENT_CLOCK_BACKEND name to the source it reads.
+ */
+static hr_clock_source_t hr_clock_dispatch_parse(const char *const name)
+{
+    if (name == NULL)
+    {
+        return CLOCK_SOURCE_MONOTONIC; // Handle null pointer
+    }
+
+    if (strcmp(name, "tsc") == 0)
+    {
+        return CLOCK_SOURCE_TSC;
+    }
+
+    if (strcmp(name, "coarse") == 0)
+    {
+        return CLOCK_SOURCE_MONOTONIC_COARSE;
+    }
+
+    return CLOCK_SOURCE_MONOTONIC; // vdso, qpc, or unknown
+}
+
+static long long hr_clock_dispatch_resolve()
+{
+    hr_clock_dispatch_select(hr_clock_dispatch_parse(getenv("FLUENT_CLOCK_BACKEND")));
+    return hr_clock_dispatch_fn();
+}
+
+FLUENT_LIBC_CLOCK_API hr_clock_source_t hr_clock_dispatch_select(const hr_clock_source_t source)
+{
+    hr_clock_source_t effective = source;
+    if ((int)source < 0 || (int)source >= FLUENT_LIBC_CLOCK_SOURCE_COUNT)
+    {
+        effective = CLOCK_SOURCE_MONOTONIC; // Invalid source
+    }
+    else if (source == CLOCK_SOURCE_TSC || source == CLOCK_SOURCE_TSCP)
+    {
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+        if (!hr_clock_tsc_calibrate())
+        {
+            effective = CLOCK_SOURCE_MONOTONIC; // Fall back to the OS clock
+        }
+#else
+        effective = CLOCK_SOURCE_MONOTONIC;
+#endif
+    }
+
+    hr_clock_init();
+    hr_clock_dispatch_fn = hr_clock_dispatch_readers[effective];
+    hr_atomic_store_int(&hr_clock_dispatch_selected, (int)effective);
+    return effective;
+}
+
+FLUENT_LIBC_CLOCK_API long long hr_clock_dispatch_now()
+{
+    return hr_clock_dispatch_fn();
+}
+
+FLUENT_LIBC_CLOCK_API hr_clock_source_t hr_clock_dispatch_source()
+{
+    if (hr_atomic_load_int(&hr_clock_dispatch_selected) < 0)
+    {
+        (void)hr_clock_dispatch_fn(); // Resolves on first use
+    }
+
+    return (hr_clock_source_t)hr_atomic_load_int(&hr_clock_dispatch_selected);
+}
@@ -17,13 +17,28 @@
 // Cross-platform (Windows + POSIX) nanosecond precision timing.
 //
 // Features:
+// - `hr_clock_init()`: Optional one-time setup (cached frequencies)
+// - `hr_clock_set_source()`: Opt into the calibrated TSC / cntvct_el0 fast path
 // - `get_nano_time()`: Fetch current monotonic time in ns
+// - `get_nano_time_ex()`: Read a specific source (coarse, raw, boottime, CPU time)
 // - `time_since()`: Get elapsed ns from timestamp
 // - `hr_clock_t`: Struct to hold start time
 // - `hr_clock_tick()`: Start/reset a clock
+// - `hr_clock_source_of()`: Source a clock is read from (active source if unset)
 // - `clock_nanos_to_unit()`: Convert nanoseconds to various time units
+// - `clock_nanos_to_unit_batch()`: SIMD conversion of whole arrays
+// - `clock_nanos_to_unit_f64()` / `_round()` / `_ceil()`: Fractional and rounded conversions
+// - `clock_nanos_split()`: Break a duration into d/h/min/s/ms/µs/ns
 // - `hr_clock_distance()`: Time diff between two clocks (converted)
 // - `hr_clock_distance_from_now()`: Elapsed time from clock to now
+// - `_unchecked()` variants: No NULL / unit checks for hot loops
+// - `hr_tick_clock_t`: Clock storing raw ticks, converted only on `hr_tick_clock_distance()`
+// - `hr_clock_stamp_batch()`: Stamp a burst of events (shared / interpolated / serialized)
+// - `hr_clock_stamp_batch_since()`: Spread a burst's stamps over the window it arrived in
+// - `hr_clock_calibrate()`: Measure read overhead / resolution of the active source
+// - `hr_clock_distance_corrected()`: Distance minus the measured read overhead
+// - `FLUENT_LIBC_CLOCK_BACKEND`: Compile-time source selection (no runtime dispatch)
+// - `hr_clock_dispatch_now()`: Exported runtime-dispatched read (clock_shared)
 //
 // Time Units Supported:
 // - ns, µs, ms, s, min, h, days (via `hr_clock_time_unit_t`)
@@ -51,151 +66,2279 @@ extern "C"
 #   include <time.h>
 #endif
 
+#include <stddef.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   include <intrin.h>
+#   define FLUENT_LIBC_CLOCK_MSVC 1
+#endif
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#   include <arm_neon.h>
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_GLOBAL
+ * \brief Storage specifier for process-wide clock state defined in this header.
+ *
+ * The library is header-only, but some state (cached frequencies, calibration
+ * results) must be shared by every translation unit that includes it. Weak /
+ * selectany definitions let the linker fold all copies into a single object.
+ */
+#ifndef FLUENT_LIBC_CLOCK_GLOBAL
+#   if defined(FLUENT_LIBC_CLOCK_MSVC)
+#       define FLUENT_LIBC_CLOCK_GLOBAL __declspec(selectany)
+#   else
+#       define FLUENT_LIBC_CLOCK_GLOBAL __attribute__((weak))
+#   endif
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_ZERO_INIT
+ * \brief Zero initializer for the process-wide state structs.
+ *
+ * selectany data must be initialized; `{}` keeps C++ consumers free of
+ * -Wmissing-field-initializers, while C needs `{0}`.
+ */
+#if defined(__cplusplus)
+#   define FLUENT_LIBC_CLOCK_ZERO_INIT {}
+#else
+#   define FLUENT_LIBC_CLOCK_ZERO_INIT {0}
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_THREAD_LOCAL
+ * \brief Storage specifier for per-thread variables.
+ */
+#ifndef FLUENT_LIBC_CLOCK_THREAD_LOCAL
+#   if defined(FLUENT_LIBC_CLOCK_MSVC)
+#       define FLUENT_LIBC_CLOCK_THREAD_LOCAL __declspec(thread)
+#   elif defined(__cplusplus)
+#       define FLUENT_LIBC_CLOCK_THREAD_LOCAL thread_local
+#   elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#       define FLUENT_LIBC_CLOCK_THREAD_LOCAL _Thread_local
+#   else
+#       define FLUENT_LIBC_CLOCK_THREAD_LOCAL __thread
+#   endif
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL
+ * \brief Storage specifier for per-thread variables shared by all translation units.
+ *
+ * MSVC cannot combine selectany with thread storage, so there every
+ * translation unit keeps its own copy; all users of this specifier must
+ * tolerate that (e.g. a per-thread cache that is lazily re-created).
+ */
+#ifndef FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL
+#   if defined(FLUENT_LIBC_CLOCK_MSVC)
+#       define FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL static FLUENT_LIBC_CLOCK_THREAD_LOCAL
+#   else
+#       define FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL FLUENT_LIBC_CLOCK_GLOBAL FLUENT_LIBC_CLOCK_THREAD_LOCAL
+#   endif
+#endif
+
+// ============= ATOMICS =============
+// Minimal atomic helpers usable from both C and C++ translation units
+// (stdatomic.h is not available to C++ before C++23).
+
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+/**
+ * \brief Orders the plain volatile accesses of the MSVC helpers.
+ *
+ * x86 / x64 keep loads and stores in order (TSO), so a compiler barrier is
+ * enough there; ARM needs a hardware barrier, since MSVC's volatile does not
+ * imply acquire / release on it (/volatile:iso is the default).
+ */
+static inline void hr_atomic_msvc_barrier()
+{
+#   if defined(_M_ARM64) || defined(_M_ARM64EC)
+    __dmb(_ARM64_BARRIER_ISH);
+#   elif defined(_M_ARM)
+    __dmb(_ARM_BARRIER_ISH);
+#   else
+    _ReadWriteBarrier();
+#   endif
+}
+#endif
+
+/**
+ * \brief Atomically loads an int with acquire semantics.
+ */
+static inline int hr_atomic_load_int(const volatile int *const ptr)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    const int value = *ptr;
+    hr_atomic_msvc_barrier();
+    return value;
+#else
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * \brief Atomically stores an int with release semantics.
+ */
+static inline void hr_atomic_store_int(volatile int *const ptr, const int value)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    hr_atomic_msvc_barrier();
+    *ptr = value;
+#else
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * \brief Atomically replaces \p expected with \p desired if \p ptr holds \p expected.
+ *
+ * \return Non-zero if the exchange took place.
+ */
+static inline int hr_atomic_cas_int(volatile int *const ptr, int expected, const int desired)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    return _InterlockedCompareExchange((volatile long *)ptr, desired, expected) == expected;
+#else
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * \brief Atomically loads a 64-bit counter without ordering guarantees.
+ */
+static inline unsigned long long hr_atomic_load_u64_relaxed(const volatile unsigned long long *const ptr)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+#   if defined(_M_X64) || defined(_M_ARM64)
+    return *ptr;
+#   else
+    return (unsigned long long)_InterlockedCompareExchange64((volatile long long *)ptr, 0, 0);
+#   endif
+#else
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * \brief Atomically adds \p value to a 64-bit counter without ordering guarantees.
+ *
+ * \return The value held before the addition.
+ */
+static inline unsigned long long hr_atomic_fetch_add_u64_relaxed(
+    volatile unsigned long long *const ptr,
+    const unsigned long long value
+)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    return (unsigned long long)_InterlockedExchangeAdd64((volatile long long *)ptr, (long long)value);
+#else
+    return __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * \brief Atomically stores a 64-bit counter without ordering guarantees.
+ */
+static inline void hr_atomic_store_u64_relaxed(volatile unsigned long long *const ptr, const unsigned long long value)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+#   if defined(_M_X64) || defined(_M_ARM64)
+    *ptr = value;
+#   else
+    _InterlockedExchange64((volatile long long *)ptr, (long long)value);
+#   endif
+#else
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * \brief Atomically loads a 64-bit value with acquire semantics.
+ */
+static inline unsigned long long hr_atomic_load_u64(const volatile unsigned long long *const ptr)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    const unsigned long long value = hr_atomic_load_u64_relaxed(ptr);
+    hr_atomic_msvc_barrier();
+    return value;
+#else
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * \brief Atomically stores a 64-bit value with release semantics.
+ */
+static inline void hr_atomic_store_u64(volatile unsigned long long *const ptr, const unsigned long long value)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    hr_atomic_msvc_barrier();
+    hr_atomic_store_u64_relaxed(ptr, value);
+#else
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * \brief Atomically replaces \p expected with \p desired if the 64-bit value at \p ptr holds \p expected.
+ *
+ * \return Non-zero if the exchange took place.
+ */
+static inline int hr_atomic_cas_u64(
+    volatile unsigned long long *const ptr,
+    unsigned long long expected,
+    const unsigned long long desired
+)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    return (unsigned long long)_InterlockedCompareExchange64((volatile long long *)ptr, (long long)desired, (long long)expected)
+        == expected;
+#else
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * \brief Atomically loads a pointer with acquire semantics.
+ */
+static inline void *hr_atomic_load_ptr(void *const volatile *const ptr)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    void *const value = *ptr;
+    hr_atomic_msvc_barrier();
+    return value;
+#else
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * \brief Atomically replaces \p expected with \p desired if \p ptr holds \p expected.
+ *
+ * \return Non-zero if the exchange took place.
+ */
+static inline int hr_atomic_cas_ptr(void *volatile *const ptr, void *expected, void *const desired)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    return _InterlockedCompareExchangePointer(ptr, desired, expected) == expected;
+#else
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * \brief Release fence: earlier loads and stores are ordered before later stores.
+ */
+static inline void hr_atomic_fence_release()
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    hr_atomic_msvc_barrier();
+#else
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * \brief Acquire fence: earlier loads are ordered before later loads and stores.
+ */
+static inline void hr_atomic_fence_acquire()
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    hr_atomic_msvc_barrier();
+#else
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+}
+
+// ============= FIXED-POINT SCALING =============
+
+/**
+ * \struct hr_clock_scale_t
+ * \brief Fixed-point factor converting counter ticks to nanoseconds.
+ *
+ * A tick count \c t is converted with \c (t * mult) >> shift, computed on a
+ * 128-bit intermediate so the result is exact for any realistic uptime.
+ */
+typedef struct
+{
+    unsigned long long mult; ///< Nanoseconds per tick, scaled by 2^shift
+    unsigned int shift;      ///< Binary point position of \p mult
+} hr_clock_scale_t;
+
+/**
+ * \brief Computes the full 128-bit product of two 64-bit values.
+ *
+ * \param a The first factor.
+ * \param b The second factor.
+ * \param low Receives the low 64 bits of the product.
+ * \return The high 64 bits of the product.
+ */
+static inline unsigned long long hr_clock_mul_wide(
+    const unsigned long long a,
+    const unsigned long long b,
+    unsigned long long *const low
+)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = (unsigned __int128)a * b;
+    *low = (unsigned long long)product;
+    return (unsigned long long)(product >> 64);
+#elif defined(FLUENT_LIBC_CLOCK_MSVC) && defined(_M_X64)
+    unsigned long long high;
+    *low = _umul128(a, b, &high);
+    return high;
+#else
+    // Portable 64x64 -> 128 multiplication on 32-bit halves
+    const unsigned long long a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+    const unsigned long long b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+    const unsigned long long lo_lo = a_lo * b_lo;
+    const unsigned long long hi_lo = a_hi * b_lo;
+    const unsigned long long lo_hi = a_lo * b_hi;
+    const unsigned long long cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    *low = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+/**
+ * \brief Computes \c (value * mult) >> shift without losing the high bits.
+ *
+ * \param value The tick count to scale.
+ * \param mult The fixed-point multiplier.
+ * \param shift The number of fractional bits in \p mult (0-63).
+ * \return The scaled value, truncated to 64 bits.
+ */
+static inline unsigned long long hr_clock_mul_shift(
+    const unsigned long long value,
+    const unsigned long long mult,
+    const unsigned int shift
+)
+{
+#if defined(__SIZEOF_INT128__)
+    return (unsigned long long)(((unsigned __int128)value * mult) >> shift);
+#elif defined(FLUENT_LIBC_CLOCK_MSVC) && defined(_M_X64)
+    unsigned long long high;
+    const unsigned long long low = _umul128(value, mult, &high);
+    return shift == 0 ? low : __shiftright128(low, high, (unsigned char)shift);
+#else
+    unsigned long long low;
+    const unsigned long long high = hr_clock_mul_wide(value, mult, &low);
+    return shift == 0 ? low : (low >> shift) | (high << (64 - shift));
+#endif
+}
+
+/**
+ * \brief Builds the tick-to-nanosecond scale for a counter running at \p frequency Hz.
+ *
+ * The multiplier \c 1e9 * 2^shift / frequency is computed by exact long
+ * division, using the largest shift that keeps it below 2^63. This is only
+ * meant to run once, at initialization.
+ *
+ * \param frequency The counter frequency in ticks per second (must be non-zero).
+ * \return The fixed-point scale for that frequency.
+ */
+static inline hr_clock_scale_t hr_clock_scale_from_frequency(const unsigned long long frequency)
+{
+    hr_clock_scale_t scale = {0, 0};
+    if (frequency == 0)
+    {
+        return scale; // Handle invalid frequency
+    }
+
+    unsigned long long quotient = 1000000000ULL / frequency;
+    unsigned long long remainder = 1000000000ULL % frequency;
+    while (scale.shift < 63 && (quotient >> 62) == 0)
+    {
+        // One step of binary long division; remainder < frequency, so no overflow
+        // as long as the frequency stays below 2^63
+        remainder <<= 1;
+        quotient <<= 1;
+        if (remainder >= frequency)
+        {
+            remainder -= frequency;
+            quotient |= 1;
+        }
+        scale.shift++;
+    }
+
+    scale.mult = quotient;
+    return scale;
+}
+
+// ============= CLOCK SOURCES =============
+
+/**
+ * \def FLUENT_LIBC_CLOCK_HAS_TSC
+ * \brief Defined when the CPU exposes a user-readable cycle counter.
+ *
+ * That is the time stamp counter on x86/x86-64 and the virtual counter
+ * (cntvct_el0) on AArch64.
+ */
+#if !(defined(_WIN32) && defined(FLUENT_LIBC_NO_WINDOWS_SDK))
+#   if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#       define FLUENT_LIBC_CLOCK_HAS_TSC 1
+#       define FLUENT_LIBC_CLOCK_X86 1
+#       if !defined(FLUENT_LIBC_CLOCK_MSVC)
+#           include <x86intrin.h>
+#           include <cpuid.h>
+#       endif
+#   elif defined(__aarch64__) && !defined(FLUENT_LIBC_CLOCK_MSVC)
+#       define FLUENT_LIBC_CLOCK_HAS_TSC 1
+#       define FLUENT_LIBC_CLOCK_ARM64 1
+#   endif
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_TSC_CALIBRATION_NS
+ * \brief How long the TSC is measured against the monotonic clock at calibration.
+ */
+#ifndef FLUENT_LIBC_CLOCK_TSC_CALIBRATION_NS
+#   define FLUENT_LIBC_CLOCK_TSC_CALIBRATION_NS 10000000LL // 10 ms
+#endif
+
+/**
+ * \enum hr_clock_source_t
+ * \brief Enumeration of the time sources get_nano_time() can read from.
+ */
+typedef enum
+{
+    CLOCK_SOURCE_MONOTONIC = 0,    ///< CLOCK_MONOTONIC (POSIX) or QueryPerformanceCounter (Windows)
+    CLOCK_SOURCE_TSC,              ///< Invariant TSC via rdtsc (x86) or cntvct_el0 (AArch64)
+    CLOCK_SOURCE_TSCP,             ///< Like CLOCK_SOURCE_TSC, but ordered after preceding instructions (rdtscp / isb)
+    CLOCK_SOURCE_MONOTONIC_COARSE, ///< CLOCK_MONOTONIC_COARSE (tick resolution) or GetTickCount64 (Windows)
+    CLOCK_SOURCE_MONOTONIC_RAW,    ///< CLOCK_MONOTONIC_RAW, not subject to NTP slewing
+    CLOCK_SOURCE_BOOTTIME,         ///< CLOCK_BOOTTIME, includes time spent suspended
+    CLOCK_SOURCE_THREAD_CPUTIME,   ///< CPU time consumed by the calling thread
+    CLOCK_SOURCE_PROCESS_CPUTIME,  ///< CPU time consumed by the whole process
+} hr_clock_source_t;
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SOURCE_COUNT
+ * \brief Number of \p hr_clock_source_t values, for tables indexed by source.
+ */
+#define FLUENT_LIBC_CLOCK_SOURCE_COUNT ((int)CLOCK_SOURCE_PROCESS_CPUTIME + 1)
+
+/**
+ * \def FLUENT_LIBC_CLOCK_BACKEND
+ * \brief Fixes the source behind get_nano_time() at compile time.
+ *
+ * Define it to one of the FLUENT_LIBC_CLOCK_BACKEND_* values (the CMake
+ * option FLUENT_CLOCK_BACKEND does so) and get_nano_time(), hr_clock_tick()
+ * and friends read that source directly, with no runtime dispatch;
+ * hr_clock_set_source() then only reports it. Left undefined, the source is
+ * chosen at runtime with hr_clock_set_source().
+ */
+#define FLUENT_LIBC_CLOCK_BACKEND_TSC 1    ///< Calibrated cycle counter (falls back to the OS clock if unusable)
+#define FLUENT_LIBC_CLOCK_BACKEND_VDSO 2   ///< POSIX CLOCK_MONOTONIC (vDSO on Linux)
+#define FLUENT_LIBC_CLOCK_BACKEND_QPC 3    ///< Windows QueryPerformanceCounter
+#define FLUENT_LIBC_CLOCK_BACKEND_COARSE 4 ///< CLOCK_MONOTONIC_COARSE / GetTickCount64
+
+#if defined(FLUENT_LIBC_CLOCK_BACKEND)
+#   if FLUENT_LIBC_CLOCK_BACKEND == FLUENT_LIBC_CLOCK_BACKEND_TSC
+#       ifndef FLUENT_LIBC_CLOCK_HAS_TSC
+#           error "FLUENT_LIBC_CLOCK_BACKEND_TSC needs an x86 or AArch64 cycle counter"
+#       endif
+#       define FLUENT_LIBC_CLOCK_FIXED_SOURCE CLOCK_SOURCE_TSC
+#       define FLUENT_LIBC_CLOCK_FIXED_TSC 1
+#   elif FLUENT_LIBC_CLOCK_BACKEND == FLUENT_LIBC_CLOCK_BACKEND_VDSO
+#       ifdef _WIN32
+#           error "FLUENT_LIBC_CLOCK_BACKEND_VDSO is POSIX-only; use FLUENT_LIBC_CLOCK_BACKEND_QPC"
+#       endif
+#       define FLUENT_LIBC_CLOCK_FIXED_SOURCE CLOCK_SOURCE_MONOTONIC
+#   elif FLUENT_LIBC_CLOCK_BACKEND == FLUENT_LIBC_CLOCK_BACKEND_QPC
+#       ifndef _WIN32
+#           error "FLUENT_LIBC_CLOCK_BACKEND_QPC is Windows-only; use FLUENT_LIBC_CLOCK_BACKEND_VDSO"
+#       endif
+#       define FLUENT_LIBC_CLOCK_FIXED_SOURCE CLOCK_SOURCE_MONOTONIC
+#   elif FLUENT_LIBC_CLOCK_BACKEND == FLUENT_LIBC_CLOCK_BACKEND_COARSE
+#       define FLUENT_LIBC_CLOCK_FIXED_SOURCE CLOCK_SOURCE_MONOTONIC_COARSE
+#   else
+#       error "Unknown FLUENT_LIBC_CLOCK_BACKEND"
+#   endif
+#endif
+
+// ============= INITIALIZATION =============
+
+/**
+ * \struct hr_clock_state_t
+ * \brief Process-wide state shared by all translation units.
+ */
+typedef struct
+{
+    volatile int init_state;          ///< 0 = uninitialized, 1 = initializing, 2 = ready
+    volatile int source;              ///< Active hr_clock_source_t used by get_nano_time()
+    hr_clock_scale_t qpc_scale;       ///< QueryPerformanceCounter tick scale (Windows only)
+    volatile int tsc_state;           ///< Calibration state, same values as \p init_state
+    volatile int tsc_usable;          ///< Non-zero if the cycle counter is invariant and calibrated
+    volatile int tsc_sync;            ///< Cross-CPU check: 0 unchecked, 1 consistent, -1 skewed
+    unsigned long long tsc_frequency; ///< Calibrated cycle counter frequency in Hz
+    hr_clock_scale_t tsc_scale;       ///< Cycle counter tick scale
+    unsigned long long tsc_base;      ///< Counter value at calibration
+    long long tsc_base_ns;            ///< Monotonic time at \p tsc_base, in nanoseconds
+} hr_clock_state_t;
+
+FLUENT_LIBC_CLOCK_GLOBAL hr_clock_state_t hr_clock_state = FLUENT_LIBC_CLOCK_ZERO_INIT;
+
+/**
+ * \brief Claims a one-time initialization guarded by \p state.
+ *
+ * \param state Pointer to a flag (0 = uninitialized, 1 = initializing, 2 = ready).
+ * \return Non-zero if the caller must run the initialization and then call
+ *         hr_clock_once_end(); zero once the initialization has completed,
+ *         possibly after waiting for another thread.
+ */
+static inline int hr_clock_once_begin(volatile int *const state)
+{
+    if (hr_atomic_load_int(state) == 2)
+    {
+        return 0; // Already initialized
+    }
+
+    if (hr_atomic_cas_int(state, 0, 1))
+    {
+        return 1;
+    }
+
+    // Another thread is initializing, wait for it
+    while (hr_atomic_load_int(state) != 2)
+    {
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Publishes a one-time initialization claimed with hr_clock_once_begin().
+ */
+static inline void hr_clock_once_end(volatile int *const state)
+{
+    hr_atomic_store_int(state, 2);
+}
+
+/**
+ * \brief Initializes the clock library.
+ *
+ * This function caches the platform timer frequency and precomputes the
+ * fixed-point conversion constants used by get_nano_time(). Calling it is
+ * optional, since the first clock read initializes lazily, but doing so at
+ * startup moves that cost out of the first measured interval.
+ *
+ * It is safe to call from multiple threads; the setup runs exactly once and
+ * concurrent callers wait until it has completed.
+ */
+static inline void hr_clock_init()
+{
+    if (!hr_clock_once_begin(&hr_clock_state.init_state))
+    {
+        return;
+    }
+
+#if defined(_WIN32) && !defined(FLUENT_LIBC_NO_WINDOWS_SDK)
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    hr_clock_state.qpc_scale = hr_clock_scale_from_frequency((unsigned long long)frequency.QuadPart);
+#endif
+
+    hr_clock_once_end(&hr_clock_state.init_state);
+}
+
+/**
+ * \brief Reads the operating system's monotonic clock in nanoseconds.
+ *
+ * This is the CLOCK_SOURCE_MONOTONIC backend of get_nano_time().
+ * On Windows, it reads QueryPerformanceCounter and converts the ticks to nanoseconds
+ * with the fixed-point scale cached by hr_clock_init(). On POSIX systems, it uses clock_gettime with
+ * CLOCK_MONOTONIC for nanosecond precision.
+ *
+ * \return The current monotonic time in nanoseconds as a 64-bit integer.
+ */
+static inline long long hr_clock_monotonic_nanos()
+{
+#ifdef _WIN32
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    // If FLUENT_LIBC_NO_WINDOWS_SDK is defined, we assume
+    // the Windows SDK is not available, therefore some libraries
+    // may not be implemented.
+    return 0LL; // Return 0
+#   else
+    hr_clock_init(); // One acquire load once initialized
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    // Convert to nanoseconds: (counter * mult) >> shift
+    return (long long)hr_clock_mul_shift(
+        (unsigned long long)counter.QuadPart,
+        hr_clock_state.qpc_scale.mult,
+        hr_clock_state.qpc_scale.shift
+    );
+#   endif // FLUENT_LIBC_NO_WINDOWS_SDK
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+/**
+ * \brief Reads the raw cycle counter (rdtsc / cntvct_el0).
+ *
+ * The read is not ordered with respect to surrounding instructions, which
+ * makes it the cheapest option but lets the CPU hoist it slightly.
+ */
+static inline unsigned long long hr_clock_tsc_read()
+{
+#if defined(FLUENT_LIBC_CLOCK_X86)
+    return (unsigned long long)__rdtsc();
+#else
+    unsigned long long value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#endif
+}
+
+/**
+ * \brief Reads the cycle counter after all preceding instructions have executed.
+ *
+ * Uses rdtscp on x86 and an isb barrier before cntvct_el0 on AArch64.
+ */
+static inline unsigned long long hr_clock_tscp_read()
+{
+#if defined(FLUENT_LIBC_CLOCK_X86)
+    unsigned int aux;
+    return (unsigned long long)__rdtscp(&aux);
+#else
+    unsigned long long value;
+    __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(value) : : "memory");
+    return value;
+#endif
+}
+
+/**
+ * \brief Checks whether the cycle counter ticks at a constant rate.
+ *
+ * On x86, this is the invariant TSC flag (CPUID leaf 0x80000007, EDX bit 8).
+ * The AArch64 generic timer runs at a fixed frequency by architecture.
+ *
+ * \return Non-zero if the counter is suitable as a time source.
+ */
+static inline int hr_clock_tsc_is_invariant()
+{
+#if defined(FLUENT_LIBC_CLOCK_X86)
+    unsigned int regs[4] = {0, 0, 0, 0};
+#   if defined(FLUENT_LIBC_CLOCK_MSVC)
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if ((unsigned int)info[0] < 0x80000007u)
+    {
+        return 0; // Extended leaf not supported
+    }
+
+    __cpuid(info, 0x80000007);
+    regs[3] = (unsigned int)info[3];
+#   else
+    if (__get_cpuid_max(0x80000000u, NULL) < 0x80000007u)
+    {
+        return 0; // Extended leaf not supported
+    }
+
+    __get_cpuid(0x80000007u, &regs[0], &regs[1], &regs[2], &regs[3]);
+#   endif
+    return (regs[3] >> 8) & 1u;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * \brief Takes a (counter, monotonic ns) pair with the tightest bracket out of a few tries.
+ */
+static inline void hr_clock_tsc_sample(unsigned long long *const ticks, long long *const nanos)
+{
+    unsigned long long best_window = ~0ULL;
+    for (int i = 0; i < 8; i++)
+    {
+        const unsigned long long before = hr_clock_tscp_read();
+        const long long now = hr_clock_monotonic_nanos();
+        const unsigned long long after = hr_clock_tscp_read();
+
+        if (after - before < best_window)
+        {
+            best_window = after - before;
+            *ticks = before + (after - before) / 2;
+            *nanos = now;
+        }
+    }
+}
+
+/**
+ * \brief Calibrates the cycle counter against the monotonic clock, once.
+ *
+ * On x86, the TSC frequency is measured over FLUENT_LIBC_CLOCK_TSC_CALIBRATION_NS;
+ * on AArch64, it is read from cntfrq_el0. In both cases the counter is anchored
+ * to the monotonic clock, so both sources report values on the same timeline.
+ *
+ * The counter is rejected if hr_clock_tsc_report_sync() has recorded that it
+ * is not consistent across CPUs.
+ *
+ * \return Non-zero if the counter can be used as a time source.
+ */
+static inline int hr_clock_tsc_calibrate()
+{
+    if (!hr_clock_once_begin(&hr_clock_state.tsc_state))
+    {
+        return hr_clock_state.tsc_usable;
+    }
+
+    hr_clock_init();
+    hr_clock_state.tsc_usable = 0;
+    if (hr_clock_tsc_is_invariant())
+    {
+        unsigned long long start_ticks = 0, end_ticks = 0;
+        long long start_nanos = 0, end_nanos = 0;
+        hr_clock_tsc_sample(&start_ticks, &start_nanos);
+
+#if defined(FLUENT_LIBC_CLOCK_X86)
+        while (hr_clock_monotonic_nanos() - start_nanos < FLUENT_LIBC_CLOCK_TSC_CALIBRATION_NS)
+        {
+        }
+
+        hr_clock_tsc_sample(&end_ticks, &end_nanos);
+        const double frequency = (double)(end_ticks - start_ticks) * 1e9 / (double)(end_nanos - start_nanos);
+        hr_clock_state.tsc_frequency = (unsigned long long)(frequency + 0.5);
+#else
+        unsigned long long frequency;
+        __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+        hr_clock_state.tsc_frequency = frequency;
+        end_ticks = start_ticks;
+        end_nanos = start_nanos;
+#endif
+
+        // A failed cross-CPU check (see hr_clock_verify_sync()) rules the counter out
+        if (hr_clock_state.tsc_frequency != 0 && hr_atomic_load_int(&hr_clock_state.tsc_sync) >= 0)
+        {
+            hr_clock_state.tsc_scale = hr_clock_scale_from_frequency(hr_clock_state.tsc_frequency);
+            hr_clock_state.tsc_base = end_ticks;
+            hr_clock_state.tsc_base_ns = end_nanos;
+            hr_clock_state.tsc_usable = 1;
+        }
+    }
+
+    hr_clock_once_end(&hr_clock_state.tsc_state);
+    return hr_clock_state.tsc_usable;
+}
+
+/**
+ * \brief Records the outcome of a cross-CPU consistency check of the cycle counter.
+ *
+ * A failed check disables the counter: hr_clock_tsc_calibrate() reports it as
+ * unusable from then on, so the TSC sources fall back to the OS clock, and a
+ * process-wide TSC selection is reverted to CLOCK_SOURCE_MONOTONIC.
+ *
+ * \param consistent Non-zero if stamps taken on different CPUs are comparable.
+ */
+static inline void hr_clock_tsc_report_sync(const int consistent)
+{
+    hr_atomic_store_int(&hr_clock_state.tsc_sync, consistent ? 1 : -1);
+    if (consistent)
+    {
+        return;
+    }
+
+    hr_atomic_store_int(&hr_clock_state.tsc_usable, 0);
+    const int source = hr_atomic_load_int(&hr_clock_state.source);
+    if (source == (int)CLOCK_SOURCE_TSC || source == (int)CLOCK_SOURCE_TSCP)
+    {
+        hr_atomic_cas_int(&hr_clock_state.source, source, (int)CLOCK_SOURCE_MONOTONIC);
+    }
+}
+
+/**
+ * \brief Converts a cycle counter value to nanoseconds on the monotonic timeline.
+ *
+ * \param ticks A value read with hr_clock_tsc_read() or hr_clock_tscp_read().
+ * \return The corresponding monotonic time in nanoseconds.
+ */
+static inline long long hr_clock_tsc_to_nanos(const unsigned long long ticks)
+{
+    const hr_clock_scale_t scale = hr_clock_state.tsc_scale;
+    const unsigned long long delta = ticks - hr_clock_state.tsc_base;
+    if ((long long)delta < 0)
+    {
+        // Read slightly before the calibration point (e.g. on another core)
+        return hr_clock_state.tsc_base_ns - (long long)hr_clock_mul_shift(0 - delta, scale.mult, scale.shift);
+    }
+
+    return hr_clock_state.tsc_base_ns + (long long)hr_clock_mul_shift(delta, scale.mult, scale.shift);
+}
+#endif // FLUENT_LIBC_CLOCK_HAS_TSC
+
+#ifndef _WIN32
+/**
+ * \brief Maps a clock source to the clock_gettime() clock it reads.
+ *
+ * Clocks that the platform does not provide fall back to CLOCK_MONOTONIC.
+ */
+static inline clockid_t hr_clock_posix_clock_id(const hr_clock_source_t source)
+{
+    switch (source)
+    {
+#ifdef CLOCK_MONOTONIC_COARSE
+        case CLOCK_SOURCE_MONOTONIC_COARSE:
+            return CLOCK_MONOTONIC_COARSE;
+#endif
+#ifdef CLOCK_MONOTONIC_RAW
+        case CLOCK_SOURCE_MONOTONIC_RAW:
+            return CLOCK_MONOTONIC_RAW;
+#endif
+#ifdef CLOCK_BOOTTIME
+        case CLOCK_SOURCE_BOOTTIME:
+            return CLOCK_BOOTTIME;
+#endif
+#ifdef CLOCK_THREAD_CPUTIME_ID
+        case CLOCK_SOURCE_THREAD_CPUTIME:
+            return CLOCK_THREAD_CPUTIME_ID;
+#endif
+#ifdef CLOCK_PROCESS_CPUTIME_ID
+        case CLOCK_SOURCE_PROCESS_CPUTIME:
+            return CLOCK_PROCESS_CPUTIME_ID;
+#endif
+        default:
+            return CLOCK_MONOTONIC;
+    }
+}
+#elif !defined(FLUENT_LIBC_NO_WINDOWS_SDK)
+/**
+ * \brief Converts a thread/process cycle count to nanoseconds.
+ *
+ * QueryThreadCycleTime and QueryProcessCycleTime count TSC ticks, so this
+ * requires the cycle counter calibration. When it is unavailable the caller
+ * falls back to the (coarser) GetThreadTimes / GetProcessTimes.
+ *
+ * \return Non-zero if \p nanos was written.
+ */
+static inline int hr_clock_cycles_to_nanos(const unsigned long long cycles, long long *const nanos)
+{
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    if (hr_clock_tsc_calibrate())
+    {
+        *nanos = (long long)hr_clock_mul_shift(cycles, hr_clock_state.tsc_scale.mult, hr_clock_state.tsc_scale.shift);
+        return 1;
+    }
+#else
+    (void)cycles;
+    (void)nanos;
+#endif
+    return 0;
+}
+
+/**
+ * \brief Adds two FILETIME values (100 ns units) and converts the sum to nanoseconds.
+ */
+static inline long long hr_clock_filetime_nanos(const FILETIME *const kernel, const FILETIME *const user)
+{
+    const unsigned long long k = ((unsigned long long)kernel->dwHighDateTime << 32) | kernel->dwLowDateTime;
+    const unsigned long long u = ((unsigned long long)user->dwHighDateTime << 32) | user->dwLowDateTime;
+    return (long long)((k + u) * 100ULL);
+}
+#endif
+
+/**
+ * \brief Returns the current time of the given source in nanoseconds.
+ *
+ * All monotonic sources (CLOCK_SOURCE_MONOTONIC, _COARSE, _RAW, BOOTTIME and the
+ * cycle counter ones) count from an unspecified point in the past; only
+ * differences between two readings of the same source are meaningful.
+ * The CPU time sources count CPU time consumed by the calling thread or process.
+ *
+ * On Windows, CLOCK_SOURCE_MONOTONIC_COARSE maps to GetTickCount64, the CPU
+ * time sources to QueryThreadCycleTime / QueryProcessCycleTime, and the
+ * remaining monotonic sources to QueryPerformanceCounter.
+ *
+ * \param source The time source to read.
+ * \return The current time of \p source in nanoseconds as a 64-bit integer.
+ */
+static inline long long get_nano_time_ex(const hr_clock_source_t source)
+{
+    switch (source)
+    {
+        case CLOCK_SOURCE_MONOTONIC:
+            return hr_clock_monotonic_nanos();
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+        case CLOCK_SOURCE_TSC:
+            if (hr_clock_tsc_calibrate())
+            {
+                return hr_clock_tsc_to_nanos(hr_clock_tsc_read());
+            }
+            return hr_clock_monotonic_nanos(); // Counter not usable
+        case CLOCK_SOURCE_TSCP:
+            if (hr_clock_tsc_calibrate())
+            {
+                return hr_clock_tsc_to_nanos(hr_clock_tscp_read());
+            }
+            return hr_clock_monotonic_nanos(); // Counter not usable
+#endif
+        default:
+            break;
+    }
+
+#ifdef _WIN32
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0LL; // Return 0
+#   else
+    long long nanos;
+    FILETIME creation, exit, kernel, user;
+    ULONG64 cycles;
+    switch (source)
+    {
+        case CLOCK_SOURCE_MONOTONIC_COARSE:
+            return (long long)GetTickCount64() * 1000000LL;
+        case CLOCK_SOURCE_THREAD_CPUTIME:
+            if (QueryThreadCycleTime(GetCurrentThread(), &cycles) && hr_clock_cycles_to_nanos(cycles, &nanos))
+            {
+                return nanos;
+            }
+            GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+            return hr_clock_filetime_nanos(&kernel, &user);
+        case CLOCK_SOURCE_PROCESS_CPUTIME:
+            if (QueryProcessCycleTime(GetCurrentProcess(), &cycles) && hr_clock_cycles_to_nanos(cycles, &nanos))
+            {
+                return nanos;
+            }
+            GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+            return hr_clock_filetime_nanos(&kernel, &user);
+        default:
+            return hr_clock_monotonic_nanos(); // QPC is neither slewed nor paused on suspend
+    }
+#   endif // FLUENT_LIBC_NO_WINDOWS_SDK
+#else
+    struct timespec ts;
+    clock_gettime(hr_clock_posix_clock_id(source), &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+/**
+ * \brief Returns the time source currently used by get_nano_time().
+ *
+ * With the TSC backend compiled in, the first call calibrates the counter;
+ * if it is not usable, CLOCK_SOURCE_MONOTONIC is reported, which is what
+ * every reader then falls back to.
+ */
+static inline hr_clock_source_t hr_clock_get_source()
+{
+#if defined(FLUENT_LIBC_CLOCK_FIXED_TSC)
+    return hr_clock_tsc_calibrate() ? CLOCK_SOURCE_TSC : CLOCK_SOURCE_MONOTONIC;
+#elif defined(FLUENT_LIBC_CLOCK_FIXED_SOURCE)
+    return FLUENT_LIBC_CLOCK_FIXED_SOURCE; // Constant-folds the dispatch in get_nano_time()
+#else
+    return (hr_clock_source_t)hr_atomic_load_int(&hr_clock_state.source);
+#endif
+}
+
+/**
+ * \brief Selects the time source used by get_nano_time().
+ *
+ * The default is CLOCK_SOURCE_MONOTONIC. Selecting a cycle counter source
+ * calibrates it first (once per process). If the counter is unavailable or not
+ * invariant, this function falls back to CLOCK_SOURCE_MONOTONIC.
+ *
+ * Switching between monotonic sources while intervals are being measured is
+ * allowed: they share the same timeline, up to calibration error and the
+ * coarse clock's resolution.
+ *
+ * With FLUENT_LIBC_CLOCK_BACKEND defined the request is ignored and the
+ * compiled-in source is reported instead. A value outside
+ * \p hr_clock_source_t leaves the source unchanged.
+ *
+ * The CPU-time sources are accepted, but every get_nano_time() interval then
+ * stops while the thread or process is idle.
+ *
+ * \param source The desired time source.
+ * \return The source actually in effect after the call.
+ */
+static inline hr_clock_source_t hr_clock_set_source(const hr_clock_source_t source)
+{
+#ifdef FLUENT_LIBC_CLOCK_FIXED_SOURCE
+    (void)source;
+    return hr_clock_get_source(); // Chosen at compile time
+#else
+    if ((unsigned int)source >= FLUENT_LIBC_CLOCK_SOURCE_COUNT)
+    {
+        return hr_clock_get_source(); // Handle invalid source
+    }
+
+    hr_clock_source_t effective = source;
+    if (source == CLOCK_SOURCE_TSC || source == CLOCK_SOURCE_TSCP)
+    {
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+        if (!hr_clock_tsc_calibrate())
+        {
+            effective = CLOCK_SOURCE_MONOTONIC; // Fall back to the OS clock
+        }
+#else
+        effective = CLOCK_SOURCE_MONOTONIC;
+#endif
+    }
+
+    hr_atomic_store_int(&hr_clock_state.source, (int)effective);
+    return effective;
+#endif
+}
+
+/**
+ * \brief Returns the current monotonic time in nanoseconds.
+ *
+ * This function provides a high-resolution timer for both Windows and POSIX systems.
+ * It reads the source selected with hr_clock_set_source() (see get_nano_time_ex()):
+ * by default the operating system's monotonic clock, or the calibrated cycle
+ * counter, which avoids the vDSO / system call entirely.
+ *
+ * \return The current monotonic time in nanoseconds as a 64-bit integer.
+ */
+static inline long long get_nano_time()
+{
+#if defined(FLUENT_LIBC_CLOCK_FIXED_TSC)
+    return get_nano_time_ex(CLOCK_SOURCE_TSC); // Calibrates once and falls back by itself
+#else
+    return get_nano_time_ex(hr_clock_get_source());
+#endif
+}
+
+/**
+ * \brief Calculates the elapsed time in nanoseconds since a given start time.
+ *
+ * This function returns the difference between the current monotonic time and
+ * the provided \p start_time, both in nanoseconds.
+ *
+ * \param start_time The starting time in nanoseconds, typically obtained from get_nano_time().
+ * \return The elapsed time in nanoseconds as a 64-bit integer.
+ */
+static inline long long time_since(const long long start_time)
+{
+    return get_nano_time() - start_time;
+}
+
+/**
+ * \struct hr_clock_t
+ * \brief High-resolution clock structure for time measurement.
+ *
+ * This structure holds the start time in nanoseconds, typically used
+ * for measuring elapsed time intervals with high precision, along with the
+ * source it was read from so later readings use the same clock.
+ *
+ * hr_clock_tick() fills in both fields. When \p start_time is set by hand,
+ * zero-initialize the structure (`hr_clock_t clk = {0};`), which reads
+ * CLOCK_SOURCE_MONOTONIC, the timeline every wall-time source shares.
+ */
+typedef struct
+{
+    long long start_time;     ///< The start time in nanoseconds
+    hr_clock_source_t source; ///< The source \p start_time was read from (see hr_clock_source_of())
+} hr_clock_t;
+
+/**
+ * \brief Returns the source a clock is read from.
+ *
+ * A \p source outside \p hr_clock_source_t, e.g. left uninitialized by code
+ * that only sets \p start_time, reads as the active source.
+ *
+ * \param clock Pointer to the \p hr_clock_t to inspect; must not be NULL.
+ * \return The source later readings of \p clock use.
+ */
+static inline hr_clock_source_t hr_clock_source_of(const hr_clock_t *const clock)
+{
+    return (unsigned int)clock->source < FLUENT_LIBC_CLOCK_SOURCE_COUNT ? clock->source : hr_clock_get_source();
+}
+
+/**
+ * \enum hr_clock_time_unit_t
+ * \brief Enumeration of time units for high-resolution clock measurements.
+ *
+ * This enum defines various time units that can be used to represent
+ * elapsed time or durations, ranging from nanoseconds to days.
+ */
+typedef enum
+{
+    CLOCK_NANOSECONDS = 0, ///< Time unit in nanoseconds
+    CLOCK_MICROSECONDS,    ///< Time unit in microseconds
+    CLOCK_MILLISECONDS,    ///< Time unit in milliseconds
+    CLOCK_SECONDS,         ///< Time unit in seconds
+    CLOCK_MINUTES,         ///< Time unit in minutes
+    CLOCK_HOURS,           ///< Time unit in hours
+    CLOCK_DAYS,            ///< Time unit in days
+} hr_clock_time_unit_t;
+
+/**
+ * \brief Sets the start time of the clock without checking the pointer.
+ *
+ * Fast-path variant of hr_clock_tick() for hot loops; \p clock must not be NULL.
+ * The active source is one load of the cached selection (a constant with
+ * FLUENT_LIBC_CLOCK_BACKEND), and the cycle counter and monotonic clock are
+ * read directly, without the calibration check of get_nano_time_ex().
+ *
+ * \param clock Pointer to an \p hr_clock_t structure to update.
+ */
+static inline void hr_clock_tick_unchecked(hr_clock_t *const clock)
+{
+#ifdef FLUENT_LIBC_CLOCK_FIXED_SOURCE
+    clock->source = hr_clock_get_source();
+    clock->start_time = get_nano_time(); // Dispatch constant-folded at compile time
+#else
+    const hr_clock_source_t source = (hr_clock_source_t)hr_atomic_load_int(&hr_clock_state.source);
+    clock->source = source;
+#   ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    if (source == CLOCK_SOURCE_TSC)
+    {
+        clock->start_time = hr_clock_tsc_to_nanos(hr_clock_tsc_read()); // Only selectable once calibrated
+        return;
+    }
+#   endif
+    clock->start_time = source == CLOCK_SOURCE_MONOTONIC ? hr_clock_monotonic_nanos() : get_nano_time_ex(source);
+#endif
+}
+
+/**
+ * \brief Sets the start time of the high-resolution clock to the current time.
+ *
+ * This function updates the \p start_time field of the provided \p hr_clock_t structure
+ * to the current monotonic time in nanoseconds, read from the active source. If the
+ * provided pointer is NULL, the function returns without making any changes.
+ *
+ * \param clock Pointer to an \p hr_clock_t structure to update.
+ */
+static inline void hr_clock_tick(hr_clock_t *const clock)
+{
+    if (clock == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    hr_clock_tick_unchecked(clock); // Set the start time to the current time
+}
+
+/**
+ * \brief Sets the start time of the high-resolution clock from a specific source.
+ *
+ * Like hr_clock_tick(), but reads \p source instead of the process-wide
+ * selection; hr_clock_distance_from_now() will keep reading \p source.
+ *
+ * \param clock Pointer to an \p hr_clock_t structure to update.
+ * \param source The time source to start the clock from.
+ */
+static inline void hr_clock_tick_ex(hr_clock_t *const clock, const hr_clock_source_t source)
+{
+    if (clock == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    clock->source = source;
+    clock->start_time = get_nano_time_ex(source); // Set the start time to the current time
+}
+
+/**
+ * \struct hr_clock_divisor_t
+ * \brief Reciprocal constant replacing a division by a unit's length in nanoseconds.
+ *
+ * For any magnitude \c n <= 2^63, \c n / d equals
+ * \c ((n * mult) >> 63) >> shift, where the product is taken on 128 bits
+ * (Granlund-Montgomery, "Division by Invariant Integers using Multiplication").
+ */
+typedef struct
+{
+    unsigned long long mult; ///< ceil(2^(63 + shift) / d)
+    unsigned int shift;      ///< ceil(log2(d))
+} hr_clock_divisor_t;
+
+/**
+ * \brief Reciprocal constants for every \p hr_clock_time_unit_t, indexed by unit.
+ */
+static const hr_clock_divisor_t hr_clock_unit_divisors[] = {
+    {0x8000000000000000ULL, 0},  // CLOCK_NANOSECONDS  (1)
+    {0x83126E978D4FDF3CULL, 10}, // CLOCK_MICROSECONDS (1e3)
+    {0x8637BD05AF6C69B6ULL, 20}, // CLOCK_MILLISECONDS (1e6)
+    {0x89705F4136B4A598ULL, 30}, // CLOCK_SECONDS      (1e9)
+    {0x9299FF347E9E8E80ULL, 36}, // CLOCK_MINUTES      (6e10)
+    {0x9C5FFF26ED75ED55ULL, 42}, // CLOCK_HOURS        (3.6e12)
+    {0xD07FFEDE91F291C6ULL, 47}, // CLOCK_DAYS         (8.64e13)
+};
+
+/**
+ * \brief Length of every \p hr_clock_time_unit_t in nanoseconds, indexed by unit.
+ */
+static const long long hr_clock_unit_nanos[] = {
+    1LL, 1000LL, 1000000LL, 1000000000LL, 60000000000LL, 3600000000000LL, 86400000000000LL
+};
+
+/**
+ * \brief Divides a magnitude (at most 2^63) by a unit length using its reciprocal constant.
+ */
+static inline unsigned long long hr_clock_unit_divide(
+    const unsigned long long magnitude,
+    const hr_clock_divisor_t divisor
+)
+{
+    unsigned long long low;
+    const unsigned long long high = hr_clock_mul_wide(magnitude, divisor.mult, &low);
+    return ((high << 1) | (low >> 63)) >> divisor.shift;
+}
+
+/**
+ * \brief Converts nanoseconds to \p unit without validating the unit.
+ *
+ * Branch-free; \p unit must be a valid \p hr_clock_time_unit_t.
+ *
+ * \param nanos The duration in nanoseconds to convert.
+ * \param unit The target time unit; undefined behaviour if out of range.
+ * \return The converted duration, truncated toward zero.
+ */
+static inline long long clock_nanos_to_unit_unchecked(
+    const long long nanos,
+    const hr_clock_time_unit_t unit
+)
+{
+    // Divide the magnitude, then restore the sign: (x ^ s) - s negates when s is all ones
+    const unsigned long long sign = (unsigned long long)(nanos >> 63);
+    const unsigned long long magnitude = ((unsigned long long)nanos ^ sign) - sign;
+    const unsigned long long quotient = hr_clock_unit_divide(magnitude, hr_clock_unit_divisors[unit]);
+
+    return (long long)((quotient ^ sign) - sign);
+}
+
+/**
+ * \brief Converts a duration in nanoseconds to the specified time unit.
+ *
+ * This function takes a duration in nanoseconds and converts it to the desired
+ * time unit as specified by the \p unit parameter. Supported units include
+ * nanoseconds, microseconds, milliseconds, seconds, minutes, hours, and days.
+ *
+ * The conversion uses a table of reciprocal constants instead of a division, and
+ * truncates toward zero exactly like the \c / operator would.
+ *
+ * \param nanos The duration in nanoseconds to convert.
+ * \param unit The target time unit for conversion (see \p hr_clock_time_unit_t).
+ * \return The converted duration in the specified unit, or -1 if the unit is invalid.
+ */
+static inline long long clock_nanos_to_unit(
+    const long long nanos,
+    const hr_clock_time_unit_t unit
+)
+{
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1l; // Invalid unit
+    }
+
+    return clock_nanos_to_unit_unchecked(nanos, unit);
+}
+
+#if defined(__AVX2__)
+/**
+ * \brief Converts four nanosecond values per iteration with AVX2.
+ *
+ * AVX2 has no 64x64 high multiply, so the product is assembled from four
+ * 32x32 partial products, mirroring hr_clock_mul_wide().
+ *
+ * \return The number of elements converted (a multiple of four).
+ */
+static inline size_t hr_clock_nanos_to_unit_avx2(
+    const long long *const in,
+    long long *const out,
+    const size_t n,
+    const hr_clock_divisor_t divisor
+)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    const __m256i m_lo = _mm256_set1_epi64x((long long)(divisor.mult & 0xFFFFFFFFULL));
+    const __m256i m_hi = _mm256_set1_epi64x((long long)(divisor.mult >> 32));
+    const __m128i shift = _mm_cvtsi32_si128((int)divisor.shift);
+    const __m256i zero = _mm256_setzero_si256();
+
+    const size_t end = n & ~(size_t)3;
+    size_t i = 0;
+    for (; i < end; i += 4)
+    {
+        const __m256i value = _mm256_loadu_si256((const __m256i *)(in + i));
+        const __m256i sign = _mm256_cmpgt_epi64(zero, value);
+        const __m256i a = _mm256_sub_epi64(_mm256_xor_si256(value, sign), sign);
+        const __m256i a_hi = _mm256_srli_epi64(a, 32);
+
+        const __m256i lo_lo = _mm256_mul_epu32(a, m_lo);
+        const __m256i hi_lo = _mm256_mul_epu32(a_hi, m_lo);
+        const __m256i lo_hi = _mm256_mul_epu32(a, m_hi);
+        const __m256i hi_hi = _mm256_mul_epu32(a_hi, m_hi);
+
+        const __m256i cross = _mm256_add_epi64(
+            _mm256_add_epi64(_mm256_srli_epi64(lo_lo, 32), _mm256_and_si256(hi_lo, mask)),
+            lo_hi
+        );
+        const __m256i high = _mm256_add_epi64(
+            _mm256_add_epi64(hi_hi, _mm256_srli_epi64(hi_lo, 32)),
+            _mm256_srli_epi64(cross, 32)
+        );
+
+        // Bit 63 of the low half is bit 31 of cross
+        const __m256i top = _mm256_or_si256(
+            _mm256_slli_epi64(high, 1),
+            _mm256_and_si256(_mm256_srli_epi64(cross, 31), _mm256_set1_epi64x(1))
+        );
+        const __m256i quotient = _mm256_srl_epi64(top, shift);
+
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_sub_epi64(_mm256_xor_si256(quotient, sign), sign));
+    }
+
+    return i;
+}
+#endif // __AVX2__
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+/**
+ * \brief Converts two nanosecond values per iteration with NEON.
+ *
+ * \return The number of elements converted (a multiple of two).
+ */
+static inline size_t hr_clock_nanos_to_unit_neon(
+    const long long *const in,
+    long long *const out,
+    const size_t n,
+    const hr_clock_divisor_t divisor
+)
+{
+    const uint64x2_t mask = vdupq_n_u64(0xFFFFFFFFULL);
+    const uint64x2_t one = vdupq_n_u64(1);
+    const uint32x2_t m_lo = vdup_n_u32((uint32_t)(divisor.mult & 0xFFFFFFFFULL));
+    const uint32x2_t m_hi = vdup_n_u32((uint32_t)(divisor.mult >> 32));
+    const int64x2_t shift = vdupq_n_s64(-(int64_t)divisor.shift); // Negative counts shift right
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        const int64x2_t value = vld1q_s64((const int64_t *)(in + i));
+        const uint64x2_t sign = vreinterpretq_u64_s64(vshrq_n_s64(value, 63));
+        const uint64x2_t a = vsubq_u64(veorq_u64(vreinterpretq_u64_s64(value), sign), sign);
+        const uint32x2_t a_lo = vmovn_u64(a);
+        const uint32x2_t a_hi = vshrn_n_u64(a, 32);
+
+        const uint64x2_t lo_lo = vmull_u32(a_lo, m_lo);
+        const uint64x2_t hi_lo = vmull_u32(a_hi, m_lo);
+        const uint64x2_t lo_hi = vmull_u32(a_lo, m_hi);
+        const uint64x2_t hi_hi = vmull_u32(a_hi, m_hi);
+
+        const uint64x2_t cross = vaddq_u64(vaddq_u64(vshrq_n_u64(lo_lo, 32), vandq_u64(hi_lo, mask)), lo_hi);
+        const uint64x2_t high = vaddq_u64(vaddq_u64(hi_hi, vshrq_n_u64(hi_lo, 32)), vshrq_n_u64(cross, 32));
+
+        // Bit 63 of the low half is bit 31 of cross
+        const uint64x2_t top = vorrq_u64(vshlq_n_u64(high, 1), vandq_u64(vshrq_n_u64(cross, 31), one));
+        const uint64x2_t quotient = vshlq_u64(top, shift);
+
+        vst1q_s64((int64_t *)(out + i), vreinterpretq_s64_u64(vsubq_u64(veorq_u64(quotient, sign), sign)));
+    }
+
+    return i;
+}
+#endif // __ARM_NEON
+
+/**
+ * \brief Converts an array of nanosecond durations to the specified time unit.
+ *
+ * Equivalent to calling clock_nanos_to_unit() on every element, but the unit's
+ * reciprocal constant is loaded once and the bulk of the array goes through the
+ * AVX2 or NEON kernel when enabled at compile time. Plain SSE2 uses the scalar
+ * loop: emulating the 64-bit high multiply with two lanes is slower than it.
+ * \p in and \p out may point to the same array.
+ *
+ * \param in The durations in nanoseconds.
+ * \param out Receives the converted durations, or -1 for every element if the unit is invalid.
+ * \param n The number of elements in \p in and \p out.
+ * \param unit The target time unit for conversion (see \p hr_clock_time_unit_t).
+ */
+static inline void clock_nanos_to_unit_batch(
+    const long long *const in,
+    long long *const out,
+    const size_t n,
+    const hr_clock_time_unit_t unit
+)
+{
+    if (in == NULL || out == NULL)
+    {
+        return; // Handle null pointers
+    }
+
+    size_t i = 0;
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        for (; i < n; i++)
+        {
+            out[i] = -1l; // Invalid unit
+        }
+        return;
+    }
+
+#if defined(__AVX2__)
+    i += hr_clock_nanos_to_unit_avx2(in, out, n, hr_clock_unit_divisors[unit]);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    i += hr_clock_nanos_to_unit_neon(in, out, n, hr_clock_unit_divisors[unit]);
+#endif
+
+    for (; i < n; i++)
+    {
+        out[i] = clock_nanos_to_unit(in[i], unit); // Scalar tail
+    }
+}
+
+/**
+ * \brief Converts a time duration in nanoseconds to a fractional value of the specified unit.
+ *
+ * \param nanos The duration in nanoseconds to convert.
+ * \param unit The target time unit for conversion (see \p hr_clock_time_unit_t).
+ * \return The converted duration, e.g. 1.5 for 1500 ns in CLOCK_MICROSECONDS, or -1.0 if the unit is invalid.
+ */
+static inline double clock_nanos_to_unit_f64(
+    const long long nanos,
+    const hr_clock_time_unit_t unit
+)
+{
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1.0; // Invalid unit
+    }
+
+    return (double)nanos / (double)hr_clock_unit_nanos[unit];
+}
+
+/**
+ * \brief Converts a time duration in nanoseconds to the specified unit, rounding to nearest.
+ *
+ * Halfway cases are rounded away from zero, so 1500 ns is 2 µs and -1500 ns is -2 µs.
+ *
+ * \param nanos The duration in nanoseconds to convert.
+ * \param unit The target time unit for conversion (see \p hr_clock_time_unit_t).
+ * \return The rounded duration in the specified unit, or -1 if the unit is invalid.
+ */
+static inline long long clock_nanos_to_unit_round(
+    const long long nanos,
+    const hr_clock_time_unit_t unit
+)
+{
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1l; // Invalid unit
+    }
+
+    const long long length = hr_clock_unit_nanos[unit];
+    const long long quotient = clock_nanos_to_unit(nanos, unit);
+    const long long remainder = nanos - quotient * length; // Same sign as nanos
+
+    if (remainder >= length - remainder)
+    {
+        return quotient + 1;
+    }
+
+    if (-remainder >= length + remainder)
+    {
+        return quotient - 1;
+    }
+
+    return quotient;
+}
+
+/**
+ * \brief Converts a time duration in nanoseconds to the specified unit, rounding up.
+ *
+ * Useful for timeouts, where a partial unit must never be dropped: 1001 µs is 2 ms.
+ *
+ * \param nanos The duration in nanoseconds to convert.
+ * \param unit The target time unit for conversion (see \p hr_clock_time_unit_t).
+ * \return The smallest whole number of units not less than \p nanos, or -1 if the unit is invalid.
+ */
+static inline long long clock_nanos_to_unit_ceil(
+    const long long nanos,
+    const hr_clock_time_unit_t unit
+)
+{
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1l; // Invalid unit
+    }
+
+    const long long quotient = clock_nanos_to_unit(nanos, unit);
+    return quotient + (nanos - quotient * hr_clock_unit_nanos[unit] > 0);
+}
+
+/**
+ * \struct hr_clock_split_t
+ * \brief A duration broken down into calendar-style components.
+ *
+ * Every component holds the remainder below the next larger unit, e.g.
+ * 90061001001001 ns splits into 1 d 1 h 1 min 1 s 1 ms 1 µs 1 ns.
+ */
+typedef struct
+{
+    int negative;   ///< Non-zero if the duration was negative; components are magnitudes
+    long long days; ///< Whole days
+    int hours;      ///< Hours, 0-23
+    int minutes;    ///< Minutes, 0-59
+    int seconds;    ///< Seconds, 0-59
+    int milliseconds;///< Milliseconds, 0-999
+    int microseconds;///< Microseconds, 0-999
+    int nanoseconds;///< Nanoseconds, 0-999
+} hr_clock_split_t;
+
+/**
+ * \brief Breaks a duration into days, hours, minutes, seconds, ms, µs and ns in one pass.
+ *
+ * Each step divides the remainder of the previous one with the unit's
+ * reciprocal constant, so no division instruction is issued.
+ *
+ * \param nanos The duration in nanoseconds to split.
+ * \param split Pointer to an \p hr_clock_split_t structure to fill.
+ */
+static inline void clock_nanos_split(const long long nanos, hr_clock_split_t *const split)
+{
+    if (split == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    const unsigned long long sign = (unsigned long long)(nanos >> 63);
+    unsigned long long remainder = ((unsigned long long)nanos ^ sign) - sign;
+    unsigned long long parts[CLOCK_DAYS + 1];
+
+    for (int unit = CLOCK_DAYS; unit > CLOCK_NANOSECONDS; unit--)
+    {
+        parts[unit] = hr_clock_unit_divide(remainder, hr_clock_unit_divisors[unit]);
+        remainder -= parts[unit] * (unsigned long long)hr_clock_unit_nanos[unit];
+    }
+
+    split->negative = sign != 0;
+    split->days = (long long)parts[CLOCK_DAYS];
+    split->hours = (int)parts[CLOCK_HOURS];
+    split->minutes = (int)parts[CLOCK_MINUTES];
+    split->seconds = (int)parts[CLOCK_SECONDS];
+    split->milliseconds = (int)parts[CLOCK_MILLISECONDS];
+    split->microseconds = (int)parts[CLOCK_MICROSECONDS];
+    split->nanoseconds = (int)remainder;
+}
+
+/**
+ * \brief Elapsed time between two clocks, without pointer or unit checks.
+ *
+ * Fast-path variant of hr_clock_distance(); the pointers must not be NULL and
+ * \p unit must be valid, so a negative result is always a real negative delta.
+ *
+ * \return The elapsed time between \p clock and \p other in \p unit.
+ */
+static inline long long hr_clock_distance_unchecked(
+    const hr_clock_t *const clock,
+    const hr_clock_t *const other,
+    const hr_clock_time_unit_t unit
+)
+{
+    return clock_nanos_to_unit_unchecked(other->start_time - clock->start_time, unit);
+}
+
+/**
+ * \brief Elapsed time from a clock to now, without pointer or unit checks.
+ *
+ * Fast-path variant of hr_clock_distance_from_now(); \p clock must not be NULL
+ * and \p unit must be valid.
+ *
+ * \return The elapsed time from \p clock to now in \p unit.
+ */
+static inline long long hr_clock_distance_from_now_unchecked(
+    const hr_clock_t *const clock,
+    const hr_clock_time_unit_t unit
+)
+{
+    return clock_nanos_to_unit_unchecked(get_nano_time_ex(hr_clock_source_of(clock)) - clock->start_time, unit);
+}
+
+/**
+ * \brief Calculates the elapsed time between two high-resolution clock instances in the specified unit.
+ *
+ * This function computes the difference between the start times of two \p hr_clock_t structures,
+ * returning the elapsed time converted to the desired time unit.
+ *
+ * \param clock Pointer to the starting \p hr_clock_t structure.
+ * \param other Pointer to the ending \p hr_clock_t structure.
+ * \param unit The time unit in which to return the elapsed time (see \p hr_clock_time_unit_t).
+ * \return The elapsed time between \p clock and \p other in the specified unit, or -1 if any pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_clock_distance(
+    const hr_clock_t *const clock,
+    const hr_clock_t *const other,
+    const hr_clock_time_unit_t unit
+)
+{
+    if (clock == NULL || other == NULL)
+    {
+        return -1l; // Handle null pointers
+    }
+
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1l; // Invalid unit
+    }
+
+    return hr_clock_distance_unchecked(clock, other, unit);
+}
+
+/**
+ * \brief Calculates the elapsed time from the given high-resolution clock to now in the specified unit.
+ *
+ * This function computes the time difference between the current time of the clock's
+ * source and the start time stored in the provided \p hr_clock_t structure, converting
+ * the result to the specified time unit.
+ *
+ * \param clock Pointer to the \p hr_clock_t structure representing the start time.
+ * \param unit The time unit in which to return the elapsed time (see \p hr_clock_time_unit_t).
+ * \return The elapsed time from \p clock to now in the specified unit, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_clock_distance_from_now(
+    const hr_clock_t *const clock,
+    const hr_clock_time_unit_t unit
+)
+{
+    if (clock == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1l; // Invalid unit
+    }
+
+    // Calculate the elapsed time from the start time to now
+    return hr_clock_distance_from_now_unchecked(clock, unit);
+}
+
+// ============= RAW TICK CLOCK =============
+
+/**
+ * \struct hr_ticks_t
+ * \brief An unconverted timestamp, as read from the active clock source.
+ *
+ * For counter-based sources (cycle counter, QueryPerformanceCounter) \p ticks
+ * holds the raw counter value and \p nanos is zero. For clock_gettime()-based
+ * sources, the timespec is kept as-is in \p ticks (seconds) and \p nanos.
+ * Windows sources without a raw counter store nanoseconds in \p ticks.
+ */
+typedef struct
+{
+    long long ticks;          ///< Raw counter value, or whole seconds for timespec-based sources
+    long long nanos;          ///< Sub-second nanoseconds for timespec-based sources, 0 otherwise
+    hr_clock_source_t source; ///< The source the timestamp was read from
+} hr_ticks_t;
+
+/**
+ * \struct hr_tick_clock_t
+ * \brief High-resolution clock that stores its start time as raw ticks.
+ *
+ * Unlike \p hr_clock_t, starting this clock performs no conversion at all;
+ * the tick delta is scaled to nanoseconds only when a distance is requested.
+ */
+typedef struct
+{
+    hr_ticks_t start_ticks; ///< The start time in raw ticks
+} hr_tick_clock_t;
+
+/**
+ * \brief Checks whether timestamps of \p source are QueryPerformanceCounter ticks.
+ */
+static inline int hr_ticks_is_qpc(const hr_clock_source_t source)
+{
+#if defined(_WIN32) && !defined(FLUENT_LIBC_NO_WINDOWS_SDK)
+    return source == CLOCK_SOURCE_MONOTONIC
+        || source == CLOCK_SOURCE_MONOTONIC_RAW
+        || source == CLOCK_SOURCE_BOOTTIME;
+#else
+    (void)source;
+    return 0;
+#endif
+}
+
+/**
+ * \brief Reads the active clock source without converting to nanoseconds.
+ *
+ * \return The current time as raw ticks (see \p hr_ticks_t).
+ */
+static inline hr_ticks_t hr_ticks_now()
+{
+    hr_ticks_t now;
+    now.source = hr_clock_get_source();
+    now.nanos = 0;
+
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    if (now.source == CLOCK_SOURCE_TSC)
+    {
+        now.ticks = (long long)hr_clock_tsc_read();
+        return now;
+    }
+
+    if (now.source == CLOCK_SOURCE_TSCP)
+    {
+        now.ticks = (long long)hr_clock_tscp_read();
+        return now;
+    }
+#endif
+
+#ifdef _WIN32
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    now.ticks = 0LL;
+#   else
+    if (hr_ticks_is_qpc(now.source))
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        now.ticks = (long long)counter.QuadPart;
+    }
+    else
+    {
+        now.ticks = get_nano_time_ex(now.source); // Reported in nanoseconds already
+    }
+#   endif // FLUENT_LIBC_NO_WINDOWS_SDK
+#else
+    struct timespec ts;
+    clock_gettime(hr_clock_posix_clock_id(now.source), &ts);
+    now.ticks = (long long)ts.tv_sec;
+    now.nanos = (long long)ts.tv_nsec;
+#endif
+
+    return now;
+}
+
+/**
+ * \brief Checks whether timestamps of \p source are stored as a timespec.
+ */
+static inline int hr_ticks_is_timespec(const hr_clock_source_t source)
+{
+#ifdef _WIN32
+    (void)source;
+    return 0; // QueryPerformanceCounter ticks
+#else
+    return source != CLOCK_SOURCE_TSC && source != CLOCK_SOURCE_TSCP;
+#endif
+}
+
+/**
+ * \brief Computes the raw tick delta between two timestamps of the same source.
+ *
+ * For timespec-based sources the delta is already expressed in nanoseconds.
+ *
+ * \param start The earlier timestamp.
+ * \param end The later timestamp.
+ * \return \p end - \p start, in ticks of their source.
+ */
+static inline long long hr_ticks_diff(const hr_ticks_t *const start, const hr_ticks_t *const end)
+{
+    if (hr_ticks_is_timespec(start->source))
+    {
+        return (end->ticks - start->ticks) * 1000000000LL + (end->nanos - start->nanos);
+    }
+
+    return end->ticks - start->ticks;
+}
+
+/**
+ * \brief Returns the tick-to-nanosecond scale of a source, or NULL if it counts nanoseconds.
+ */
+static inline const hr_clock_scale_t *hr_ticks_scale(const hr_clock_source_t source)
+{
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    if (source == CLOCK_SOURCE_TSC || source == CLOCK_SOURCE_TSCP)
+    {
+        return &hr_clock_state.tsc_scale;
+    }
+#endif
+
+    if (hr_ticks_is_qpc(source))
+    {
+        hr_clock_init();
+        return &hr_clock_state.qpc_scale;
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Scales a raw tick delta to nanoseconds.
+ *
+ * \param ticks A tick delta, typically obtained from hr_ticks_diff().
+ * \param source The source the ticks were read from.
+ * \return The delta in nanoseconds.
+ */
+static inline long long hr_ticks_to_nanos(const long long ticks, const hr_clock_source_t source)
+{
+    const hr_clock_scale_t *const scale = hr_ticks_scale(source);
+    if (scale == NULL)
+    {
+        return ticks; // Already nanoseconds
+    }
+
+    if (ticks < 0)
+    {
+        return -(long long)hr_clock_mul_shift(0 - (unsigned long long)ticks, scale->mult, scale->shift);
+    }
+
+    return (long long)hr_clock_mul_shift((unsigned long long)ticks, scale->mult, scale->shift);
+}
+
 /**
- * \brief Returns the current monotonic time in nanoseconds.
+ * \brief Converts a raw timestamp to nanoseconds on the get_nano_time() timeline.
  *
- * This function provides a high-resolution timer for both Windows and POSIX systems.
- * On Windows, it uses QueryPerformanceCounter and QueryPerformanceFrequency to compute
- * the elapsed time in nanoseconds. On POSIX systems, it uses clock_gettime with
- * CLOCK_MONOTONIC for nanosecond precision.
+ * \param ticks The timestamp to convert.
+ * \return The value get_nano_time() would have returned at that instant.
+ */
+static inline long long hr_ticks_absolute_nanos(const hr_ticks_t *const ticks)
+{
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    if (ticks->source == CLOCK_SOURCE_TSC || ticks->source == CLOCK_SOURCE_TSCP)
+    {
+        return hr_clock_tsc_to_nanos((unsigned long long)ticks->ticks);
+    }
+#endif
+
+    if (hr_ticks_is_timespec(ticks->source))
+    {
+        return ticks->ticks * 1000000000LL + ticks->nanos;
+    }
+
+    return hr_ticks_to_nanos(ticks->ticks, ticks->source);
+}
+
+/**
+ * \brief Sets the start time of the raw tick clock to the current time.
  *
- * \return The current monotonic time in nanoseconds as a 64-bit integer.
+ * \param clock Pointer to an \p hr_tick_clock_t structure to update.
  */
-static inline long long get_nano_time()
+static inline void hr_tick_clock_tick(hr_tick_clock_t *const clock)
+{
+    if (clock == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    clock->start_ticks = hr_ticks_now(); // Set the start time to the current time
+}
+
+/**
+ * \brief Calculates the elapsed time between two raw tick clocks in the specified unit.
+ *
+ * The tick delta is scaled to nanoseconds here, once. If the clocks were started
+ * from different sources, both timestamps are first mapped to the common
+ * get_nano_time() timeline.
+ *
+ * \param clock Pointer to the starting \p hr_tick_clock_t structure.
+ * \param other Pointer to the ending \p hr_tick_clock_t structure.
+ * \param unit The time unit in which to return the elapsed time (see \p hr_clock_time_unit_t).
+ * \return The elapsed time between \p clock and \p other in the specified unit, or -1 if any pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_tick_clock_distance(
+    const hr_tick_clock_t *const clock,
+    const hr_tick_clock_t *const other,
+    const hr_clock_time_unit_t unit
+)
+{
+    if (clock == NULL || other == NULL)
+    {
+        return -1l; // Handle null pointers
+    }
+
+    if (clock->start_ticks.source != other->start_ticks.source)
+    {
+        return clock_nanos_to_unit(
+            hr_ticks_absolute_nanos(&other->start_ticks) - hr_ticks_absolute_nanos(&clock->start_ticks),
+            unit
+        );
+    }
+
+    return clock_nanos_to_unit(
+        hr_ticks_to_nanos(hr_ticks_diff(&clock->start_ticks, &other->start_ticks), clock->start_ticks.source),
+        unit
+    );
+}
+
+/**
+ * \brief Calculates the elapsed time from the given raw tick clock to now in the specified unit.
+ *
+ * \param clock Pointer to the \p hr_tick_clock_t structure representing the start time.
+ * \param unit The time unit in which to return the elapsed time (see \p hr_clock_time_unit_t).
+ * \return The elapsed time from \p clock to now in the specified unit, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_tick_clock_distance_from_now(
+    const hr_tick_clock_t *const clock,
+    const hr_clock_time_unit_t unit
+)
+{
+    hr_tick_clock_t now;
+    now.start_ticks = hr_ticks_now();
+    return hr_tick_clock_distance(clock, &now, unit);
+}
+
+// ============= BATCH STAMPING =============
+
+/**
+ * \enum hr_stamp_policy_t
+ * \brief Accuracy / cost trade-off of hr_clock_stamp_batch().
+ */
+typedef enum
+{
+    HR_STAMP_SHARED = 0,   ///< One read; every element gets the same stamp
+    HR_STAMP_INTERPOLATED, ///< One read; stamps spread evenly since the thread's previous batch
+    HR_STAMP_SERIALIZED,   ///< One ordered read per element (rdtscp / isb when the TSC is active)
+} hr_stamp_policy_t;
+
+/**
+ * \struct hr_clock_stamp_state_t
+ * \brief The last batch reading on the calling thread; the lower bound of the next interpolated burst.
+ */
+typedef struct
+{
+    long long nanos; ///< Last reading in nanoseconds
+    int source;      ///< Source of \p nanos, or -1 before the first batch
+} hr_clock_stamp_state_t;
+
+FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL hr_clock_stamp_state_t hr_clock_stamp_state = {0, -1};
+
+/**
+ * \brief Fills \p out with stamps spread evenly over (\p start, \p end].
+ *
+ * The last element gets \p end; the stamps never decrease. If \p end is not
+ * after \p start, every element gets \p end.
+ *
+ * \param out Destination array of \p n stamps.
+ * \param n Number of stamps.
+ * \param start Exclusive lower bound in nanoseconds.
+ * \param end Inclusive upper bound in nanoseconds.
+ */
+static inline void hr_clock_stamp_between(
+    long long *const out,
+    const size_t n,
+    const long long start,
+    const long long end
+)
+{
+    if (out == NULL || n == 0)
+    {
+        return; // Handle null pointer
+    }
+
+    // 48.16 fixed-point step; spans beyond 2^47 ns (~39 h) are clamped
+    unsigned long long span = end > start ? (unsigned long long)(end - start) : 0;
+    if (span > (1ULL << 47))
+    {
+        span = 1ULL << 47;
+    }
+
+    const unsigned long long step = (span << 16) / n;
+    const long long base = end - (long long)span;
+    unsigned long long offset = 0;
+    for (size_t i = 0; i + 1 < n; i++)
+    {
+        offset += step;
+        out[i] = base + (long long)(offset >> 16);
+    }
+    out[n - 1] = end;
+}
+
+/**
+ * \brief Stamps a burst of \p n events from the active source (see get_nano_time()).
+ *
+ * - HR_STAMP_SHARED reads the clock once and gives every element that reading.
+ * - HR_STAMP_INTERPOLATED reads once and spreads the stamps evenly between the
+ *   calling thread's previous batch reading and this one. In a receive loop
+ *   that window is the one the burst arrived in; the first batch on a thread
+ *   (or after a source switch) behaves like HR_STAMP_SHARED. When the thread
+ *   may have been idle since its previous batch, take a reading right before
+ *   the receive call and use hr_clock_stamp_batch_since() instead.
+ * - HR_STAMP_SERIALIZED reads once per element. With the TSC active each read
+ *   is an ordered rdtscp / isb + cntvct_el0, converted without re-dispatching;
+ *   otherwise the active source is read directly.
+ *
+ * \param out Destination array of \p n stamps in nanoseconds.
+ * \param n Number of stamps.
+ * \param policy How to stamp (see \p hr_stamp_policy_t).
+ * \return The last clock reading in nanoseconds, or -1 if \p out is NULL.
+ */
+static inline long long hr_clock_stamp_batch(long long *const out, const size_t n, const hr_stamp_policy_t policy)
+{
+    if (out == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    const hr_clock_source_t source = hr_clock_get_source();
+    long long now;
+    if (policy == HR_STAMP_SERIALIZED && n != 0)
+    {
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+        if ((source == CLOCK_SOURCE_TSC || source == CLOCK_SOURCE_TSCP) && hr_clock_tsc_calibrate())
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                out[i] = hr_clock_tsc_to_nanos(hr_clock_tscp_read());
+            }
+        }
+        else
+#endif
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                out[i] = get_nano_time_ex(source);
+            }
+        }
+        now = out[n - 1];
+    }
+    else if (policy == HR_STAMP_INTERPOLATED && hr_clock_stamp_state.source == (int)source)
+    {
+        now = get_nano_time_ex(source);
+        hr_clock_stamp_between(out, n, hr_clock_stamp_state.nanos, now);
+    }
+    else
+    {
+        now = get_nano_time_ex(source);
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = now;
+        }
+    }
+
+    hr_clock_stamp_state.nanos = now;
+    hr_clock_stamp_state.source = (int)source;
+    return now;
+}
+
+/**
+ * \brief Stamps a burst of \p n events spread evenly between \p start and now.
+ *
+ * \p start is a get_nano_time() reading the caller took when the burst began,
+ * e.g. right before the receive call that returned it; the stamps estimate
+ * when each event arrived within that window, and the last one is now. The
+ * reading also bounds the thread's next HR_STAMP_INTERPOLATED batch.
+ *
+ * \param out Destination array of \p n stamps in nanoseconds.
+ * \param n Number of stamps.
+ * \param start Exclusive lower bound in nanoseconds, on the get_nano_time() timeline.
+ * \return The clock reading in nanoseconds, or -1 if \p out is NULL.
+ */
+static inline long long hr_clock_stamp_batch_since(long long *const out, const size_t n, const long long start)
+{
+    if (out == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    const hr_clock_source_t source = hr_clock_get_source();
+    const long long now = get_nano_time_ex(source);
+    hr_clock_stamp_between(out, n, start, now);
+    hr_clock_stamp_state.nanos = now;
+    hr_clock_stamp_state.source = (int)source;
+    return now;
+}
+
+// ============= OVERHEAD CALIBRATION =============
+
+/**
+ * \def FLUENT_LIBC_CLOCK_CALIBRATION_SAMPLES
+ * \brief Number of back-to-back read pairs hr_clock_calibrate() measures.
+ */
+#ifndef FLUENT_LIBC_CLOCK_CALIBRATION_SAMPLES
+#   define FLUENT_LIBC_CLOCK_CALIBRATION_SAMPLES 1001
+#endif
+
+/**
+ * \struct hr_clock_calibration_t
+ * \brief Measured cost and granularity of one clock source.
+ */
+typedef struct
+{
+    hr_clock_source_t source;       ///< The source these results describe
+    int valid;                      ///< Non-zero once the source has been calibrated
+    long long overhead_min;         ///< Smallest delta between two back-to-back reads, in ns
+    long long overhead_median;      ///< Median delta between two back-to-back reads, in ns
+    long long resolution;           ///< Resolution reported by the platform (clock_getres / counter frequency), in ns
+    long long observed_resolution;  ///< Smallest non-zero step seen between successive reads, in ns
+} hr_clock_calibration_t;
+
+FLUENT_LIBC_CLOCK_GLOBAL hr_clock_calibration_t hr_clock_calibrations[FLUENT_LIBC_CLOCK_SOURCE_COUNT] = {{CLOCK_SOURCE_MONOTONIC, 0, 0, 0, 0, 0}};
+
+/**
+ * \brief Returns the resolution the platform advertises for a source, in nanoseconds.
+ */
+static inline long long hr_clock_platform_resolution(const hr_clock_source_t source)
 {
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    if ((source == CLOCK_SOURCE_TSC || source == CLOCK_SOURCE_TSCP) && hr_clock_tsc_calibrate())
+    {
+        const long long period = (long long)(1000000000ULL / hr_clock_state.tsc_frequency);
+        return period > 0 ? period : 1;
+    }
+#endif
+
 #ifdef _WIN32
 #   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
-    // If FLUENT_LIBC_NO_WINDOWS_SDK is defined, we assume
-    // the Windows SDK is not available, therefore some libraries
-    // may not be implemented.
-    return 0LL; // Return 0
+    (void)source;
+    return 0LL; // Unknown
 #   else
-    LARGE_INTEGER frequency, counter;
-    QueryPerformanceFrequency(&frequency);
-    QueryPerformanceCounter(&counter);
+    if (source == CLOCK_SOURCE_MONOTONIC_COARSE)
+    {
+        return 1000000LL; // GetTickCount64 counts milliseconds
+    }
+
+    if (hr_ticks_is_qpc(source))
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return (1000000000LL + frequency.QuadPart - 1) / frequency.QuadPart;
+    }
 
-    // Convert to nanoseconds: (counter / frequency) * 1e9
-    return (long long)((double)counter.QuadPart / frequency.QuadPart * 1e9);
+    return 100LL; // FILETIME-based CPU times count 100 ns units
 #   endif // FLUENT_LIBC_NO_WINDOWS_SDK
 #else
     struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
+    if (clock_getres(hr_clock_posix_clock_id(source), &ts) != 0)
+    {
+        return 0LL; // Unknown
+    }
+
     return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
 #endif
 }
 
 /**
- * \brief Calculates the elapsed time in nanoseconds since a given start time.
+ * \brief Measures the read overhead and effective resolution of a clock source.
  *
- * This function returns the difference between the current monotonic time and
- * the provided \p start_time, both in nanoseconds.
+ * Takes FLUENT_LIBC_CLOCK_CALIBRATION_SAMPLES back-to-back read pairs and
+ * keeps their minimum and median, then watches the clock tick over for up to
+ * ~20 ms to find the smallest step it actually makes. The results are stored
+ * process-wide for hr_clock_distance_corrected() and returned in \p out.
  *
- * \param start_time The starting time in nanoseconds, typically obtained from get_nano_time().
- * \return The elapsed time in nanoseconds as a 64-bit integer.
+ * \param source The source to calibrate.
+ * \param out Optional pointer receiving a copy of the results (may be NULL).
  */
-static long long time_since(const long long start_time)
+static inline void hr_clock_calibrate_source(const hr_clock_source_t source, hr_clock_calibration_t *const out)
 {
-    return get_nano_time() - start_time;
+    if ((int)source < 0 || (int)source >= FLUENT_LIBC_CLOCK_SOURCE_COUNT)
+    {
+        return; // Invalid source
+    }
+
+    long long deltas[FLUENT_LIBC_CLOCK_CALIBRATION_SAMPLES];
+    for (int i = 0; i < 64; i++)
+    {
+        (void)get_nano_time_ex(source); // Warm up caches and lazy initialization
+    }
+
+    for (int i = 0; i < FLUENT_LIBC_CLOCK_CALIBRATION_SAMPLES; i++)
+    {
+        const long long start = get_nano_time_ex(source);
+        const long long end = get_nano_time_ex(source);
+
+        // Insertion sort as we go; the sample count is small and this is not a hot path
+        int j = i;
+        for (; j > 0 && deltas[j - 1] > end - start; j--)
+        {
+            deltas[j] = deltas[j - 1];
+        }
+        deltas[j] = end - start;
+    }
+
+    hr_clock_calibration_t result;
+    result.source = source;
+    result.valid = 1;
+    result.overhead_min = deltas[0] < 0 ? 0 : deltas[0];
+    result.overhead_median = deltas[FLUENT_LIBC_CLOCK_CALIBRATION_SAMPLES / 2];
+    result.resolution = hr_clock_platform_resolution(source);
+    result.observed_resolution = 0;
+
+    // Watch the source tick over a few times, bounded by the monotonic clock
+    const long long deadline = hr_clock_monotonic_nanos() + 20000000LL;
+    for (int step = 0; step < 16 && hr_clock_monotonic_nanos() < deadline; step++)
+    {
+        const long long start = get_nano_time_ex(source);
+        long long now = start;
+        while (now == start && hr_clock_monotonic_nanos() < deadline)
+        {
+            now = get_nano_time_ex(source);
+        }
+
+        if (now > start && (result.observed_resolution == 0 || now - start < result.observed_resolution))
+        {
+            result.observed_resolution = now - start;
+        }
+    }
+
+    hr_clock_calibrations[source] = result;
+    if (out != NULL)
+    {
+        *out = result;
+    }
 }
 
 /**
- * \struct hr_clock_t
- * \brief High-resolution clock structure for time measurement.
+ * \brief Measures the read overhead and effective resolution of the active clock source.
  *
- * This structure holds the start time in nanoseconds, typically used
- * for measuring elapsed time intervals with high precision.
- */
-typedef struct
-{
-    long long start_time; ///< The start time in nanoseconds
-} hr_clock_t;
-
-/**
- * \enum hr_clock_time_unit_t
- * \brief Enumeration of time units for high-resolution clock measurements.
+ * See hr_clock_calibrate_source().
  *
- * This enum defines various time units that can be used to represent
- * elapsed time or durations, ranging from nanoseconds to days.
+ * \param out Optional pointer receiving a copy of the results (may be NULL).
  */
-typedef enum
+static inline void hr_clock_calibrate(hr_clock_calibration_t *const out)
 {
-    CLOCK_NANOSECONDS = 0, ///< Time unit in nanoseconds
-    CLOCK_MICROSECONDS,    ///< Time unit in microseconds
-    CLOCK_MILLISECONDS,    ///< Time unit in milliseconds
-    CLOCK_SECONDS,         ///< Time unit in seconds
-    CLOCK_MINUTES,         ///< Time unit in minutes
-    CLOCK_HOURS,           ///< Time unit in hours
-    CLOCK_DAYS,            ///< Time unit in days
-} hr_clock_time_unit_t;
+    hr_clock_calibrate_source(hr_clock_get_source(), out);
+}
 
 /**
- * \brief Sets the start time of the high-resolution clock to the current time.
- *
- * This function updates the \p start_time field of the provided \p hr_clock_t structure
- * to the current monotonic time in nanoseconds. If the provided pointer is NULL,
- * the function returns without making any changes.
+ * \brief Returns the stored calibration results of a source.
  *
- * \param clock Pointer to an \p hr_clock_t structure to update.
+ * \param source The source to look up.
+ * \return Pointer to the results, or NULL if the source was never calibrated.
  */
-static inline void hr_clock_tick(hr_clock_t *const clock)
+static inline const hr_clock_calibration_t *hr_clock_calibration(const hr_clock_source_t source)
 {
-    if (clock == NULL)
+    if ((int)source < 0 || (int)source >= FLUENT_LIBC_CLOCK_SOURCE_COUNT || !hr_clock_calibrations[source].valid)
     {
-        return; // Handle null pointer
+        return NULL; // Invalid or uncalibrated source
     }
 
-    clock->start_time = get_nano_time(); // Set the start time to the current time
+    return &hr_clock_calibrations[source];
 }
 
 /**
- * \brief Converts a time duration in nanoseconds to the specified time unit.
- *
- * This function takes a duration in nanoseconds and converts it to the desired
- * time unit as specified by the \p unit parameter. Supported units include
- * nanoseconds, microseconds, milliseconds, seconds, minutes, hours, and days.
+ * \brief Subtracts the calibrated read overhead of a source from a measured duration.
  *
- * \param nanos The duration in nanoseconds to convert.
- * \param unit The target time unit for conversion (see \p hr_clock_time_unit_t).
- * \return The converted duration in the specified unit, or -1 if the unit is invalid.
+ * The minimum overhead is subtracted, so typical measurements are never
+ * over-corrected; non-negative durations are floored at zero. Negative
+ * durations (end before start) pass through unchanged, as in hr_clock_distance().
  */
-static inline long long clock_nanos_to_unit(
-    const long long nanos,
-    const hr_clock_time_unit_t unit
-)
+static inline long long hr_clock_correct_nanos(const long long nanos, const hr_clock_source_t source)
 {
-    switch (unit)
-    {
-        case CLOCK_NANOSECONDS:
-            return nanos;
-        case CLOCK_MICROSECONDS:
-            return nanos / 1000;
-        case CLOCK_MILLISECONDS:
-            return nanos / 1000000;
-        case CLOCK_SECONDS:
-            return nanos / 1000000000;
-        case CLOCK_MINUTES:
-            return nanos / 60000000000LL;
-        case CLOCK_HOURS:
-            return nanos / 3600000000000LL;
-        case CLOCK_DAYS:
-            return nanos / 86400000000000LL;
-        default:
-            return -1l; // Invalid unit
+    const hr_clock_calibration_t *const calibration = hr_clock_calibration(source);
+    if (calibration == NULL || nanos < 0)
+    {
+        return nanos; // Nothing to subtract, or keep the ordering information
     }
+
+    const long long corrected = nanos - calibration->overhead_min;
+    return corrected < 0 ? 0 : corrected;
 }
 
 /**
- * \brief Calculates the elapsed time between two high-resolution clock instances in the specified unit.
+ * \brief Like hr_clock_distance(), minus the calibrated read overhead.
  *
- * This function computes the difference between the start times of two \p hr_clock_t structures,
- * returning the elapsed time converted to the desired time unit.
+ * Call hr_clock_calibrate() (for the source \p clock was started with) first;
+ * otherwise nothing is subtracted.
  *
  * \param clock Pointer to the starting \p hr_clock_t structure.
  * \param other Pointer to the ending \p hr_clock_t structure.
  * \param unit The time unit in which to return the elapsed time (see \p hr_clock_time_unit_t).
- * \return The elapsed time between \p clock and \p other in the specified unit, or -1 if any pointer is NULL or the unit is invalid.
+ * \return The corrected elapsed time in the specified unit, or -1 if any pointer is NULL or the unit is invalid.
  */
-static inline long long hr_clock_distance(
+static inline long long hr_clock_distance_corrected(
     const hr_clock_t *const clock,
     const hr_clock_t *const other,
     const hr_clock_time_unit_t unit
@@ -206,21 +2349,17 @@ static inline long long hr_clock_distance(
         return -1l; // Handle null pointers
     }
 
-    return clock_nanos_to_unit(other->start_time - clock->start_time, unit);
+    return clock_nanos_to_unit(hr_clock_correct_nanos(other->start_time - clock->start_time, hr_clock_source_of(clock)), unit);
 }
 
 /**
- * \brief Calculates the elapsed time from the given high-resolution clock to now in the specified unit.
- *
- * This function computes the time difference between the current monotonic time and the
- * start time stored in the provided \p hr_clock_t structure, converting the result to the
- * specified time unit.
+ * \brief Like hr_clock_distance_from_now(), minus the calibrated read overhead.
  *
  * \param clock Pointer to the \p hr_clock_t structure representing the start time.
  * \param unit The time unit in which to return the elapsed time (see \p hr_clock_time_unit_t).
- * \return The elapsed time from \p clock to now in the specified unit, or -1 if the pointer is NULL or the unit is invalid.
+ * \return The corrected elapsed time in the specified unit, or -1 if the pointer is NULL or the unit is invalid.
  */
-static inline long long hr_clock_distance_from_now(
+static inline long long hr_clock_distance_from_now_corrected(
     const hr_clock_t *const clock,
     const hr_clock_time_unit_t unit
 )
@@ -230,13 +2369,57 @@ static inline long long hr_clock_distance_from_now(
         return -1l; // Handle null pointer
     }
 
-    // Calculate the elapsed time from the start time to now
-    return clock_nanos_to_unit(
-        get_nano_time() - clock->start_time,
-        unit
-    );
+    const hr_clock_source_t source = hr_clock_source_of(clock);
+    const long long elapsed = get_nano_time_ex(source) - clock->start_time;
+    return clock_nanos_to_unit(hr_clock_correct_nanos(elapsed, source), unit);
 }
 
+// ============= SHARED LIBRARY =============
+// Exported by the clock_shared library target, for callers that cannot
+// inline this header (other languages, plugins) or want one symbol whose
+// source is picked at runtime. Header-only users never need these.
+
+/**
+ * \def FLUENT_LIBC_CLOCK_API
+ * \brief Visibility / import-export specifier of the shared library's functions.
+ *
+ * FLUENT_LIBC_CLOCK_BUILD_SHARED is defined while building the library and
+ * FLUENT_LIBC_CLOCK_SHARED by its consumers (CMake sets both).
+ */
+#ifndef FLUENT_LIBC_CLOCK_API
+#   if defined(_WIN32) && defined(FLUENT_LIBC_CLOCK_BUILD_SHARED)
+#       define FLUENT_LIBC_CLOCK_API __declspec(dllexport)
+#   elif defined(_WIN32) && defined(FLUENT_LIBC_CLOCK_SHARED)
+#       define FLUENT_LIBC_CLOCK_API __declspec(dllimport)
+#   elif defined(FLUENT_LIBC_CLOCK_BUILD_SHARED)
+#       define FLUENT_LIBC_CLOCK_API __attribute__((visibility("default")))
+#   else
+#       define FLUENT_LIBC_CLOCK_API
+#   endif
+#endif
+
+/**
+ * \brief Reads the dispatched source in nanoseconds through a single indirect call.
+ *
+ * The first call resolves the source from the FLUENT_CLOCK_BACKEND
+ * environment variable (tsc, vdso, qpc or coarse; the OS monotonic clock if
+ * unset or unknown) and caches the matching reader.
+ */
+FLUENT_LIBC_CLOCK_API long long hr_clock_dispatch_now();
+
+/**
+ * \brief Switches the dispatched source at runtime (see hr_clock_set_source()).
+ *
+ * \param source The desired time source.
+ * \return The source actually in effect after the call.
+ */
+FLUENT_LIBC_CLOCK_API hr_clock_source_t hr_clock_dispatch_select(hr_clock_source_t source);
+
+/**
+ * \brief Returns the source hr_clock_dispatch_now() reads, resolving it if needed.
+ */
+FLUENT_LIBC_CLOCK_API hr_clock_source_t hr_clock_dispatch_source();
+
 // ============= FLUENT LIB C++ =============
 #if defined(__cplusplus)
 }
@@ -0,0 +1,266 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_HPP
+#define FLUENT_LIBC_CLOCK_HPP
+
+// ============= FLUENT LIB C++ =============
+// std::chrono Wrapper
+// ----------------------------------------
+// Header-only C++11 layer over clock.h: clocks that satisfy the TrivialClock
+// requirements, an RAII timer that records into an hr_histogram_t, and unit
+// conversions resolved at compile time.
+//
+// Features:
+// - `fluent::hr_clock`: std::chrono clock reading the active source (get_nano_time())
+// - `fluent::hr_source_clock<Source>`: std::chrono clock pinned to one source
+// - `fluent::scoped_timer`: Records its lifetime into a histogram on destruction
+// - `fluent::clock_nanos_to_unit<Unit>()`: constexpr conversion (a multiply, no divide)
+// - `fluent::clock_unit_duration<Unit>::type`: The matching std::chrono::duration
+//
+// Example:
+// ----------------------------------------
+//   const auto start = fluent::hr_clock::now();
+//   {
+//       fluent::scoped_timer timer(request_latency);
+//       // ... work ...
+//   }
+//   const auto spent = fluent::hr_clock::now() - start;
+//   long long ms = fluent::clock_nanos_to_unit<CLOCK_MILLISECONDS>(spent.count());
+//
+
+#include <chrono>
+#include <ratio>
+#include "clock.h"
+#include "clock_histogram.h"
+
+namespace fluent
+{
+    // ============= UNIT CONVERSION =============
+
+    /**
+     * \brief Length of \p Unit in nanoseconds, as a constant expression.
+     */
+    template <hr_clock_time_unit_t Unit>
+    constexpr long long clock_unit_nanos() noexcept
+    {
+        static_assert((unsigned int)Unit <= (unsigned int)CLOCK_DAYS, "invalid hr_clock_time_unit_t");
+        return Unit == CLOCK_NANOSECONDS ? 1LL
+            : Unit == CLOCK_MICROSECONDS ? 1000LL
+            : Unit == CLOCK_MILLISECONDS ? 1000000LL
+            : Unit == CLOCK_SECONDS ? 1000000000LL
+            : Unit == CLOCK_MINUTES ? 60000000000LL
+            : Unit == CLOCK_HOURS ? 3600000000000LL
+            : 86400000000000LL;
+    }
+
+    /**
+     * \brief Converts nanoseconds to \p Unit, truncating toward zero.
+     *
+     * The divisor is a constant, so the compiler emits a multiply by its
+     * reciprocal; the result matches ::clock_nanos_to_unit().
+     *
+     * \param nanos The duration in nanoseconds to convert.
+     * \return The converted duration.
+     */
+    template <hr_clock_time_unit_t Unit>
+    constexpr long long clock_nanos_to_unit(const long long nanos) noexcept
+    {
+        return nanos / clock_unit_nanos<Unit>();
+    }
+
+    /**
+     * \brief Converts a count of \p Unit to nanoseconds (no overflow check).
+     */
+    template <hr_clock_time_unit_t Unit>
+    constexpr long long clock_unit_to_nanos(const long long value) noexcept
+    {
+        return value * clock_unit_nanos<Unit>();
+    }
+
+    /**
+     * \struct clock_unit_duration
+     * \brief Maps an \p hr_clock_time_unit_t to the equivalent std::chrono::duration.
+     */
+    template <hr_clock_time_unit_t Unit>
+    struct clock_unit_duration
+    {
+        typedef std::chrono::duration<long long, typename std::ratio<clock_unit_nanos<Unit>(), 1000000000LL>::type> type;
+    };
+
+    // ============= CLOCKS =============
+
+    /**
+     * \struct hr_source_clock
+     * \brief A std::chrono clock that always reads \p Source (see get_nano_time_ex()).
+     *
+     * The monotonic sources and the TSC share one timeline, so their time
+     * points can be compared; the CPU-time sources only advance while the
+     * thread or process runs.
+     */
+    template <hr_clock_source_t Source>
+    struct hr_source_clock
+    {
+        typedef long long rep;
+        typedef std::nano period;
+        typedef std::chrono::duration<rep, period> duration;
+        typedef std::chrono::time_point<hr_source_clock, duration> time_point;
+
+        // CPU-time sources stop while the thread or process is not running
+        static constexpr bool is_steady = Source < CLOCK_SOURCE_THREAD_CPUTIME;
+
+        /**
+         * \brief Reads \p Source.
+         */
+        static time_point now() noexcept
+        {
+            return time_point(duration(::get_nano_time_ex(Source)));
+        }
+    };
+
+    /**
+     * \struct hr_clock
+     * \brief A std::chrono clock reading the process-wide source (see get_nano_time()).
+     *
+     * The source is whatever ::hr_clock_set_source() selected: the OS monotonic
+     * clock (vDSO on Linux, QPC on Windows) by default, or the calibrated TSC.
+     * Only switch between monotonic sources while intervals are in flight.
+     *
+     * is_steady holds as long as the process-wide source is a wall-time one:
+     * set_source() refuses the CPU-time sources, but a CPU-time source
+     * selected through the C ::hr_clock_set_source() makes it stop while the
+     * process is idle.
+     */
+    struct hr_clock
+    {
+        typedef long long rep;
+        typedef std::nano period;
+        typedef std::chrono::duration<rep, period> duration;
+        typedef std::chrono::time_point<hr_clock, duration> time_point;
+
+        static constexpr bool is_steady = true;
+
+        /**
+         * \brief Reads the active source.
+         */
+        static time_point now() noexcept
+        {
+            return time_point(duration(::get_nano_time()));
+        }
+
+        /**
+         * \brief Selects the process-wide source; see ::hr_clock_set_source().
+         *
+         * CPU-time sources would make this clock stop while idle, so they are
+         * refused and the current source is kept.
+         *
+         * \return The source actually in effect after the call.
+         */
+        static hr_clock_source_t set_source(const hr_clock_source_t source) noexcept
+        {
+            if (source >= CLOCK_SOURCE_THREAD_CPUTIME)
+            {
+                return ::hr_clock_get_source(); // Not steady
+            }
+
+            return ::hr_clock_set_source(source);
+        }
+
+        /**
+         * \brief Returns the process-wide source.
+         */
+        static hr_clock_source_t source() noexcept
+        {
+            return ::hr_clock_get_source();
+        }
+    };
+
+    // ============= SCOPED TIMER =============
+
+    /**
+     * \class scoped_timer
+     * \brief Times its own lifetime and records it into a histogram when destroyed.
+     *
+     * Uses ::hr_clock_record(), so concurrent timers may share one histogram.
+     */
+    class scoped_timer
+    {
+    public:
+        /**
+         * \brief Starts timing on the active source.
+         *
+         * \param hist The histogram to record into; must outlive the timer.
+         */
+        explicit scoped_timer(hr_histogram_t &hist) noexcept
+            : hist_(&hist)
+        {
+            ::hr_clock_tick_unchecked(&clock_);
+        }
+
+        /**
+         * \brief Starts timing on a specific source.
+         */
+        scoped_timer(hr_histogram_t &hist, const hr_clock_source_t source) noexcept
+            : hist_(&hist)
+        {
+            ::hr_clock_tick_ex(&clock_, source);
+        }
+
+        scoped_timer(const scoped_timer &) = delete;
+        scoped_timer &operator=(const scoped_timer &) = delete;
+
+        ~scoped_timer()
+        {
+            if (hist_ != nullptr)
+            {
+                ::hr_clock_record(&clock_, hist_);
+            }
+        }
+
+        /**
+         * \brief Time elapsed so far, without recording it.
+         */
+        hr_clock::duration elapsed() const noexcept
+        {
+            return hr_clock::duration(::get_nano_time_ex(clock_.source) - clock_.start_time);
+        }
+
+        /**
+         * \brief Records the elapsed time now instead of at destruction.
+         *
+         * \return The recorded duration, or -1 if already recorded or dismissed.
+         */
+        long long stop() noexcept
+        {
+            if (hist_ == nullptr)
+            {
+                return -1l;
+            }
+
+            const long long recorded = ::hr_clock_record(&clock_, hist_);
+            hist_ = nullptr;
+            return recorded;
+        }
+
+        /**
+         * \brief Discards the measurement; nothing is recorded.
+         */
+        void dismiss() noexcept
+        {
+            hist_ = nullptr;
+        }
+
+    private:
+        hr_histogram_t *hist_; ///< Destination, or nullptr once recorded / dismissed
+        hr_clock_t clock_;     ///< Start time and source
+    };
+}
+
+#endif //FLUENT_LIBC_CLOCK_HPP
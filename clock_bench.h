@@ -0,0 +1,494 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_BENCH_H
+#define FLUENT_LIBC_CLOCK_BENCH_H
+
+// ============= FLUENT LIB C =============
+// Micro-benchmark Harness
+// ----------------------------------------
+// Measures the per-operation cost of a function with warmup, automatic
+// iteration scaling, outlier rejection and robust statistics.
+//
+// Features:
+// - `hr_bench_run()`: Benchmark a function that runs N iterations
+// - `hr_bench_options_default()`: Sensible defaults (10 ms samples, 30 samples)
+// - Statistics: mean, median, stddev, MAD, min, max, cycles per op
+// - `hr_bench_write_json()` / `hr_bench_write_csv()`: Machine-readable results
+//
+// Example:
+// ----------------------------------------
+//   static void body(void *ctx, unsigned long long n)
+//   {
+//       for (unsigned long long i = 0; i < n; i++) { /* ... */ }
+//   }
+//
+//   hr_bench_options_t opts;
+//   hr_bench_options_default(&opts);
+//   opts.name = "my_op";
+//   hr_bench_result_t res = hr_bench_run(body, NULL, &opts);
+//   hr_bench_write_csv(stdout, &res, 1);
+//
+
+#include <math.h>
+#include <stdio.h>
+#include "clock.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES
+ * \brief Upper bound on \p hr_bench_options_t.samples.
+ */
+#ifndef FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES
+#   define FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES 256
+#endif
+
+/**
+ * \brief A benchmark body: performs the measured operation \p iterations times.
+ */
+typedef void (*hr_bench_fn_t)(void *ctx, unsigned long long iterations);
+
+/**
+ * \struct hr_bench_options_t
+ * \brief Benchmark configuration; fill it with hr_bench_options_default() first.
+ */
+typedef struct
+{
+    const char *name;                ///< Reported benchmark name
+    long long warmup_ns;             ///< Time spent running the body before measuring
+    long long target_ns;             ///< Target duration of one sample; iterations scale to it
+    int samples;                     ///< Number of samples (at most FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES)
+    int pin_cpu;                     ///< CPU to pin the benchmarking thread to, or -1
+    double outlier_mads;             ///< Reject samples further than this many MADs from the median (0 disables)
+    unsigned long long iterations;   ///< Fixed iteration count per sample, or 0 to auto-scale
+} hr_bench_options_t;
+
+/**
+ * \struct hr_bench_result_t
+ * \brief Per-operation statistics of one benchmark, in nanoseconds.
+ */
+typedef struct
+{
+    const char *name;              ///< Benchmark name, copied from the options
+    unsigned long long iterations; ///< Iterations per sample
+    int samples;                   ///< Samples kept after outlier rejection
+    int rejected;                  ///< Samples rejected as outliers
+    double mean;                   ///< Mean time per operation
+    double median;                 ///< Median time per operation
+    double stddev;                 ///< Sample standard deviation of the time per operation
+    double mad;                    ///< Median absolute deviation of the time per operation
+    double min;                    ///< Fastest sample
+    double max;                    ///< Slowest kept sample
+    double cycles_per_op;          ///< Median reference (TSC) cycles per operation of the kept samples, or 0
+    int pinned;                    ///< Non-zero if the thread was pinned as requested
+} hr_bench_result_t;
+
+/**
+ * \brief Fills \p opts with the default configuration.
+ *
+ * \param opts Pointer to the \p hr_bench_options_t to fill.
+ */
+static inline void hr_bench_options_default(hr_bench_options_t *const opts)
+{
+    if (opts == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    opts->name = "benchmark";
+    opts->warmup_ns = 100000000LL; // 100 ms
+    opts->target_ns = 10000000LL;  // 10 ms
+    opts->samples = 30;
+    opts->pin_cpu = -1;
+    opts->outlier_mads = 5.0;
+    opts->iterations = 0;
+}
+
+/**
+ * \brief Sorts a small array of doubles in place (insertion sort).
+ */
+static inline void hr_bench_sort(double *const values, const int count)
+{
+    for (int i = 1; i < count; i++)
+    {
+        const double value = values[i];
+        int j = i;
+        for (; j > 0 && values[j - 1] > value; j--)
+        {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+}
+
+/**
+ * \brief Returns the median of a sorted array.
+ */
+static inline double hr_bench_median(const double *const sorted, const int count)
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+}
+
+/**
+ * \brief Returns the median absolute deviation of a sorted array around \p median.
+ */
+static inline double hr_bench_mad(const double *const sorted, const int count, const double median)
+{
+    double deviations[FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES];
+    for (int i = 0; i < count; i++)
+    {
+        deviations[i] = fabs(sorted[i] - median);
+    }
+
+    hr_bench_sort(deviations, count);
+    return hr_bench_median(deviations, count);
+}
+
+/**
+ * \brief Reads a cycle counter for cycles-per-op reporting, or 0 if there is none.
+ */
+static inline unsigned long long hr_bench_cycles()
+{
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    return hr_clock_tscp_read();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * \brief Times one sample of \p iterations iterations.
+ *
+ * \return The elapsed monotonic time in nanoseconds.
+ */
+static inline long long hr_bench_sample(
+    const hr_bench_fn_t fn,
+    void *const ctx,
+    const unsigned long long iterations,
+    unsigned long long *const cycles
+)
+{
+    const unsigned long long cycles_start = hr_bench_cycles();
+    const long long start = hr_clock_monotonic_nanos();
+    fn(ctx, iterations);
+    const long long end = hr_clock_monotonic_nanos();
+    *cycles = hr_bench_cycles() - cycles_start;
+    return end - start;
+}
+
+/**
+ * \brief Benchmarks \p fn and returns per-operation statistics.
+ *
+ * The body is first run for \p warmup_ns while the iteration count is scaled
+ * so one sample takes about \p target_ns. Then \p samples samples are timed
+ * with the OS monotonic clock; samples further than \p outlier_mads MADs from
+ * the median are discarded before computing the statistics. With \p pin_cpu
+ * set the thread runs pinned, then gets its previous affinity mask back.
+ *
+ * \param fn The benchmark body.
+ * \param ctx Opaque pointer passed to \p fn.
+ * \param opts The configuration, or NULL for the defaults.
+ * \return The statistics; \p samples is 0 if \p fn is NULL.
+ */
+static inline hr_bench_result_t hr_bench_run(const hr_bench_fn_t fn, void *const ctx, const hr_bench_options_t *opts)
+{
+    hr_bench_options_t defaults;
+    hr_bench_options_default(&defaults);
+    if (opts == NULL)
+    {
+        opts = &defaults;
+    }
+
+    hr_bench_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.name = opts->name;
+    if (fn == NULL)
+    {
+        return result; // Handle null pointer
+    }
+
+    hr_clock_init();
+    hr_cpu_set_t affinity;
+    const int restore = opts->pin_cpu >= 0 && hr_thread_get_affinity(&affinity);
+    result.pinned = opts->pin_cpu >= 0 && hr_thread_pin_cpu(opts->pin_cpu);
+
+    const int samples = opts->samples < 1
+        ? 1
+        : (opts->samples > FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES ? FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES : opts->samples);
+    const long long target = opts->target_ns > 0 ? opts->target_ns : 1;
+
+    // Warmup doubles as iteration scaling
+    unsigned long long iterations = opts->iterations ? opts->iterations : 1;
+    unsigned long long cycles = 0;
+    long long elapsed = 0;
+    int rounds = 0;
+    const long long warmup_end = hr_clock_monotonic_nanos() + opts->warmup_ns;
+    do
+    {
+        elapsed = hr_bench_sample(fn, ctx, iterations, &cycles);
+        rounds++;
+        if (opts->iterations == 0 && elapsed < target)
+        {
+            // Grow towards the target, at most 100x per step to stay robust to noise
+            const double ratio = elapsed > 0 ? (double)target / (double)elapsed : 100.0;
+            const double grown = (double)iterations * (ratio > 100.0 ? 100.0 : ratio * 1.1);
+            iterations = grown > (double)iterations ? (unsigned long long)grown : iterations + 1;
+        }
+    } while (
+        rounds < 2 // The first run may pay one-time costs such as lazy TSC calibration
+        || hr_clock_monotonic_nanos() < warmup_end
+        || (opts->iterations == 0 && elapsed < target / 2)
+    );
+
+    double per_op[FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES];
+    double times[FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES]; // Unsorted, paired with cycles_per_op
+    double cycles_per_op[FLUENT_LIBC_CLOCK_BENCH_MAX_SAMPLES];
+    for (int i = 0; i < samples; i++)
+    {
+        times[i] = (double)hr_bench_sample(fn, ctx, iterations, &cycles) / (double)iterations;
+        per_op[i] = times[i];
+        cycles_per_op[i] = (double)cycles / (double)iterations;
+    }
+
+    if (restore)
+    {
+        hr_thread_set_affinity(&affinity); // Back to the caller's mask (taskset, cpuset)
+    }
+    else if (result.pinned)
+    {
+        hr_thread_unpin(); // Best effort without a saved mask
+    }
+
+    hr_bench_sort(per_op, samples);
+    const double median = hr_bench_median(per_op, samples);
+    const double mad = hr_bench_mad(per_op, samples, median);
+
+    // Drop outliers (per_op stays sorted, so kept samples are contiguous)
+    int first = 0, last = samples;
+    if (opts->outlier_mads > 0.0 && mad > 0.0)
+    {
+        while (first < last && median - per_op[first] > opts->outlier_mads * mad)
+        {
+            first++;
+        }
+
+        while (last > first && per_op[last - 1] - median > opts->outlier_mads * mad)
+        {
+            last--;
+        }
+    }
+
+    const int kept = last - first;
+
+    // Cycles of the kept samples only, so both columns describe the same population
+    int kept_cycles = 0;
+    for (int i = 0; i < samples; i++)
+    {
+        if (times[i] >= per_op[first] && times[i] <= per_op[last - 1])
+        {
+            cycles_per_op[kept_cycles++] = cycles_per_op[i];
+        }
+    }
+    hr_bench_sort(cycles_per_op, kept_cycles);
+
+    double sum = 0.0;
+    for (int i = first; i < last; i++)
+    {
+        sum += per_op[i];
+    }
+
+    const double mean = sum / kept;
+    double squares = 0.0;
+    for (int i = first; i < last; i++)
+    {
+        squares += (per_op[i] - mean) * (per_op[i] - mean);
+    }
+
+    result.iterations = iterations;
+    result.samples = kept;
+    result.rejected = samples - kept;
+    result.mean = mean;
+    result.median = hr_bench_median(per_op + first, kept);
+    result.stddev = kept > 1 ? sqrt(squares / (kept - 1)) : 0.0;
+    result.mad = hr_bench_mad(per_op + first, kept, result.median);
+    result.min = per_op[first];
+    result.max = per_op[last - 1];
+    result.cycles_per_op = hr_bench_median(cycles_per_op, kept_cycles);
+    return result;
+}
+
+/**
+ * \brief Writes a string as a JSON string literal, escaping quotes, backslashes and control characters.
+ */
+static inline void hr_bench_write_json_string(FILE *const out, const char *const text)
+{
+    fputc('"', out);
+    for (const unsigned char *c = (const unsigned char *)text; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fputc('\\', out);
+            fputc(*c, out);
+        }
+        else if (*c < 0x20)
+        {
+            fprintf(out, "\\u%04x", *c);
+        }
+        else
+        {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+/**
+ * \brief Writes a string as a quoted CSV field, doubling embedded quotes.
+ */
+static inline void hr_bench_write_csv_string(FILE *const out, const char *const text)
+{
+    fputc('"', out);
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        if (*c == '"')
+        {
+            fputc('"', out);
+        }
+        fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+/**
+ * \brief Writes results as a JSON array of objects.
+ *
+ * \param out The stream to write to.
+ * \param results The results to write.
+ * \param count The number of results.
+ */
+static inline void hr_bench_write_json(FILE *const out, const hr_bench_result_t *const results, const size_t count)
+{
+    if (out == NULL || (results == NULL && count != 0))
+    {
+        return; // Handle null pointers
+    }
+
+    fputs("[", out);
+    for (size_t i = 0; i < count; i++)
+    {
+        const hr_bench_result_t *const r = &results[i];
+        fputs(i == 0 ? "\n  {\"name\":" : ",\n  {\"name\":", out);
+        hr_bench_write_json_string(out, r->name != NULL ? r->name : "");
+        fprintf(
+            out,
+            ",\"iterations\":%llu,\"samples\":%d,\"rejected\":%d,"
+            "\"mean_ns\":%.4f,\"median_ns\":%.4f,\"stddev_ns\":%.4f,\"mad_ns\":%.4f,"
+            "\"min_ns\":%.4f,\"max_ns\":%.4f,\"cycles_per_op\":%.4f,\"pinned\":%s}",
+            r->iterations,
+            r->samples,
+            r->rejected,
+            r->mean,
+            r->median,
+            r->stddev,
+            r->mad,
+            r->min,
+            r->max,
+            r->cycles_per_op,
+            r->pinned ? "true" : "false"
+        );
+    }
+    fputs("\n]\n", out);
+}
+
+/**
+ * \brief Writes results as CSV with a header row.
+ *
+ * \param out The stream to write to.
+ * \param results The results to write.
+ * \param count The number of results.
+ */
+static inline void hr_bench_write_csv(FILE *const out, const hr_bench_result_t *const results, const size_t count)
+{
+    if (out == NULL || (results == NULL && count != 0))
+    {
+        return; // Handle null pointers
+    }
+
+    fputs("name,iterations,samples,rejected,mean_ns,median_ns,stddev_ns,mad_ns,min_ns,max_ns,cycles_per_op,pinned\n", out);
+    for (size_t i = 0; i < count; i++)
+    {
+        const hr_bench_result_t *const r = &results[i];
+        hr_bench_write_csv_string(out, r->name != NULL ? r->name : "");
+        fprintf(
+            out,
+            ",%llu,%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%d\n",
+            r->iterations,
+            r->samples,
+            r->rejected,
+            r->mean,
+            r->median,
+            r->stddev,
+            r->mad,
+            r->min,
+            r->max,
+            r->cycles_per_op,
+            r->pinned
+        );
+    }
+}
+
+/**
+ * \brief Writes results as an aligned, human-readable table.
+ *
+ * \param out The stream to write to.
+ * \param results The results to write.
+ * \param count The number of results.
+ */
+static inline void hr_bench_write_table(FILE *const out, const hr_bench_result_t *const results, const size_t count)
+{
+    if (out == NULL || (results == NULL && count != 0))
+    {
+        return; // Handle null pointers
+    }
+
+    fprintf(out, "%-36s %12s %10s %10s %10s %10s\n", "benchmark", "iterations", "median ns", "mad ns", "mean ns", "cycles");
+    for (size_t i = 0; i < count; i++)
+    {
+        const hr_bench_result_t *const r = &results[i];
+        fprintf(
+            out,
+            "%-36s %12llu %10.3f %10.3f %10.3f %10.2f\n",
+            r->name != NULL ? r->name : "",
+            r->iterations,
+            r->median,
+            r->mad,
+            r->mean,
+            r->cycles_per_op
+        );
+    }
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_BENCH_H
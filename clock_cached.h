@@ -0,0 +1,174 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_CACHED_H
+#define FLUENT_LIBC_CLOCK_CACHED_H
+
+// ============= FLUENT LIB C =============
+// Cached "Now" Timestamp
+// ----------------------------------------
+// A background ticker thread publishes `get_nano_time()` at a fixed interval,
+// so call sites that only need ~millisecond accuracy (log timestamps, TTL
+// checks) read it with a single shared cache-line load instead of a clock call.
+//
+// Features:
+// - `hr_clock_cached_start()` / `hr_clock_cached_stop()`: Ticker lifecycle
+// - `hr_clock_cached_now()`: Latest published timestamp (falls back to `get_nano_time()`)
+// - `hr_clock_cached_set_interval()`: Change the refresh interval while running
+//
+// Example:
+// ----------------------------------------
+//   hr_clock_cached_start(0); // Default 1 ms interval
+//   if (hr_clock_cached_now() > entry->expires_at) { ... }
+//   hr_clock_cached_stop();
+//
+
+#include "clock.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_CACHED_INTERVAL_NS
+ * \brief Default refresh interval of the ticker thread (1 ms).
+ */
+#ifndef FLUENT_LIBC_CLOCK_CACHED_INTERVAL_NS
+#   define FLUENT_LIBC_CLOCK_CACHED_INTERVAL_NS 1000000LL
+#endif
+
+/**
+ * \struct hr_clock_cached_state_t
+ * \brief Process-wide ticker state; the timestamp has a cache line to itself.
+ */
+typedef struct
+{
+    volatile unsigned long long now;      ///< Last published get_nano_time(), 0 while stopped
+    char now_pad[64 - sizeof(unsigned long long)];
+    volatile unsigned long long interval; ///< Refresh interval in nanoseconds
+    volatile int lifecycle;               ///< 0 stopped, 1 starting / stopping, 2 running
+    volatile int running;                 ///< Non-zero while the ticker should keep going
+    hr_thread_t ticker;                   ///< Background ticker thread
+} hr_clock_cached_state_t;
+
+FLUENT_LIBC_CLOCK_GLOBAL hr_clock_cached_state_t hr_clock_cached_state = FLUENT_LIBC_CLOCK_ZERO_INIT;
+
+/**
+ * \brief Publishes get_nano_time() every interval until hr_clock_cached_stop().
+ */
+static inline void hr_clock_cached_ticker_main(void *const arg)
+{
+    (void)arg;
+    while (hr_atomic_load_int(&hr_clock_cached_state.running))
+    {
+        hr_atomic_store_u64(&hr_clock_cached_state.now, (unsigned long long)get_nano_time());
+        hr_thread_sleep_nanos((long long)hr_atomic_load_u64_relaxed(&hr_clock_cached_state.interval));
+    }
+}
+
+/**
+ * \brief Sets the ticker's refresh interval; takes effect after the current sleep.
+ *
+ * \param interval_ns The interval in nanoseconds, or 0 for FLUENT_LIBC_CLOCK_CACHED_INTERVAL_NS.
+ */
+static inline void hr_clock_cached_set_interval(const long long interval_ns)
+{
+    const long long interval = interval_ns > 0 ? interval_ns : FLUENT_LIBC_CLOCK_CACHED_INTERVAL_NS;
+    hr_atomic_store_u64_relaxed(&hr_clock_cached_state.interval, (unsigned long long)interval);
+}
+
+/**
+ * \brief Starts the ticker thread.
+ *
+ * A timestamp is published before this returns, so hr_clock_cached_now()
+ * serves cached values right away. Starting a running ticker only updates
+ * its interval.
+ *
+ * \param interval_ns The refresh interval in nanoseconds, or 0 for FLUENT_LIBC_CLOCK_CACHED_INTERVAL_NS.
+ * \return Non-zero if the ticker is running, 0 if the thread could not be created.
+ */
+static inline int hr_clock_cached_start(const long long interval_ns)
+{
+    hr_clock_cached_set_interval(interval_ns);
+    if (!hr_atomic_cas_int(&hr_clock_cached_state.lifecycle, 0, 1))
+    {
+        // Running, or another thread is starting / stopping it
+        while (hr_atomic_load_int(&hr_clock_cached_state.lifecycle) == 1)
+        {
+            hr_thread_yield();
+        }
+        return hr_atomic_load_int(&hr_clock_cached_state.lifecycle) == 2;
+    }
+
+    hr_clock_init();
+    hr_atomic_store_u64(&hr_clock_cached_state.now, (unsigned long long)get_nano_time());
+    hr_atomic_store_int(&hr_clock_cached_state.running, 1);
+    if (!hr_thread_create(&hr_clock_cached_state.ticker, hr_clock_cached_ticker_main, NULL))
+    {
+        hr_atomic_store_int(&hr_clock_cached_state.running, 0);
+        hr_atomic_store_u64(&hr_clock_cached_state.now, 0);
+        hr_atomic_store_int(&hr_clock_cached_state.lifecycle, 0);
+        return 0;
+    }
+
+    hr_atomic_store_int(&hr_clock_cached_state.lifecycle, 2);
+    return 1;
+}
+
+/**
+ * \brief Stops the ticker thread and waits for it, at most one interval.
+ *
+ * Afterwards hr_clock_cached_now() reads the clock directly again.
+ */
+static inline void hr_clock_cached_stop()
+{
+    if (!hr_atomic_cas_int(&hr_clock_cached_state.lifecycle, 2, 1))
+    {
+        return; // Not running
+    }
+
+    hr_atomic_store_int(&hr_clock_cached_state.running, 0);
+    hr_thread_join(&hr_clock_cached_state.ticker);
+    hr_atomic_store_u64(&hr_clock_cached_state.now, 0);
+    hr_atomic_store_int(&hr_clock_cached_state.lifecycle, 0);
+}
+
+/**
+ * \brief Returns non-zero while the ticker thread is running.
+ */
+static inline int hr_clock_cached_is_running()
+{
+    return hr_atomic_load_int(&hr_clock_cached_state.lifecycle) == 2;
+}
+
+/**
+ * \brief Returns the most recently published timestamp.
+ *
+ * The value lags get_nano_time() by up to one interval plus the ticker's
+ * scheduling delay, and never goes backwards while the ticker runs. While it
+ * is stopped this falls back to get_nano_time(), so callers need not care.
+ *
+ * \return A get_nano_time() value in nanoseconds.
+ */
+static inline long long hr_clock_cached_now()
+{
+    const unsigned long long now = hr_atomic_load_u64_relaxed(&hr_clock_cached_state.now);
+    return now != 0 ? (long long)now : get_nano_time();
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_CACHED_H
@@ -0,0 +1,311 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_CORO_HPP
+#define FLUENT_LIBC_CLOCK_CORO_HPP
+
+// ============= FLUENT LIB C++ =============
+// Coroutine Timer Awaitables
+// ----------------------------------------
+// C++20 awaitables over clock_timer_loop.h: every suspended `co_await` is a
+// node in the thread's timer wheel, and the whole thread shares one kernel
+// timer, so hundreds of thousands of pending waits cost no syscalls each.
+//
+// Features:
+// - `fluent::timer_loop`: RAII owner of a thread's hr_timer_loop_t
+// - `fluent::hr_after(value, unit)`: `co_await` a relative delay
+// - `fluent::hr_at(deadline)`: `co_await` an absolute get_nano_time() deadline
+//
+// Coroutines resume on the loop's thread from timer_loop::dispatch() (or
+// wait()). Destroying a suspended coroutine cancels its timer; destroying the
+// loop first detaches its waiters, which are then never resumed but can still
+// be destroyed safely. Awaiting on a thread without a timer_loop, or when the
+// wheel's pool is exhausted, falls back to a blocking hr_sleep_until().
+//
+// Example:
+// ----------------------------------------
+//   task handle(connection &conn)
+//   {
+//       co_await fluent::hr_after(5, CLOCK_MILLISECONDS);
+//       conn.flush();
+//   }
+//
+//   fluent::timer_loop loop(1u << 20); // This thread's loop
+//   handle(conn);
+//   while (loop.wait() >= 0) { }
+//
+
+#include <cstddef>
+#include "clock.h"
+#include "clock_duration.h"
+#include "clock_sleep.h"
+#include "clock_timer_loop.h"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#   if __has_include(<coroutine>)
+#       include <coroutine>
+#       define FLUENT_LIBC_CLOCK_HAS_COROUTINES 1
+#   endif
+#endif
+
+#if defined(FLUENT_LIBC_CLOCK_HAS_COROUTINES)
+namespace fluent
+{
+    class timer_awaitable;
+
+    // ============= TIMER LOOP =============
+
+    /**
+     * \class timer_loop
+     * \brief A thread's timer loop; while alive it is the target of hr_after() / hr_at() on that thread.
+     *
+     * Loops nest: constructing a second one on the same thread makes it
+     * current until it is destroyed. Destroying a loop detaches the
+     * coroutines still waiting on it; they are never resumed.
+     */
+    class timer_loop
+    {
+    public:
+        /**
+         * \brief Creates the loop and makes it current for the calling thread.
+         *
+         * \param capacity Maximum number of pending waits.
+         * \param tick_ns Wheel tick in nanoseconds, or 0 for the default (1 ms).
+         */
+        explicit timer_loop(const unsigned int capacity = 1u << 16, const long long tick_ns = 0) noexcept
+            : valid_(::hr_timer_loop_init(&loop_, capacity, tick_ns) != 0), previous_(current_slot()), waiters_(nullptr)
+        {
+            current_slot() = this;
+        }
+
+        timer_loop(const timer_loop &) = delete;
+        timer_loop &operator=(const timer_loop &) = delete;
+
+        ~timer_loop();
+
+        /**
+         * \brief Whether the wheel could be allocated.
+         */
+        bool valid() const noexcept
+        {
+            return valid_;
+        }
+
+        /**
+         * \brief The descriptor to watch for readability, or -1; see ::hr_timer_loop_fd().
+         */
+        int fd() const noexcept
+        {
+            return ::hr_timer_loop_fd(&loop_);
+        }
+
+        /**
+         * \brief Resumes every coroutine whose wait is over; see ::hr_timer_loop_dispatch().
+         */
+        std::size_t dispatch() noexcept
+        {
+            return valid_ ? ::hr_timer_loop_dispatch(&loop_) : 0;
+        }
+
+        /**
+         * \brief Blocks until the next wait is over, then dispatches; see ::hr_timer_loop_wait().
+         *
+         * \return The number of coroutines resumed, or -1 if none is waiting.
+         */
+        long long wait() noexcept
+        {
+            return valid_ ? ::hr_timer_loop_wait(&loop_) : -1;
+        }
+
+        /**
+         * \brief Number of pending waits.
+         */
+        unsigned int pending() const noexcept
+        {
+            return valid_ ? ::hr_timer_wheel_active(&loop_.wheel) : 0;
+        }
+
+        /**
+         * \brief The underlying C loop.
+         */
+        hr_timer_loop_t *native() noexcept
+        {
+            return valid_ ? &loop_ : nullptr;
+        }
+
+        /**
+         * \brief The calling thread's current loop, or nullptr.
+         */
+        static timer_loop *current() noexcept
+        {
+            return current_slot();
+        }
+
+    private:
+        friend class timer_awaitable;
+
+        static timer_loop *&current_slot() noexcept
+        {
+            static thread_local timer_loop *slot = nullptr;
+            return slot;
+        }
+
+        hr_timer_loop_t loop_;     ///< Wheel and kernel timer
+        bool valid_;               ///< Whether loop_ was initialized
+        timer_loop *previous_;     ///< Loop that was current before this one
+        timer_awaitable *waiters_; ///< Suspended awaitables, detached on destruction
+    };
+
+    // ============= AWAITABLES =============
+
+    /**
+     * \class timer_awaitable
+     * \brief Suspends the awaiting coroutine until an absolute deadline.
+     */
+    class timer_awaitable
+    {
+    public:
+        /**
+         * \brief Waits until \p deadline (get_nano_time() timeline) on \p loop.
+         *
+         * \param deadline The absolute deadline in nanoseconds.
+         * \param loop The loop to wait on; nullptr means a blocking sleep.
+         */
+        timer_awaitable(const long long deadline, timer_loop *const loop) noexcept
+            : deadline_(deadline), loop_(loop != nullptr && loop->valid() ? loop : nullptr), id_(0),
+              prev_(nullptr), next_(nullptr)
+        {
+        }
+
+        timer_awaitable(const timer_awaitable &) = delete;
+        timer_awaitable &operator=(const timer_awaitable &) = delete;
+
+        ~timer_awaitable()
+        {
+            if (id_ != 0)
+            {
+                ::hr_timer_loop_cancel(&loop_->loop_, id_); // Coroutine destroyed while suspended
+                unlink();
+            }
+        }
+
+        bool await_ready() const noexcept
+        {
+            return ::get_nano_time() >= deadline_;
+        }
+
+        bool await_suspend(const std::coroutine_handle<> handle) noexcept
+        {
+            if (loop_ != nullptr)
+            {
+                handle_ = handle;
+                id_ = ::hr_timer_loop_add(&loop_->loop_, deadline_, &timer_awaitable::fire, this);
+            }
+
+            if (id_ == 0)
+            {
+                ::hr_sleep_until(deadline_); // No loop on this thread, or pool exhausted
+                return false;
+            }
+
+            next_ = loop_->waiters_;
+            if (next_ != nullptr)
+            {
+                next_->prev_ = this;
+            }
+            loop_->waiters_ = this;
+            return true;
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+    private:
+        friend class timer_loop;
+
+        static void fire(void *const arg, hr_timer_id_t, long long)
+        {
+            timer_awaitable *const self = static_cast<timer_awaitable *>(arg);
+            self->id_ = 0;
+            self->unlink();
+            self->handle_.resume();
+        }
+
+        void unlink() noexcept
+        {
+            if (prev_ != nullptr)
+            {
+                prev_->next_ = next_;
+            }
+            else
+            {
+                loop_->waiters_ = next_;
+            }
+
+            if (next_ != nullptr)
+            {
+                next_->prev_ = prev_;
+            }
+            prev_ = next_ = nullptr;
+        }
+
+        long long deadline_;              ///< Absolute deadline in nanoseconds
+        timer_loop *loop_;                ///< Loop holding the timer, or nullptr
+        hr_timer_id_t id_;                ///< Pending timer, 0 once fired, never added or detached
+        timer_awaitable *prev_;           ///< Previous waiter on loop_
+        timer_awaitable *next_;           ///< Next waiter on loop_
+        std::coroutine_handle<> handle_;  ///< Coroutine to resume
+    };
+
+    inline timer_loop::~timer_loop()
+    {
+        current_slot() = previous_;
+        for (timer_awaitable *waiter = waiters_; waiter != nullptr;)
+        {
+            timer_awaitable *const next = waiter->next_;
+            waiter->id_ = 0; // The wheel and its timers go away with the loop
+            waiter->prev_ = waiter->next_ = nullptr;
+            waiter = next;
+        }
+
+        if (valid_)
+        {
+            ::hr_timer_loop_destroy(&loop_);
+        }
+    }
+
+    /**
+     * \brief Awaitable that resumes once \p deadline (get_nano_time() timeline) has passed.
+     */
+    inline timer_awaitable hr_at(const long long deadline) noexcept
+    {
+        return timer_awaitable(deadline, timer_loop::current());
+    }
+
+    /**
+     * \brief Awaitable that resumes after \p value \p unit.
+     *
+     * An invalid unit does not suspend; a delay too large for nanoseconds saturates.
+     */
+    inline timer_awaitable hr_after(const long long value, const hr_clock_time_unit_t unit) noexcept
+    {
+        hr_duration_t delay;
+        if (::hr_duration_from_unit(value, unit, &delay) == HR_CLOCK_ERROR_UNIT)
+        {
+            return timer_awaitable(0, nullptr);
+        }
+
+        return timer_awaitable(::hr_sat_add_i64(::get_nano_time(), delay.nanos), timer_loop::current());
+    }
+}
+#endif // FLUENT_LIBC_CLOCK_HAS_COROUTINES
+
+#endif //FLUENT_LIBC_CLOCK_CORO_HPP
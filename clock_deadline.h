@@ -0,0 +1,411 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_DEADLINE_H
+#define FLUENT_LIBC_CLOCK_DEADLINE_H
+
+// ============= FLUENT LIB C =============
+// Deadline Propagation
+// ----------------------------------------
+// An absolute deadline that travels through request pipeline stages, with
+// sub-deadlines carved out for nested calls and an amortized expiry test
+// for tight loops.
+//
+// Features:
+// - `hr_deadline_in()` / `hr_deadline_at()` / `hr_deadline_never()`: Create a deadline
+// - `hr_deadline_remaining()` / `hr_deadline_expired()`: Exact checks (one clock read)
+// - `hr_deadline_child()`: A fraction of the remaining budget for a sub-call
+// - `hr_deadline_child_in()`: A fixed budget, never past the parent
+// - `hr_deadline_poll()`: Amortized check reading the clock only every N calls
+//
+// `hr_deadline_poll()` adapts N: after each clock read it measures how long
+// the last N calls took and picks the next N so that roughly `granularity`
+// nanoseconds (and never more than half the remaining time) pass between
+// reads. The clock it reads is configurable: the precise source, the coarse
+// monotonic clock or the cached ticker timestamp (`clock_cached.h`); the
+// cheaper ones may notice expiry later by up to their resolution.
+//
+// Example:
+// ----------------------------------------
+//   hr_deadline_t request = hr_deadline_in(50, CLOCK_MILLISECONDS);
+//   hr_deadline_t parse = hr_deadline_child(&request, 0.2); // 20% of what is left
+//   while (parser_next(&p))
+//   {
+//       if (hr_deadline_poll(&parse)) return TIMEOUT;
+//   }
+//   long long left_us = hr_deadline_remaining(&request, CLOCK_MICROSECONDS);
+//
+
+#include "clock.h"
+#include "clock_cached.h"
+#include "clock_duration.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def HR_DEADLINE_NEVER
+ * \brief Deadline value that never expires.
+ */
+#define HR_DEADLINE_NEVER HR_DURATION_NANOS_MAX
+
+/**
+ * \def FLUENT_LIBC_CLOCK_DEADLINE_GRANULARITY_NS
+ * \brief Default target time between two clock reads of hr_deadline_poll() (100 us).
+ */
+#ifndef FLUENT_LIBC_CLOCK_DEADLINE_GRANULARITY_NS
+#   define FLUENT_LIBC_CLOCK_DEADLINE_GRANULARITY_NS 100000LL
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_DEADLINE_MAX_STRIDE
+ * \brief Upper bound on the number of hr_deadline_poll() calls between clock reads.
+ */
+#ifndef FLUENT_LIBC_CLOCK_DEADLINE_MAX_STRIDE
+#   define FLUENT_LIBC_CLOCK_DEADLINE_MAX_STRIDE 65536u
+#endif
+
+/**
+ * \enum hr_deadline_clock_t
+ * \brief Clock read by hr_deadline_poll().
+ */
+typedef enum
+{
+    HR_DEADLINE_CLOCK_PRECISE = 0, ///< get_nano_time()
+    HR_DEADLINE_CLOCK_COARSE,      ///< CLOCK_SOURCE_MONOTONIC_COARSE (late by up to a scheduler tick)
+    HR_DEADLINE_CLOCK_CACHED,      ///< hr_clock_cached_now() (late by up to the ticker interval)
+} hr_deadline_clock_t;
+
+/**
+ * \struct hr_deadline_t
+ * \brief An absolute deadline plus the state of its amortized check.
+ *
+ * Pass it by value or pointer between stages; the poll state belongs to
+ * whoever polls it, so give each thread its own copy.
+ */
+typedef struct
+{
+    long long at;           ///< Deadline on the get_nano_time() timeline, or HR_DEADLINE_NEVER
+    long long last;         ///< Clock reading at the previous poll read (0 before the first)
+    long long granularity;  ///< Target time between poll reads, in nanoseconds
+    unsigned int stride;    ///< Calls between poll reads
+    unsigned int countdown; ///< Calls left until the next poll read
+    int clock;              ///< \p hr_deadline_clock_t used by hr_deadline_poll()
+    int expired;            ///< Non-zero once expiry has been observed (sticky)
+} hr_deadline_t;
+
+/**
+ * \brief Creates a deadline at an absolute time.
+ *
+ * Polls read the cached clock with the default granularity; see hr_deadline_set_poll().
+ *
+ * \param at The deadline on the get_nano_time() timeline, or HR_DEADLINE_NEVER.
+ */
+static inline hr_deadline_t hr_deadline_at(const long long at)
+{
+    hr_deadline_t deadline;
+    deadline.at = at;
+    deadline.last = 0;
+    deadline.granularity = FLUENT_LIBC_CLOCK_DEADLINE_GRANULARITY_NS;
+    deadline.stride = 1;
+    deadline.countdown = 1;
+    deadline.clock = HR_DEADLINE_CLOCK_CACHED;
+    deadline.expired = 0;
+    return deadline;
+}
+
+/**
+ * \brief Creates a deadline that never expires.
+ */
+static inline hr_deadline_t hr_deadline_never()
+{
+    return hr_deadline_at(HR_DEADLINE_NEVER);
+}
+
+/**
+ * \brief Creates a deadline \p budget \p unit from now.
+ *
+ * Budgets too large to represent saturate to HR_DEADLINE_NEVER; an invalid
+ * unit yields a deadline that has already expired.
+ *
+ * \param budget The time allowed, in \p unit.
+ * \param unit The unit of \p budget.
+ */
+static inline hr_deadline_t hr_deadline_in(const long long budget, const hr_clock_time_unit_t unit)
+{
+    hr_duration_t duration = {0};
+    if (hr_duration_from_unit(budget, unit, &duration) == HR_CLOCK_ERROR_UNIT)
+    {
+        hr_deadline_t deadline = hr_deadline_at(0);
+        deadline.expired = 1;
+        return deadline;
+    }
+
+    return hr_deadline_at(hr_sat_add_i64(get_nano_time(), duration.nanos));
+}
+
+/**
+ * \brief Chooses the clock and the granularity used by hr_deadline_poll().
+ *
+ * \param deadline Pointer to the \p hr_deadline_t to configure.
+ * \param clock The \p hr_deadline_clock_t to read.
+ * \param granularity_ns Target time between clock reads, or 0 for the default.
+ */
+static inline void hr_deadline_set_poll(
+    hr_deadline_t *const deadline,
+    const hr_deadline_clock_t clock,
+    const long long granularity_ns
+)
+{
+    if (deadline == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    deadline->clock = clock;
+    deadline->granularity = granularity_ns > 0 ? granularity_ns : FLUENT_LIBC_CLOCK_DEADLINE_GRANULARITY_NS;
+    deadline->stride = 1;
+    deadline->countdown = 1;
+}
+
+/**
+ * \brief Returns whether the deadline has passed at \p now, without reading a clock.
+ */
+static inline int hr_deadline_expired_at(hr_deadline_t *const deadline, const long long now)
+{
+    if (deadline == NULL)
+    {
+        return 1; // Handle null pointer
+    }
+
+    if (!deadline->expired && now >= deadline->at)
+    {
+        deadline->expired = 1;
+    }
+
+    return deadline->expired;
+}
+
+/**
+ * \brief Returns whether the deadline has passed (one get_nano_time() read).
+ *
+ * \param deadline Pointer to the \p hr_deadline_t to test.
+ * \return Non-zero if expired; a NULL pointer counts as expired.
+ */
+static inline int hr_deadline_expired(hr_deadline_t *const deadline)
+{
+    if (deadline == NULL)
+    {
+        return 1; // Handle null pointer
+    }
+
+    return deadline->expired || (deadline->at != HR_DEADLINE_NEVER && hr_deadline_expired_at(deadline, get_nano_time()));
+}
+
+/**
+ * \brief Time left until the deadline (one get_nano_time() read).
+ *
+ * \param deadline Pointer to the \p hr_deadline_t to read.
+ * \param unit The unit of the result, truncated toward zero.
+ * \return The remaining time, 0 if expired, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_deadline_remaining(hr_deadline_t *const deadline, const hr_clock_time_unit_t unit)
+{
+    if (deadline == NULL || (unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1l; // Handle null pointer or invalid unit
+    }
+
+    if (deadline->at == HR_DEADLINE_NEVER)
+    {
+        return clock_nanos_to_unit_unchecked(HR_DEADLINE_NEVER, unit);
+    }
+
+    const long long now = get_nano_time();
+    if (hr_deadline_expired_at(deadline, now))
+    {
+        return 0;
+    }
+
+    return clock_nanos_to_unit_unchecked(deadline->at - now, unit);
+}
+
+/**
+ * \brief Derives a deadline for a sub-call from a fraction of the parent's remaining time.
+ *
+ * The child inherits the parent's poll settings and never ends after the
+ * parent. A parent that never expires yields a child that never expires.
+ *
+ * \param parent Pointer to the \p hr_deadline_t to carve the budget from.
+ * \param fraction Share of the remaining time, clamped to [0, 1].
+ * \return The child deadline; expired if \p parent is NULL or expired.
+ */
+static inline hr_deadline_t hr_deadline_child(const hr_deadline_t *const parent, const double fraction)
+{
+    if (parent == NULL || parent->expired)
+    {
+        hr_deadline_t child = hr_deadline_at(0);
+        child.expired = 1;
+        return child; // Handle null pointer or expired parent
+    }
+
+    hr_deadline_t child = *parent;
+    child.last = 0;
+    child.stride = 1;
+    child.countdown = 1;
+    if (parent->at == HR_DEADLINE_NEVER)
+    {
+        return child;
+    }
+
+    const long long now = get_nano_time();
+    const long long remaining = parent->at - now;
+    if (remaining <= 0)
+    {
+        child.expired = 1;
+        return child;
+    }
+
+    const double share = fraction < 0.0 ? 0.0 : fraction > 1.0 ? 1.0 : fraction;
+    child.at = now + (long long)((double)remaining * share);
+    if (child.at > parent->at)
+    {
+        child.at = parent->at; // Rounding
+    }
+
+    return child;
+}
+
+/**
+ * \brief Derives a deadline \p budget \p unit from now, capped at the parent's deadline.
+ *
+ * \param parent Pointer to the \p hr_deadline_t bounding the child.
+ * \param budget The time allowed, in \p unit.
+ * \param unit The unit of \p budget.
+ * \return The child deadline; expired if \p parent is NULL or expired, or the unit is invalid.
+ */
+static inline hr_deadline_t hr_deadline_child_in(
+    const hr_deadline_t *const parent,
+    const long long budget,
+    const hr_clock_time_unit_t unit
+)
+{
+    if (parent == NULL || parent->expired)
+    {
+        hr_deadline_t child = hr_deadline_at(0);
+        child.expired = 1;
+        return child; // Handle null pointer or expired parent
+    }
+
+    const hr_deadline_t own = hr_deadline_in(budget, unit);
+    hr_deadline_t child = *parent;
+    child.last = 0;
+    child.stride = 1;
+    child.countdown = 1;
+    if (own.expired)
+    {
+        child.expired = 1; // Invalid unit
+    }
+    else if (own.at < child.at)
+    {
+        child.at = own.at;
+    }
+
+    return child;
+}
+
+/**
+ * \brief Reads the clock selected for hr_deadline_poll().
+ */
+static inline long long hr_deadline_poll_now(const hr_deadline_t *const deadline)
+{
+    switch (deadline->clock)
+    {
+        case HR_DEADLINE_CLOCK_COARSE:
+            return get_nano_time_ex(CLOCK_SOURCE_MONOTONIC_COARSE);
+        case HR_DEADLINE_CLOCK_CACHED:
+            return hr_clock_cached_now();
+        default:
+            return get_nano_time();
+    }
+}
+
+/**
+ * \brief Amortized expiry test for tight loops.
+ *
+ * Most calls only decrement a counter; every \p stride calls the configured
+ * clock is read and the stride is re-fitted to the observed call rate
+ * (growing at most 2x per read, shrinking immediately). Expiry is sticky.
+ *
+ * \param deadline Pointer to the \p hr_deadline_t to test.
+ * \return Non-zero once the deadline is known to have passed; a NULL pointer counts as expired.
+ */
+static inline int hr_deadline_poll(hr_deadline_t *const deadline)
+{
+    if (deadline == NULL)
+    {
+        return 1; // Handle null pointer
+    }
+
+    if (deadline->expired)
+    {
+        return 1;
+    }
+
+    if (--deadline->countdown != 0)
+    {
+        return 0;
+    }
+
+    if (deadline->at == HR_DEADLINE_NEVER)
+    {
+        deadline->countdown = FLUENT_LIBC_CLOCK_DEADLINE_MAX_STRIDE;
+        return 0;
+    }
+
+    const long long now = hr_deadline_poll_now(deadline);
+    if (hr_deadline_expired_at(deadline, now))
+    {
+        return 1;
+    }
+
+    // Time budget until the next read: the granularity, but at most half of what is left
+    const long long half = (deadline->at - now) / 2;
+    unsigned long long target = (unsigned long long)(deadline->granularity < half ? deadline->granularity : half);
+    if (target > (1ULL << 40))
+    {
+        target = 1ULL << 40; // Keeps stride * target in range
+    }
+
+    const unsigned long long doubled = (unsigned long long)deadline->stride * 2;
+    unsigned long long stride = doubled;
+    const long long elapsed = deadline->last != 0 ? now - deadline->last : 0;
+    if (elapsed > 0)
+    {
+        stride = (unsigned long long)deadline->stride * target / (unsigned long long)elapsed;
+        stride = stride > doubled ? doubled : stride;
+    }
+
+    stride = stride < 1 ? 1 : stride > FLUENT_LIBC_CLOCK_DEADLINE_MAX_STRIDE ? FLUENT_LIBC_CLOCK_DEADLINE_MAX_STRIDE : stride;
+    deadline->last = now;
+    deadline->stride = (unsigned int)stride;
+    deadline->countdown = (unsigned int)stride;
+    return 0;
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_DEADLINE_H
@@ -0,0 +1,423 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_DURATION_H
+#define FLUENT_LIBC_CLOCK_DURATION_H
+
+// ============= FLUENT LIB C =============
+// Typed Durations and Instants
+// ----------------------------------------
+// Distinct types for points in time and spans of time, with saturating
+// 64-bit arithmetic that never wraps, plus status-returning accessors in
+// place of the in-band -1 error value.
+//
+// Features:
+// - `hr_instant_t`: A `get_nano_time()` reading
+// - `hr_duration_t`: Signed span; `hr_uduration_t`: Non-negative span
+// - `hr_duration_add()` / `_sub()` / `_mul()`: Saturate at the 64-bit limits
+// - `hr_duration_from_unit()` / `hr_duration_to_unit()`: Conversions with a status code
+// - `hr_clock_elapsed()`: Status + duration instead of -1 on NULL
+//
+// Example:
+// ----------------------------------------
+//   hr_instant_t start = hr_instant_now();
+//   // ... work ...
+//   hr_duration_t spent = hr_instant_elapsed(start);
+//   hr_duration_t budget;
+//   hr_duration_from_unit(50, CLOCK_MILLISECONDS, &budget);
+//   if (hr_duration_sub(budget, spent).nanos < 0) { ... }
+//
+
+#include "clock.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#define HR_DURATION_NANOS_MAX 0x7FFFFFFFFFFFFFFFLL
+#define HR_DURATION_NANOS_MIN (-HR_DURATION_NANOS_MAX - 1)
+
+/**
+ * \enum hr_clock_status_t
+ * \brief Outcome of the status-returning functions; results are written through a pointer.
+ */
+typedef enum
+{
+    HR_CLOCK_OK = 0,           ///< Success
+    HR_CLOCK_ERROR_NULL,       ///< A required pointer was NULL; nothing was written
+    HR_CLOCK_ERROR_UNIT,       ///< The time unit is invalid; nothing was written
+    HR_CLOCK_ERROR_RANGE,      ///< The result did not fit; the saturated value was written
+} hr_clock_status_t;
+
+/**
+ * \struct hr_instant_t
+ * \brief A point in time: a reading of one clock source, in nanoseconds.
+ *
+ * Only instants taken from the same source can be compared.
+ */
+typedef struct
+{
+    long long nanos; ///< The reading in nanoseconds
+} hr_instant_t;
+
+/**
+ * \struct hr_duration_t
+ * \brief A signed span of time in nanoseconds (about +/- 292 years).
+ */
+typedef struct
+{
+    long long nanos; ///< The span in nanoseconds
+} hr_duration_t;
+
+/**
+ * \struct hr_uduration_t
+ * \brief A non-negative span of time in nanoseconds (up to about 584 years).
+ */
+typedef struct
+{
+    unsigned long long nanos; ///< The span in nanoseconds
+} hr_uduration_t;
+
+// ============= SATURATING ARITHMETIC =============
+
+/**
+ * \brief Adds two signed 64-bit values, clamping to the representable range.
+ */
+static inline long long hr_sat_add_i64(const long long a, const long long b)
+{
+    const unsigned long long sum = (unsigned long long)a + (unsigned long long)b;
+    const long long limit = (long long)(((unsigned long long)a >> 63) + 0x7FFFFFFFFFFFFFFFULL); // MAX, or MIN if a < 0
+
+    // Overflow iff both operands share a sign the sum does not
+    return (long long)((sum ^ (unsigned long long)a) & (sum ^ (unsigned long long)b)) < 0 ? limit : (long long)sum;
+}
+
+/**
+ * \brief Subtracts two signed 64-bit values, clamping to the representable range.
+ */
+static inline long long hr_sat_sub_i64(const long long a, const long long b)
+{
+    const unsigned long long difference = (unsigned long long)a - (unsigned long long)b;
+    const long long limit = (long long)(((unsigned long long)a >> 63) + 0x7FFFFFFFFFFFFFFFULL); // MAX, or MIN if a < 0
+
+    // Overflow iff the operands differ in sign and the result's sign differs from a's
+    return (long long)(((unsigned long long)a ^ (unsigned long long)b) & ((unsigned long long)a ^ difference)) < 0
+        ? limit
+        : (long long)difference;
+}
+
+/**
+ * \brief Multiplies two signed 64-bit values.
+ *
+ * \param out Receives the product, clamped to the representable range.
+ * \return Non-zero if the product overflowed and was clamped.
+ */
+static inline int hr_mul_overflow_i64(const long long a, const long long b, long long *const out)
+{
+    const unsigned long long negative = (unsigned long long)((a ^ b) >> 63); // All ones if the signs differ
+    const unsigned long long sign_a = (unsigned long long)(a >> 63);
+    const unsigned long long sign_b = (unsigned long long)(b >> 63);
+    unsigned long long low;
+    const unsigned long long high = hr_clock_mul_wide(
+        ((unsigned long long)a ^ sign_a) - sign_a,
+        ((unsigned long long)b ^ sign_b) - sign_b,
+        &low
+    );
+
+    // |MIN| is one more than MAX, so a negative product may reach 2^63
+    const unsigned long long bound = 0x7FFFFFFFFFFFFFFFULL + (negative & 1);
+    if (high != 0 || low > bound)
+    {
+        *out = negative ? HR_DURATION_NANOS_MIN : HR_DURATION_NANOS_MAX;
+        return 1;
+    }
+
+    *out = (long long)((low ^ negative) - negative);
+    return 0;
+}
+
+/**
+ * \brief Adds two unsigned 64-bit values, clamping at the maximum.
+ */
+static inline unsigned long long hr_sat_add_u64(const unsigned long long a, const unsigned long long b)
+{
+    const unsigned long long sum = a + b;
+    return sum < a ? ~0ULL : sum;
+}
+
+/**
+ * \brief Subtracts two unsigned 64-bit values, clamping at zero.
+ */
+static inline unsigned long long hr_sat_sub_u64(const unsigned long long a, const unsigned long long b)
+{
+    return a > b ? a - b : 0;
+}
+
+// ============= DURATIONS =============
+
+/**
+ * \brief Wraps a nanosecond count as a duration.
+ */
+static inline hr_duration_t hr_duration_from_nanos(const long long nanos)
+{
+    hr_duration_t duration;
+    duration.nanos = nanos;
+    return duration;
+}
+
+/**
+ * \brief Builds a duration from a count of \p unit.
+ *
+ * \param value The count.
+ * \param unit The unit of \p value (see \p hr_clock_time_unit_t).
+ * \param out Receives the duration.
+ * \return HR_CLOCK_OK, HR_CLOCK_ERROR_NULL, HR_CLOCK_ERROR_UNIT, or HR_CLOCK_ERROR_RANGE if it saturated.
+ */
+static inline hr_clock_status_t hr_duration_from_unit(
+    const long long value,
+    const hr_clock_time_unit_t unit,
+    hr_duration_t *const out
+)
+{
+    if (out == NULL)
+    {
+        return HR_CLOCK_ERROR_NULL; // Handle null pointer
+    }
+
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return HR_CLOCK_ERROR_UNIT; // Invalid unit
+    }
+
+    return hr_mul_overflow_i64(value, hr_clock_unit_nanos[unit], &out->nanos) ? HR_CLOCK_ERROR_RANGE : HR_CLOCK_OK;
+}
+
+/**
+ * \brief Converts a duration to a whole count of \p unit, truncating toward zero.
+ *
+ * \param duration The duration to convert.
+ * \param unit The target unit (see \p hr_clock_time_unit_t).
+ * \param out Receives the count.
+ * \return HR_CLOCK_OK, HR_CLOCK_ERROR_NULL or HR_CLOCK_ERROR_UNIT.
+ */
+static inline hr_clock_status_t hr_duration_to_unit(
+    const hr_duration_t duration,
+    const hr_clock_time_unit_t unit,
+    long long *const out
+)
+{
+    if (out == NULL)
+    {
+        return HR_CLOCK_ERROR_NULL; // Handle null pointer
+    }
+
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return HR_CLOCK_ERROR_UNIT; // Invalid unit
+    }
+
+    *out = clock_nanos_to_unit_unchecked(duration.nanos, unit);
+    return HR_CLOCK_OK;
+}
+
+/**
+ * \brief Sum of two durations, saturating.
+ */
+static inline hr_duration_t hr_duration_add(const hr_duration_t a, const hr_duration_t b)
+{
+    return hr_duration_from_nanos(hr_sat_add_i64(a.nanos, b.nanos));
+}
+
+/**
+ * \brief Difference of two durations, saturating.
+ */
+static inline hr_duration_t hr_duration_sub(const hr_duration_t a, const hr_duration_t b)
+{
+    return hr_duration_from_nanos(hr_sat_sub_i64(a.nanos, b.nanos));
+}
+
+/**
+ * \brief Duration scaled by an integer factor, saturating.
+ */
+static inline hr_duration_t hr_duration_mul(const hr_duration_t duration, const long long factor)
+{
+    hr_duration_t result;
+    (void)hr_mul_overflow_i64(duration.nanos, factor, &result.nanos);
+    return result;
+}
+
+/**
+ * \brief Magnitude of a duration; exact for every value, including the minimum.
+ */
+static inline hr_uduration_t hr_duration_abs(const hr_duration_t duration)
+{
+    const unsigned long long sign = (unsigned long long)(duration.nanos >> 63);
+    hr_uduration_t result;
+    result.nanos = ((unsigned long long)duration.nanos ^ sign) - sign;
+    return result;
+}
+
+/**
+ * \brief Converts a signed duration to a non-negative one.
+ *
+ * \param duration The duration to convert.
+ * \param out Receives the duration, or 0 if \p duration is negative.
+ * \return HR_CLOCK_OK, HR_CLOCK_ERROR_NULL, or HR_CLOCK_ERROR_RANGE if \p duration was negative.
+ */
+static inline hr_clock_status_t hr_duration_to_unsigned(const hr_duration_t duration, hr_uduration_t *const out)
+{
+    if (out == NULL)
+    {
+        return HR_CLOCK_ERROR_NULL; // Handle null pointer
+    }
+
+    out->nanos = duration.nanos > 0 ? (unsigned long long)duration.nanos : 0;
+    return duration.nanos < 0 ? HR_CLOCK_ERROR_RANGE : HR_CLOCK_OK;
+}
+
+/**
+ * \brief Sum of two non-negative durations, saturating at the maximum.
+ */
+static inline hr_uduration_t hr_uduration_add(const hr_uduration_t a, const hr_uduration_t b)
+{
+    hr_uduration_t result;
+    result.nanos = hr_sat_add_u64(a.nanos, b.nanos);
+    return result;
+}
+
+/**
+ * \brief Difference of two non-negative durations, saturating at zero.
+ */
+static inline hr_uduration_t hr_uduration_sub(const hr_uduration_t a, const hr_uduration_t b)
+{
+    hr_uduration_t result;
+    result.nanos = hr_sat_sub_u64(a.nanos, b.nanos);
+    return result;
+}
+
+// ============= INSTANTS =============
+
+/**
+ * \brief Reads the active clock source (see get_nano_time()).
+ */
+static inline hr_instant_t hr_instant_now()
+{
+    hr_instant_t instant;
+    instant.nanos = get_nano_time();
+    return instant;
+}
+
+/**
+ * \brief Reads a specific clock source (see get_nano_time_ex()).
+ */
+static inline hr_instant_t hr_instant_now_ex(const hr_clock_source_t source)
+{
+    hr_instant_t instant;
+    instant.nanos = get_nano_time_ex(source);
+    return instant;
+}
+
+/**
+ * \brief Time from \p earlier to \p later, saturating; negative if \p later is before \p earlier.
+ */
+static inline hr_duration_t hr_instant_diff(const hr_instant_t later, const hr_instant_t earlier)
+{
+    return hr_duration_from_nanos(hr_sat_sub_i64(later.nanos, earlier.nanos));
+}
+
+/**
+ * \brief Time elapsed since an instant taken with hr_instant_now().
+ */
+static inline hr_duration_t hr_instant_elapsed(const hr_instant_t since)
+{
+    return hr_instant_diff(hr_instant_now(), since);
+}
+
+/**
+ * \brief The instant \p duration after \p instant, saturating.
+ */
+static inline hr_instant_t hr_instant_add(const hr_instant_t instant, const hr_duration_t duration)
+{
+    hr_instant_t result;
+    result.nanos = hr_sat_add_i64(instant.nanos, duration.nanos);
+    return result;
+}
+
+/**
+ * \brief The instant \p duration before \p instant, saturating.
+ */
+static inline hr_instant_t hr_instant_sub(const hr_instant_t instant, const hr_duration_t duration)
+{
+    hr_instant_t result;
+    result.nanos = hr_sat_sub_i64(instant.nanos, duration.nanos);
+    return result;
+}
+
+// ============= CHECKED CLOCK ACCESS =============
+
+/**
+ * \brief Time elapsed since hr_clock_tick(), without the in-band -1.
+ *
+ * \param clock Pointer to the started \p hr_clock_t.
+ * \param out Receives the elapsed duration (may be negative across sources).
+ * \return HR_CLOCK_OK or HR_CLOCK_ERROR_NULL.
+ */
+static inline hr_clock_status_t hr_clock_elapsed(const hr_clock_t *const clock, hr_duration_t *const out)
+{
+    if (clock == NULL || out == NULL)
+    {
+        return HR_CLOCK_ERROR_NULL; // Handle null pointers
+    }
+
+    out->nanos = hr_sat_sub_i64(get_nano_time_ex(hr_clock_source_of(clock)), clock->start_time);
+    return HR_CLOCK_OK;
+}
+
+/**
+ * \brief Time between two clocks, without the in-band -1.
+ *
+ * \param clock Pointer to the starting \p hr_clock_t.
+ * \param other Pointer to the ending \p hr_clock_t.
+ * \param out Receives \p other minus \p clock (negative if \p other started first).
+ * \return HR_CLOCK_OK or HR_CLOCK_ERROR_NULL.
+ */
+static inline hr_clock_status_t hr_clock_between(
+    const hr_clock_t *const clock,
+    const hr_clock_t *const other,
+    hr_duration_t *const out
+)
+{
+    if (clock == NULL || other == NULL || out == NULL)
+    {
+        return HR_CLOCK_ERROR_NULL; // Handle null pointers
+    }
+
+    out->nanos = hr_sat_sub_i64(other->start_time, clock->start_time);
+    return HR_CLOCK_OK;
+}
+
+/**
+ * \brief The instant an \p hr_clock_t was started at.
+ */
+static inline hr_instant_t hr_clock_start_instant_unchecked(const hr_clock_t *const clock)
+{
+    hr_instant_t instant;
+    instant.nanos = clock->start_time;
+    return instant;
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_DURATION_H
@@ -0,0 +1,415 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_HISTOGRAM_H
+#define FLUENT_LIBC_CLOCK_HISTOGRAM_H
+
+// ============= FLUENT LIB C =============
+// Lock-free Latency Histogram
+// ----------------------------------------
+// Log-linear (HDR-style) histogram of nanosecond durations.
+//
+// Features:
+// - `hr_histogram_t`: Fixed-size bucket array, no allocation
+// - `hr_histogram_record()`: One relaxed atomic increment per sample
+// - `hr_histogram_merge()`: Fold per-thread shards into one histogram
+// - `hr_histogram_percentile()`: Query p50/p99/p99.9/...
+// - `hr_histogram_summarize()`: Count, min, p50, p90, p99, p99.9, max in one pass
+// - `hr_clock_record()`: Stop an `hr_clock_t` and record the interval
+//
+// Values below 2^FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS ns are stored exactly;
+// larger values keep FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS significant bits,
+// i.e. a relative error below 2^-SUB_BITS (1.6% with the default of 6).
+//
+// Example:
+// ----------------------------------------
+//   static hr_histogram_t hist; // Zero-initialized, ready to use
+//   hr_clock_t clk;
+//   hr_clock_tick(&clk);
+//   // ... some work ...
+//   hr_clock_record(&clk, &hist);
+//   printf("p99: %lld ns\n", hr_histogram_percentile(&hist, 99.0));
+//
+
+#include "clock.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS
+ * \brief Number of significant bits kept per power of two.
+ */
+#ifndef FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS
+#   define FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS 6
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS
+ * \brief Total number of buckets: one linear block plus one block per remaining power of two.
+ *
+ * Durations are non-negative 64-bit signed values, so the highest block is
+ * the one holding [2^62, 2^63): 63 - SUB_BITS blocks above the linear one.
+ */
+#define FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS \
+    ((64 - FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS) << FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS)
+
+/**
+ * \struct hr_histogram_t
+ * \brief Log-linear histogram of nanosecond durations.
+ *
+ * A zero-initialized instance is empty and ready to use. Recording is safe
+ * from any number of threads, but to avoid cache-line contention keep one
+ * instance per thread and merge them with hr_histogram_merge() when reporting.
+ */
+typedef struct
+{
+    volatile unsigned long long counts[FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS]; ///< Samples per bucket
+} hr_histogram_t;
+
+/**
+ * \struct hr_histogram_summary_t
+ * \brief The usual latency percentiles, all in nanoseconds.
+ */
+typedef struct
+{
+    unsigned long long count; ///< Number of recorded samples
+    long long min;            ///< Smallest recorded value (bucket lower bound)
+    long long p50;            ///< Median
+    long long p90;            ///< 90th percentile
+    long long p99;            ///< 99th percentile
+    long long p999;           ///< 99.9th percentile
+    long long max;            ///< Largest recorded value (bucket upper bound)
+} hr_histogram_summary_t;
+
+/**
+ * \brief Returns the index of the highest set bit of a non-zero value.
+ */
+static inline unsigned int hr_histogram_log2(const unsigned long long value)
+{
+#if defined(FLUENT_LIBC_CLOCK_MSVC)
+    unsigned long index;
+#   if defined(_M_X64) || defined(_M_ARM64)
+    _BitScanReverse64(&index, value);
+    return (unsigned int)index;
+#   else
+    if (value >> 32)
+    {
+        _BitScanReverse(&index, (unsigned long)(value >> 32));
+        return (unsigned int)index + 32;
+    }
+
+    _BitScanReverse(&index, (unsigned long)value);
+    return (unsigned int)index;
+#   endif
+#else
+    return 63u - (unsigned int)__builtin_clzll(value);
+#endif
+}
+
+/**
+ * \brief Maps a duration to its bucket index.
+ *
+ * \param nanos The duration in nanoseconds; negative values count as zero.
+ * \return The bucket index, below FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS.
+ */
+static inline unsigned int hr_histogram_bucket_index(const long long nanos)
+{
+    const unsigned long long value = nanos < 0 ? 0ULL : (unsigned long long)nanos;
+    if (value < (1ULL << FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS))
+    {
+        return (unsigned int)value; // Linear block, exact
+    }
+
+    // Block b >= 1 covers [2^(b + SUB_BITS - 1), 2^(b + SUB_BITS)) in steps of 2^(b - 1)
+    const unsigned int block = hr_histogram_log2(value) - FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS + 1;
+    const unsigned int sub = (unsigned int)(value >> (block - 1)) & ((1u << FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS) - 1);
+    return (block << FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS) | sub;
+}
+
+/**
+ * \brief Returns the smallest duration that maps to bucket \p index.
+ */
+static inline long long hr_histogram_bucket_lower(const unsigned int index)
+{
+    const unsigned int block = index >> FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS;
+    if (block == 0)
+    {
+        return (long long)index;
+    }
+
+    const unsigned long long sub = index & ((1u << FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS) - 1);
+    return (long long)(((1ULL << FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS) | sub) << (block - 1));
+}
+
+/**
+ * \brief Returns the largest duration that maps to bucket \p index.
+ */
+static inline long long hr_histogram_bucket_upper(const unsigned int index)
+{
+    const unsigned int block = index >> FLUENT_LIBC_CLOCK_HISTOGRAM_SUB_BITS;
+    if (block == 0)
+    {
+        return (long long)index;
+    }
+
+    const unsigned long long upper = (unsigned long long)hr_histogram_bucket_lower(index) + ((1ULL << (block - 1)) - 1);
+    return upper > 0x7FFFFFFFFFFFFFFFULL ? 0x7FFFFFFFFFFFFFFFLL : (long long)upper;
+}
+
+/**
+ * \brief Empties the histogram.
+ *
+ * Not atomic with respect to concurrent recorders: samples recorded while the
+ * reset is in progress may or may not survive it.
+ *
+ * \param hist Pointer to the \p hr_histogram_t to reset.
+ */
+static inline void hr_histogram_reset(hr_histogram_t *const hist)
+{
+    if (hist == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    for (unsigned int i = 0; i < FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS; i++)
+    {
+        hr_atomic_store_u64_relaxed(&hist->counts[i], 0);
+    }
+}
+
+/**
+ * \brief Records a duration.
+ *
+ * \param hist Pointer to the \p hr_histogram_t to record into.
+ * \param nanos The duration in nanoseconds; negative values are recorded as zero.
+ */
+static inline void hr_histogram_record(hr_histogram_t *const hist, const long long nanos)
+{
+    if (hist == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    hr_atomic_fetch_add_u64_relaxed(&hist->counts[hr_histogram_bucket_index(nanos)], 1);
+}
+
+/**
+ * \brief Adds every sample of \p src to \p dst.
+ *
+ * Both histograms may keep being recorded into while merging; each bucket
+ * is transferred atomically, the histogram as a whole is not.
+ *
+ * \param dst Pointer to the \p hr_histogram_t receiving the samples.
+ * \param src Pointer to the \p hr_histogram_t to read from (left unchanged).
+ */
+static inline void hr_histogram_merge(hr_histogram_t *const dst, const hr_histogram_t *const src)
+{
+    if (dst == NULL || src == NULL)
+    {
+        return; // Handle null pointers
+    }
+
+    for (unsigned int i = 0; i < FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS; i++)
+    {
+        const unsigned long long count = hr_atomic_load_u64_relaxed(&src->counts[i]);
+        if (count != 0)
+        {
+            hr_atomic_fetch_add_u64_relaxed(&dst->counts[i], count);
+        }
+    }
+}
+
+/**
+ * \brief Returns the number of recorded samples.
+ *
+ * \param hist Pointer to the \p hr_histogram_t to inspect.
+ * \return The sample count, or 0 if the pointer is NULL.
+ */
+static inline unsigned long long hr_histogram_count(const hr_histogram_t *const hist)
+{
+    if (hist == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    unsigned long long total = 0;
+    for (unsigned int i = 0; i < FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS; i++)
+    {
+        total += hr_atomic_load_u64_relaxed(&hist->counts[i]);
+    }
+
+    return total;
+}
+
+/**
+ * \brief Returns the value below which \p percentile percent of the samples fall.
+ *
+ * The result is the upper bound of the bucket holding that sample, so it never
+ * under-reports latency.
+ *
+ * \param hist Pointer to the \p hr_histogram_t to query.
+ * \param percentile The percentile to compute, in [0, 100] (e.g. 99.9); values outside are clamped.
+ * \return The percentile in nanoseconds, or -1 if the pointer is NULL, the histogram
+ *         is empty or \p percentile is NaN.
+ */
+static inline long long hr_histogram_percentile(const hr_histogram_t *const hist, const double percentile)
+{
+    const unsigned long long total = hr_histogram_count(hist);
+    if (total == 0 || percentile != percentile)
+    {
+        return -1l; // Handle null pointer, empty histogram or NaN percentile
+    }
+
+    const double clamped = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+    unsigned long long rank = (unsigned long long)(clamped / 100.0 * (double)total + 0.5);
+    if (rank == 0)
+    {
+        rank = 1; // The 0th percentile is the minimum
+    }
+
+    unsigned long long seen = 0;
+    unsigned int last = 0;
+    for (unsigned int i = 0; i < FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS; i++)
+    {
+        const unsigned long long count = hr_atomic_load_u64_relaxed(&hist->counts[i]);
+        if (count == 0)
+        {
+            continue;
+        }
+
+        last = i;
+        seen += count;
+        if (seen >= rank)
+        {
+            return hr_histogram_bucket_upper(i);
+        }
+    }
+
+    return hr_histogram_bucket_upper(last); // Samples recorded concurrently with the count
+}
+
+/**
+ * \brief Returns the largest recorded duration (upper bound of its bucket).
+ *
+ * \param hist Pointer to the \p hr_histogram_t to query.
+ * \return The maximum in nanoseconds, or -1 if the pointer is NULL or the histogram is empty.
+ */
+static inline long long hr_histogram_max(const hr_histogram_t *const hist)
+{
+    if (hist == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    for (unsigned int i = FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS; i-- > 0;)
+    {
+        if (hr_atomic_load_u64_relaxed(&hist->counts[i]) != 0)
+        {
+            return hr_histogram_bucket_upper(i);
+        }
+    }
+
+    return -1l; // Empty histogram
+}
+
+/**
+ * \brief Computes count, min, p50, p90, p99, p99.9 and max from one snapshot of the buckets.
+ *
+ * \param hist Pointer to the \p hr_histogram_t to query.
+ * \param summary Pointer to the \p hr_histogram_summary_t to fill; all values
+ *                are -1 (count 0) if the histogram is empty.
+ */
+static inline void hr_histogram_summarize(const hr_histogram_t *const hist, hr_histogram_summary_t *const summary)
+{
+    if (hist == NULL || summary == NULL)
+    {
+        return; // Handle null pointers
+    }
+
+    static const double percentiles[4] = {50.0, 90.0, 99.0, 99.9};
+    long long *const targets[4] = {&summary->p50, &summary->p90, &summary->p99, &summary->p999};
+    unsigned long long ranks[4];
+
+    // Snapshot the buckets once so the count and all percentiles agree under concurrent recording
+    unsigned long long counts[FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS];
+    summary->count = 0;
+    for (unsigned int i = 0; i < FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS; i++)
+    {
+        counts[i] = hr_atomic_load_u64_relaxed(&hist->counts[i]);
+        summary->count += counts[i];
+    }
+
+    summary->min = summary->p50 = summary->p90 = summary->p99 = summary->p999 = summary->max = -1l;
+    if (summary->count == 0)
+    {
+        return; // Empty histogram
+    }
+
+    for (int p = 0; p < 4; p++)
+    {
+        ranks[p] = (unsigned long long)(percentiles[p] / 100.0 * (double)summary->count + 0.5);
+        ranks[p] = ranks[p] == 0 ? 1 : ranks[p];
+    }
+
+    unsigned long long seen = 0;
+    int next = 0;
+    for (unsigned int i = 0; i < FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS; i++)
+    {
+        if (counts[i] == 0)
+        {
+            continue;
+        }
+
+        if (summary->min < 0)
+        {
+            summary->min = hr_histogram_bucket_lower(i);
+        }
+
+        seen += counts[i];
+        summary->max = hr_histogram_bucket_upper(i);
+        while (next < 4 && seen >= ranks[next])
+        {
+            *targets[next++] = summary->max;
+        }
+    }
+}
+
+/**
+ * \brief Stops a high-resolution clock and records the elapsed time.
+ *
+ * The clock is read from the same source it was started with. The clock itself
+ * is left unchanged, so it can keep being used as a reference.
+ *
+ * \param clock Pointer to the \p hr_clock_t structure representing the start time.
+ * \param hist Pointer to the \p hr_histogram_t to record into.
+ * \return The recorded duration in nanoseconds, or -1 if any pointer is NULL.
+ */
+static inline long long hr_clock_record(const hr_clock_t *const clock, hr_histogram_t *const hist)
+{
+    if (clock == NULL || hist == NULL)
+    {
+        return -1l; // Handle null pointers
+    }
+
+    const long long elapsed = get_nano_time_ex(hr_clock_source_of(clock)) - clock->start_time;
+    hr_atomic_fetch_add_u64_relaxed(&hist->counts[hr_histogram_bucket_index(elapsed)], 1);
+    return elapsed;
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_HISTOGRAM_H
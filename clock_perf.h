@@ -0,0 +1,406 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_PERF_H
+#define FLUENT_LIBC_CLOCK_PERF_H
+
+// ============= FLUENT LIB C =============
+// Hardware Counter Clock
+// ----------------------------------------
+// An `hr_clock_t` that also samples hardware performance counters (cycles,
+// instructions, cache misses, branch misses) at tick and stop, so a slower
+// interval comes with the counter deltas that explain it.
+//
+// Features:
+// - `hr_perf_clock_init()`: Open the counters for the calling thread
+// - `hr_perf_clock_tick()` / `hr_perf_clock_stop()`: Interval in ns plus counter deltas
+// - `hr_perf_sample_ipc()`: Instructions per cycle of a sample
+// - `hr_perf_counter_name()`: Printable counter names for reports
+//
+// On Linux the counters come from perf_event_open(2), counting user-space
+// events of the calling thread only. Each counter's mmap'd control page is
+// read in user space with rdpmc on x86; where rdpmc is not permitted or the
+// event is not currently on a hardware counter, the value is read with
+// read(2) instead. The counters form one perf group, so they are scheduled
+// onto the PMU together and always cover the same time window; when the PMU
+// is multiplexed, read(2) values are scaled by enabled / running time. When
+// no counter can be opened (other platforms, missing PMU in a VM,
+// perf_event_paranoid, seccomp) the clock measures time only and reports no
+// valid counters.
+//
+// Example:
+// ----------------------------------------
+//   hr_perf_clock_t pc;
+//   hr_perf_clock_init(&pc, CLOCK_SOURCE_MONOTONIC);
+//   hr_perf_clock_tick(&pc);
+//   // ... some work ...
+//   hr_perf_sample_t sample;
+//   hr_perf_clock_stop(&pc, &sample);
+//   printf("%lld ns, IPC %.2f\n", sample.nanos, hr_perf_sample_ipc(&sample));
+//   hr_perf_clock_destroy(&pc);
+//
+
+#include <string.h>
+#include "clock.h"
+
+#if defined(__linux__)
+#   include <linux/perf_event.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#   define FLUENT_LIBC_CLOCK_HAS_PERF 1
+#endif
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \enum hr_perf_counter_t
+ * \brief Hardware counters sampled by an \p hr_perf_clock_t; also bit positions of the valid masks.
+ */
+typedef enum
+{
+    HR_PERF_CYCLES = 0,    ///< CPU cycles
+    HR_PERF_INSTRUCTIONS,  ///< Retired instructions
+    HR_PERF_CACHE_MISSES,  ///< Last-level cache misses
+    HR_PERF_BRANCH_MISSES, ///< Mispredicted branches
+    HR_PERF_COUNTERS       ///< Number of counters
+} hr_perf_counter_t;
+
+/**
+ * \struct hr_perf_clock_t
+ * \brief A clock interval paired with per-thread hardware counters.
+ *
+ * Counters only count the thread that called hr_perf_clock_init(); tick
+ * and stop must run on that thread.
+ */
+typedef struct
+{
+    hr_clock_t clock;                           ///< Start time and source
+    int fds[HR_PERF_COUNTERS];                  ///< perf event descriptors, -1 if unavailable
+    void *pages[HR_PERF_COUNTERS];              ///< mmap'd control pages, NULL if unavailable
+    unsigned long long start[HR_PERF_COUNTERS]; ///< Counter values at the last tick
+    unsigned int available;                     ///< Bit mask of the opened counters
+} hr_perf_clock_t;
+
+/**
+ * \struct hr_perf_sample_t
+ * \brief One measured interval.
+ */
+typedef struct
+{
+    long long nanos;                             ///< Elapsed time in nanoseconds
+    unsigned long long counts[HR_PERF_COUNTERS]; ///< Counter deltas (0 where not valid)
+    unsigned int valid;                          ///< Bit mask of the counters present in \p counts
+} hr_perf_sample_t;
+
+/**
+ * \brief Printable name of a counter, e.g. for report headers.
+ */
+static inline const char *hr_perf_counter_name(const hr_perf_counter_t counter)
+{
+    static const char *const names[HR_PERF_COUNTERS] = {"cycles", "instructions", "cache-misses", "branch-misses"};
+    return (unsigned int)counter < (unsigned int)HR_PERF_COUNTERS ? names[counter] : "unknown";
+}
+
+#if defined(FLUENT_LIBC_CLOCK_HAS_PERF)
+/**
+ * \brief Opens one user-space counter of the calling thread.
+ *
+ * \param config The PERF_COUNT_HW_* event.
+ * \param group_fd The group leader's descriptor, or -1 to open a new group.
+ * \return The event descriptor, or -1 if it is not available.
+ */
+static inline int hr_perf_open(const unsigned long long config, const int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+/**
+ * \brief Reads a counter through its control page with rdpmc.
+ *
+ * Only succeeds while the event sits on a hardware counter and has never
+ * been multiplexed out, so the raw count needs no scaling.
+ *
+ * \return Non-zero if \p out was set.
+ */
+static inline int hr_perf_read_user(void *const page, unsigned long long *const out)
+{
+    if (page != NULL)
+    {
+        const volatile struct perf_event_mmap_page *const control = (const volatile struct perf_event_mmap_page *)page;
+        for (;;)
+        {
+            const unsigned int sequence = control->lock;
+            __asm__ __volatile__("" ::: "memory");
+
+            const unsigned int index = control->index;
+            if (!control->cap_user_rdpmc || index == 0 || control->time_enabled != control->time_running)
+            {
+                break; // Not on a hardware counter right now, or multiplexed
+            }
+
+            long long count = control->offset;
+#   if defined(FLUENT_LIBC_CLOCK_X86)
+            unsigned int low, high;
+            __asm__ __volatile__("rdpmc" : "=a"(low), "=d"(high) : "c"(index - 1));
+            const unsigned int shift = 64 - control->pmc_width;
+            count += (long long)((((unsigned long long)high << 32) | low) << shift) >> shift;
+#   else
+            break; // No user-space counter read on this architecture
+#   endif
+
+            __asm__ __volatile__("" ::: "memory");
+            if (control->lock == sequence)
+            {
+                *out = (unsigned long long)count;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+#endif // FLUENT_LIBC_CLOCK_HAS_PERF
+
+/**
+ * \brief Opens the counters for the calling thread.
+ *
+ * Counters that cannot be opened are left out; with none the clock still
+ * measures time.
+ *
+ * \param pc Pointer to the \p hr_perf_clock_t to initialize.
+ * \param source The time source of the interval (see hr_clock_tick_ex()).
+ * \return The number of counters opened (0 for time only), or -1 if the pointer is NULL.
+ */
+static inline int hr_perf_clock_init(hr_perf_clock_t *const pc, const hr_clock_source_t source)
+{
+    if (pc == NULL)
+    {
+        return -1; // Handle null pointer
+    }
+
+    pc->clock.start_time = 0;
+    pc->clock.source = source;
+    pc->available = 0;
+    int opened = 0;
+    for (int i = 0; i < HR_PERF_COUNTERS; i++)
+    {
+        pc->fds[i] = -1;
+        pc->pages[i] = NULL;
+        pc->start[i] = 0;
+    }
+
+#if defined(FLUENT_LIBC_CLOCK_HAS_PERF)
+    static const unsigned long long configs[HR_PERF_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+    int leader = -1;
+    for (int i = 0; i < HR_PERF_COUNTERS; i++)
+    {
+        // The kernel rejects members that would keep the group from fitting on the PMU
+        pc->fds[i] = hr_perf_open(configs[i], leader);
+        if (pc->fds[i] < 0)
+        {
+            pc->fds[i] = -1;
+            continue;
+        }
+
+        void *const page = mmap(NULL, (size_t)page_size, PROT_READ, MAP_SHARED, pc->fds[i], 0);
+        pc->pages[i] = page != MAP_FAILED ? page : NULL;
+        pc->available |= 1u << i;
+        leader = leader < 0 ? pc->fds[i] : leader;
+        opened++;
+    }
+#endif
+
+    return opened;
+}
+
+/**
+ * \brief Closes the counters.
+ *
+ * \param pc Pointer to the \p hr_perf_clock_t to destroy.
+ */
+static inline void hr_perf_clock_destroy(hr_perf_clock_t *const pc)
+{
+    if (pc == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+#if defined(FLUENT_LIBC_CLOCK_HAS_PERF)
+    const long page_size = sysconf(_SC_PAGESIZE);
+    for (int i = 0; i < HR_PERF_COUNTERS; i++)
+    {
+        if (pc->pages[i] != NULL)
+        {
+            munmap(pc->pages[i], (size_t)page_size);
+        }
+
+        if (pc->fds[i] >= 0)
+        {
+            close(pc->fds[i]);
+        }
+    }
+#endif
+
+    for (int i = 0; i < HR_PERF_COUNTERS; i++)
+    {
+        pc->fds[i] = -1;
+        pc->pages[i] = NULL;
+    }
+    pc->available = 0;
+}
+
+/**
+ * \brief Reads every opened counter into \p values.
+ *
+ * Uses rdpmc where every counter allows it, otherwise one read(2) of the
+ * whole group, scaled to the time the group was enabled.
+ */
+static inline void hr_perf_clock_read(const hr_perf_clock_t *const pc, unsigned long long *const values)
+{
+#if defined(FLUENT_LIBC_CLOCK_HAS_PERF)
+    int user = 1;
+    for (int i = 0; i < HR_PERF_COUNTERS; i++)
+    {
+        values[i] = 0;
+        if (pc->available & (1u << i))
+        {
+            user = user && hr_perf_read_user(pc->pages[i], &values[i]);
+        }
+    }
+
+    if (user || pc->available == 0)
+    {
+        return;
+    }
+
+    // Leader first, then the members in the order they joined
+    int leader = 0;
+    while (!(pc->available & (1u << leader)))
+    {
+        leader++;
+    }
+
+    unsigned long long group[3 + HR_PERF_COUNTERS]; // nr, time enabled, time running, values
+    const ssize_t size = read(pc->fds[leader], group, sizeof(group));
+    const unsigned long long running = group[2];
+    if (size < (ssize_t)(3 * sizeof(unsigned long long)) || running == 0)
+    {
+        for (int i = 0; i < HR_PERF_COUNTERS; i++)
+        {
+            values[i] = 0; // Never scheduled yet
+        }
+        return;
+    }
+
+    const double scale = (double)group[1] / (double)running;
+    unsigned long long member = 0;
+    for (int i = 0; i < HR_PERF_COUNTERS; i++)
+    {
+        if (pc->available & (1u << i))
+        {
+            const unsigned long long value = member < group[0] ? group[3 + member] : 0;
+            values[i] = group[1] == running ? value : (unsigned long long)((double)value * scale);
+            member++;
+        }
+    }
+#else
+    for (int i = 0; i < HR_PERF_COUNTERS; i++)
+    {
+        values[i] = 0;
+    }
+#endif
+}
+
+/**
+ * \brief Starts an interval: snapshots the counters, then the time.
+ *
+ * \param pc Pointer to the \p hr_perf_clock_t to start.
+ */
+static inline void hr_perf_clock_tick(hr_perf_clock_t *const pc)
+{
+    if (pc == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    hr_perf_clock_read(pc, pc->start);
+    pc->clock.start_time = get_nano_time_ex(pc->clock.source);
+}
+
+/**
+ * \brief Ends the interval started by hr_perf_clock_tick(): reads the time, then the counters.
+ *
+ * The clock is not restarted; call hr_perf_clock_tick() for the next interval.
+ *
+ * \param pc Pointer to the \p hr_perf_clock_t to read.
+ * \param out Receives the duration and the counter deltas.
+ * \return The elapsed time in nanoseconds, or -1 if a pointer is NULL.
+ */
+static inline long long hr_perf_clock_stop(const hr_perf_clock_t *const pc, hr_perf_sample_t *const out)
+{
+    if (pc == NULL || out == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    const long long end = get_nano_time_ex(pc->clock.source);
+    hr_perf_clock_read(pc, out->counts);
+    for (int i = 0; i < HR_PERF_COUNTERS; i++)
+    {
+        out->counts[i] = pc->available & (1u << i) ? out->counts[i] - pc->start[i] : 0;
+    }
+
+    out->nanos = end - pc->clock.start_time;
+    out->valid = pc->available;
+    return out->nanos;
+}
+
+/**
+ * \brief Instructions per cycle of a sample.
+ *
+ * \return The ratio, or 0 if either counter is missing or no cycles were counted.
+ */
+static inline double hr_perf_sample_ipc(const hr_perf_sample_t *const sample)
+{
+    const unsigned int needed = (1u << HR_PERF_CYCLES) | (1u << HR_PERF_INSTRUCTIONS);
+    if (sample == NULL || (sample->valid & needed) != needed || sample->counts[HR_PERF_CYCLES] == 0)
+    {
+        return 0.0; // Handle null pointer or missing counters
+    }
+
+    return (double)sample->counts[HR_PERF_INSTRUCTIONS] / (double)sample->counts[HR_PERF_CYCLES];
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_PERF_H
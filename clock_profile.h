@@ -0,0 +1,590 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_PROFILE_H
+#define FLUENT_LIBC_CLOCK_PROFILE_H
+
+// ============= FLUENT LIB C =============
+// Per-callsite Timing Registry
+// ----------------------------------------
+// Named scope timers aggregated into a call tree: every distinct path of
+// nested scopes gets its own node with a call count, inclusive time and
+// exclusive (self) time. Dumps merge the per-thread trees on read and can
+// be written as folded stacks for flame graph tools.
+//
+// Features:
+// - `HR_TIMED_SCOPE(name)`: Time the enclosing scope under `name`
+// - `hr_profile_callsite()`: Intern a name once into a callsite id (cached in a static)
+// - `hr_timed_scope_begin()` / `hr_timed_scope_end()`: Explicit scope boundaries
+// - `hr_profile_collect()`: Merge every thread's tree into an array of nodes
+// - `hr_profile_write_folded()`: Folded-stack text ("a;b;c 1234"), one line per path
+//
+// The hot path does no hashing and takes no lock: each thread owns a
+// cache-line-aligned node array and finds a child of the current node by
+// walking its (usually short) child list, comparing integer callsite ids.
+// Node arrays are allocated on the thread's first scope, or eagerly with
+// `hr_profile_thread_init()`; once full, new paths are dropped and counted.
+// When a thread exits its tree is retired and adopted by the next new
+// thread, which keeps adding to the same totals, so thread churn does not
+// grow memory.
+//
+// Scopes compile to nothing if FLUENT_LIBC_CLOCK_NO_PROFILE is defined.
+// `HR_TIMED_SCOPE()` needs `__attribute__((cleanup))` in C (GCC/Clang) or C++.
+//
+// Example:
+// ----------------------------------------
+//   static void handle(request_t *req)
+//   {
+//       HR_TIMED_SCOPE("handle");
+//       {
+//           HR_TIMED_SCOPE("db.query");
+//           // ... some work ...
+//       }
+//   }
+//   ...
+//   hr_profile_write_folded(stdout, CLOCK_MICROSECONDS); // "handle;db.query 812"
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "clock.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_PROFILE_MAX_CALLSITES
+ * \brief Number of distinct scope names that can be interned (id 0 is reserved).
+ */
+#ifndef FLUENT_LIBC_CLOCK_PROFILE_MAX_CALLSITES
+#   define FLUENT_LIBC_CLOCK_PROFILE_MAX_CALLSITES 1024
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_PROFILE_MAX_NODES
+ * \brief Call tree nodes per thread, root included; each node is one cache line.
+ */
+#ifndef FLUENT_LIBC_CLOCK_PROFILE_MAX_NODES
+#   define FLUENT_LIBC_CLOCK_PROFILE_MAX_NODES 512
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_PROFILE_NIL
+ * \brief Invalid node / entry index.
+ */
+#define FLUENT_LIBC_CLOCK_PROFILE_NIL 0xFFFFFFFFu
+
+/**
+ * \struct hr_profile_node_t
+ * \brief One path of the calling thread's call tree, padded to a cache line.
+ *
+ * Only the owning thread writes a node; readers load the counters atomically.
+ */
+typedef struct
+{
+    volatile unsigned long long count;        ///< Completed scopes on this path
+    volatile unsigned long long inclusive_ns; ///< Total time spent in the scope
+    volatile unsigned long long children_ns;  ///< Part of that time spent in nested scopes
+    unsigned int callsite;                    ///< Interned name id
+    unsigned int parent;                      ///< Parent node index (0 is the root)
+    unsigned int first_child;                 ///< Head of the child list (owner-only)
+    unsigned int next_sibling;                ///< Next node with the same parent (owner-only)
+    char pad[64 - 3 * sizeof(unsigned long long) - 4 * sizeof(unsigned int)];
+} hr_profile_node_t;
+
+/**
+ * \struct hr_profile_thread_t
+ * \brief Per-thread call tree; the nodes come first so they start on a cache line.
+ */
+typedef struct hr_profile_thread_t
+{
+    hr_profile_node_t nodes[FLUENT_LIBC_CLOCK_PROFILE_MAX_NODES]; ///< Node 0 is the root
+    volatile int node_count;             ///< Nodes in use, published with release semantics
+    unsigned int current;                ///< Innermost open scope's node
+    volatile unsigned long long dropped; ///< Scopes not recorded because the tree was full
+    volatile int retired;                ///< Non-zero once the owning thread has exited
+    struct hr_profile_thread_t *next;    ///< Next registered thread
+} hr_profile_thread_t;
+
+/**
+ * \struct hr_profile_state_t
+ * \brief Process-wide callsite registry.
+ */
+typedef struct
+{
+    volatile int lock;           ///< Serializes interning
+    volatile int callsite_count; ///< Last assigned callsite id
+    void *volatile threads;      ///< Lock-free list of registered \p hr_profile_thread_t
+    hr_thread_exit_key_t exit_key; ///< Retires a thread's tree when it exits
+    const char *names[FLUENT_LIBC_CLOCK_PROFILE_MAX_CALLSITES]; ///< Name of each callsite id
+} hr_profile_state_t;
+
+/**
+ * \struct hr_timed_scope_t
+ * \brief An open scope, as returned by hr_timed_scope_begin().
+ */
+typedef struct
+{
+    unsigned int node; ///< Node being timed, or FLUENT_LIBC_CLOCK_PROFILE_NIL
+    long long start;   ///< get_nano_time() when the scope was entered
+} hr_timed_scope_t;
+
+/**
+ * \struct hr_profile_entry_t
+ * \brief One node of the merged call tree.
+ */
+typedef struct
+{
+    const char *name;         ///< Scope name
+    unsigned int parent;      ///< Index of the parent entry, or FLUENT_LIBC_CLOCK_PROFILE_NIL at top level
+    unsigned int depth;       ///< Nesting depth, 0 at top level
+    unsigned int callsite;    ///< Interned name id
+    unsigned long long count; ///< Completed scopes, all threads
+    long long inclusive_ns;   ///< Total time in the scope
+    long long exclusive_ns;   ///< Time not spent in nested scopes
+} hr_profile_entry_t;
+
+FLUENT_LIBC_CLOCK_GLOBAL hr_profile_state_t hr_profile_state = FLUENT_LIBC_CLOCK_ZERO_INIT;
+FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL hr_profile_thread_t *hr_profile_thread = NULL;
+
+/**
+ * \brief Returns the callsite id of \p name, interning it on first use.
+ *
+ * The id is cached in \p slot, so a callsite pays for the lookup once;
+ * later calls are a single load. Callsites sharing a name share an id.
+ *
+ * \param slot Per-callsite cache, zero-initialized (a function-local static).
+ * \param name The scope name; must outlive the process's profiling (use string literals).
+ * \return The id, or 0 if a pointer is NULL or the registry is full.
+ */
+static inline unsigned int hr_profile_callsite(volatile int *const slot, const char *const name)
+{
+    if (slot == NULL || name == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    const int cached = hr_atomic_load_int(slot);
+    if (cached != 0)
+    {
+        return (unsigned int)cached;
+    }
+
+    while (!hr_atomic_cas_int(&hr_profile_state.lock, 0, 1))
+    {
+        hr_thread_yield(); // Another callsite is being interned
+    }
+
+    int id = 0;
+    const int count = hr_profile_state.callsite_count;
+    for (int i = 1; i <= count; i++)
+    {
+        if (strcmp(hr_profile_state.names[i], name) == 0)
+        {
+            id = i;
+            break;
+        }
+    }
+
+    if (id == 0 && count + 1 < FLUENT_LIBC_CLOCK_PROFILE_MAX_CALLSITES)
+    {
+        id = count + 1;
+        hr_profile_state.names[id] = name;
+        hr_atomic_store_int(&hr_profile_state.callsite_count, id);
+    }
+
+    hr_atomic_store_int(&hr_profile_state.lock, 0);
+    if (id != 0)
+    {
+        hr_atomic_store_int(slot, id);
+    }
+
+    return (unsigned int)id;
+}
+
+/**
+ * \brief Thread-exit callback: retires the exiting thread's tree so a new thread can adopt it.
+ */
+static inline void FLUENT_LIBC_CLOCK_THREAD_EXIT_CALL hr_profile_thread_exit(void *const value)
+{
+    hr_profile_thread_t *const thread = (hr_profile_thread_t *)value;
+    if (hr_profile_thread == thread)
+    {
+        hr_profile_thread = NULL; // A later scope on this thread gets a tree again
+    }
+
+    hr_atomic_store_int(&thread->retired, 1);
+}
+
+/**
+ * \brief Gives the calling thread a call tree, if it has none yet.
+ *
+ * Called implicitly by the first scope on each thread; call it explicitly at
+ * thread start to keep the allocation out of the first measured scope. A
+ * tree retired by an exited thread is adopted, counters included, before a
+ * new one is allocated.
+ *
+ * \return The calling thread's tree, or NULL if the allocation failed.
+ */
+static inline hr_profile_thread_t *hr_profile_thread_init()
+{
+    if (hr_profile_thread != NULL)
+    {
+        return hr_profile_thread;
+    }
+
+    // Trees are never freed, since dumps walk the list without a lock
+    for (hr_profile_thread_t *retired = (hr_profile_thread_t *)hr_atomic_load_ptr(&hr_profile_state.threads);
+         retired != NULL;
+         retired = retired->next)
+    {
+        if (hr_atomic_load_int(&retired->retired) && hr_atomic_cas_int(&retired->retired, 1, 0))
+        {
+            retired->current = 0; // The exited thread's scopes are all closed
+            hr_thread_exit_register(&hr_profile_state.exit_key, hr_profile_thread_exit, retired);
+            hr_profile_thread = retired;
+            return retired;
+        }
+    }
+
+    char *const raw = (char *)calloc(1, sizeof(hr_profile_thread_t) + 64);
+    if (raw == NULL)
+    {
+        return NULL; // Out of memory
+    }
+
+    hr_profile_thread_t *const thread = (hr_profile_thread_t *)(raw + (64 - (size_t)raw % 64));
+    thread->nodes[0].first_child = FLUENT_LIBC_CLOCK_PROFILE_NIL;
+    thread->nodes[0].next_sibling = FLUENT_LIBC_CLOCK_PROFILE_NIL;
+    thread->node_count = 1;
+    thread->current = 0;
+
+    void *head;
+    do
+    {
+        head = hr_atomic_load_ptr(&hr_profile_state.threads);
+        thread->next = (hr_profile_thread_t *)head;
+    } while (!hr_atomic_cas_ptr(&hr_profile_state.threads, head, thread));
+
+    hr_thread_exit_register(&hr_profile_state.exit_key, hr_profile_thread_exit, thread);
+    hr_profile_thread = thread;
+    return thread;
+}
+
+/**
+ * \brief Enters a scope: moves the calling thread to the child of its current node for \p callsite.
+ *
+ * Scopes must be closed in reverse order of opening, on the same thread.
+ * When the thread's tree is full a new path is not recorded; its time is
+ * counted as the enclosing scope's own, and scopes nested in it attach to
+ * the enclosing path.
+ *
+ * \param callsite The id returned by hr_profile_callsite().
+ * \return The open scope; pass it to hr_timed_scope_end().
+ */
+static inline hr_timed_scope_t hr_timed_scope_begin(const unsigned int callsite)
+{
+    hr_timed_scope_t scope = {FLUENT_LIBC_CLOCK_PROFILE_NIL, 0};
+    hr_profile_thread_t *const thread = hr_profile_thread != NULL ? hr_profile_thread : hr_profile_thread_init();
+    if (thread == NULL || callsite == 0)
+    {
+        return scope; // No tree available or unknown callsite
+    }
+
+    hr_profile_node_t *const parent = &thread->nodes[thread->current];
+    unsigned int index = parent->first_child;
+    while (index != FLUENT_LIBC_CLOCK_PROFILE_NIL && thread->nodes[index].callsite != callsite)
+    {
+        index = thread->nodes[index].next_sibling;
+    }
+
+    if (index == FLUENT_LIBC_CLOCK_PROFILE_NIL)
+    {
+        index = (unsigned int)thread->node_count; // Only this thread writes node_count
+        if (index >= FLUENT_LIBC_CLOCK_PROFILE_MAX_NODES)
+        {
+            hr_atomic_store_u64_relaxed(&thread->dropped, thread->dropped + 1);
+            return scope; // Tree full
+        }
+
+        hr_profile_node_t *const node = &thread->nodes[index];
+        node->callsite = callsite;
+        node->parent = thread->current;
+        node->first_child = FLUENT_LIBC_CLOCK_PROFILE_NIL;
+        node->next_sibling = parent->first_child;
+        parent->first_child = index;
+        hr_atomic_store_int(&thread->node_count, (int)index + 1); // Publish the node
+    }
+
+    thread->current = index;
+    scope.node = index;
+    scope.start = get_nano_time();
+    return scope;
+}
+
+/**
+ * \brief Leaves a scope opened with hr_timed_scope_begin() and records its duration.
+ *
+ * \param scope Pointer to the \p hr_timed_scope_t to close.
+ */
+static inline void hr_timed_scope_end(const hr_timed_scope_t *const scope)
+{
+    if (scope == NULL || scope->node == FLUENT_LIBC_CLOCK_PROFILE_NIL)
+    {
+        return; // Handle null pointer or unrecorded scope
+    }
+
+    const unsigned long long elapsed = (unsigned long long)(get_nano_time() - scope->start);
+    hr_profile_thread_t *const thread = hr_profile_thread;
+    if (thread == NULL)
+    {
+        return; // The tree was retired while the scope was open
+    }
+
+    hr_profile_node_t *const node = &thread->nodes[scope->node];
+    hr_profile_node_t *const parent = &thread->nodes[node->parent];
+
+    hr_atomic_store_u64_relaxed(&node->count, node->count + 1);
+    hr_atomic_store_u64_relaxed(&node->inclusive_ns, node->inclusive_ns + elapsed);
+    hr_atomic_store_u64_relaxed(&parent->children_ns, parent->children_ns + elapsed);
+    thread->current = node->parent;
+}
+
+/**
+ * \brief Returns the number of scopes dropped so far because a thread's tree was full.
+ */
+static inline unsigned long long hr_profile_dropped()
+{
+    unsigned long long dropped = 0;
+    for (hr_profile_thread_t *thread = (hr_profile_thread_t *)hr_atomic_load_ptr(&hr_profile_state.threads);
+         thread != NULL;
+         thread = thread->next)
+    {
+        dropped += hr_atomic_load_u64_relaxed(&thread->dropped);
+    }
+
+    return dropped;
+}
+
+/**
+ * \brief Returns the total number of tree nodes across all threads, roots excluded.
+ *
+ * An upper bound on the entries hr_profile_collect() can produce.
+ */
+static inline size_t hr_profile_node_count()
+{
+    size_t total = 0;
+    for (hr_profile_thread_t *thread = (hr_profile_thread_t *)hr_atomic_load_ptr(&hr_profile_state.threads);
+         thread != NULL;
+         thread = thread->next)
+    {
+        total += (size_t)hr_atomic_load_int(&thread->node_count) - 1;
+    }
+
+    return total;
+}
+
+/**
+ * \brief Merges every thread's call tree into \p out.
+ *
+ * Safe to call while other threads keep recording; each counter is read
+ * atomically, the tree as a whole is not. Paths are merged by callsite, so
+ * the same nesting on different threads becomes one entry. A parent always
+ * precedes its children in \p out. Paths that do not fit are skipped along
+ * with everything below them.
+ *
+ * \param out Destination array.
+ * \param capacity Number of entries \p out can hold (see hr_profile_node_count()).
+ * \return The number of entries written, or 0 on allocation failure.
+ */
+static inline size_t hr_profile_collect(hr_profile_entry_t *const out, const size_t capacity)
+{
+    if (out == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    unsigned int *const map = (unsigned int *)malloc(FLUENT_LIBC_CLOCK_PROFILE_MAX_NODES * sizeof(unsigned int));
+    if (map == NULL)
+    {
+        return 0;
+    }
+
+    size_t written = 0;
+    for (hr_profile_thread_t *thread = (hr_profile_thread_t *)hr_atomic_load_ptr(&hr_profile_state.threads);
+         thread != NULL;
+         thread = thread->next)
+    {
+        const unsigned int count = (unsigned int)hr_atomic_load_int(&thread->node_count);
+        map[0] = FLUENT_LIBC_CLOCK_PROFILE_NIL;
+        for (unsigned int i = 1; i < count; i++)
+        {
+            const hr_profile_node_t *const node = &thread->nodes[i];
+            const unsigned int parent = map[node->parent];
+            map[i] = FLUENT_LIBC_CLOCK_PROFILE_NIL;
+            if (node->parent != 0 && parent == FLUENT_LIBC_CLOCK_PROFILE_NIL)
+            {
+                continue; // Parent did not fit
+            }
+
+            size_t entry = 0;
+            while (entry < written && (out[entry].parent != parent || out[entry].callsite != node->callsite))
+            {
+                entry++;
+            }
+
+            if (entry == written)
+            {
+                if (written == capacity)
+                {
+                    continue;
+                }
+
+                out[entry].name = hr_profile_state.names[node->callsite];
+                out[entry].parent = parent;
+                out[entry].depth = parent == FLUENT_LIBC_CLOCK_PROFILE_NIL ? 0 : out[parent].depth + 1;
+                out[entry].callsite = node->callsite;
+                out[entry].count = 0;
+                out[entry].inclusive_ns = 0;
+                out[entry].exclusive_ns = 0;
+                written++;
+            }
+
+            const long long inclusive = (long long)hr_atomic_load_u64_relaxed(&node->inclusive_ns);
+            const long long children = (long long)hr_atomic_load_u64_relaxed(&node->children_ns);
+            out[entry].count += hr_atomic_load_u64_relaxed(&node->count);
+            out[entry].inclusive_ns += inclusive;
+            out[entry].exclusive_ns += inclusive > children ? inclusive - children : 0;
+            map[i] = (unsigned int)entry;
+        }
+    }
+
+    free(map);
+    return written;
+}
+
+/**
+ * \brief Writes one scope name as a folded-stack frame.
+ *
+ * ';', whitespace and control characters would split the frame or the line,
+ * so they are written as '_'.
+ */
+static inline void hr_profile_write_frame(FILE *const out, const char *const name)
+{
+    for (const unsigned char *c = (const unsigned char *)name; *c != '\0'; c++)
+    {
+        fputc(*c == ';' || *c == ' ' || *c < 0x20 || *c == 0x7F ? '_' : *c, out);
+    }
+}
+
+/**
+ * \brief Writes the merged call tree as folded stacks, the input format of flame graph tools.
+ *
+ * One line per path with non-zero exclusive time: the scope names from the
+ * outermost down, joined by ';', then a space and the exclusive time in \p unit.
+ * Names are written with hr_profile_write_frame(), so "db query;x" becomes "db_query_x".
+ *
+ * \param out The stream to write to.
+ * \param unit The unit of the reported times.
+ * \return The number of lines written, or -1 on invalid arguments or allocation failure.
+ */
+static inline long long hr_profile_write_folded(FILE *const out, const hr_clock_time_unit_t unit)
+{
+    if (out == NULL || (unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1l; // Handle null pointer or invalid unit
+    }
+
+    const size_t capacity = hr_profile_node_count();
+    if (capacity == 0)
+    {
+        return 0;
+    }
+
+    hr_profile_entry_t *const entries = (hr_profile_entry_t *)malloc(capacity * sizeof(hr_profile_entry_t));
+    unsigned int *const path = (unsigned int *)malloc(FLUENT_LIBC_CLOCK_PROFILE_MAX_NODES * sizeof(unsigned int));
+    if (entries == NULL || path == NULL)
+    {
+        free(entries);
+        free(path);
+        return -1l;
+    }
+
+    const size_t count = hr_profile_collect(entries, capacity);
+    long long lines = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const long long value = clock_nanos_to_unit_unchecked(entries[i].exclusive_ns, unit);
+        if (value <= 0)
+        {
+            continue;
+        }
+
+        unsigned int depth = 0;
+        for (unsigned int entry = (unsigned int)i; entry != FLUENT_LIBC_CLOCK_PROFILE_NIL; entry = entries[entry].parent)
+        {
+            path[depth++] = entry;
+        }
+
+        while (depth > 0)
+        {
+            hr_profile_write_frame(out, entries[path[--depth]].name);
+            fputc(depth > 0 ? ';' : ' ', out);
+        }
+
+        fprintf(out, "%lld\n", value);
+        lines++;
+    }
+
+    free(entries);
+    free(path);
+    return lines;
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+// ============= TIMED SCOPES =============
+
+#if !defined(FLUENT_LIBC_CLOCK_NO_PROFILE)
+#   define HR_TIMED_SCOPE_CONCAT_INNER(a, b) a##b
+#   define HR_TIMED_SCOPE_CONCAT(a, b) HR_TIMED_SCOPE_CONCAT_INNER(a, b)
+#   if defined(__cplusplus)
+struct hr_timed_scope_guard
+{
+    hr_timed_scope_t scope;
+    explicit hr_timed_scope_guard(const unsigned int callsite) : scope(hr_timed_scope_begin(callsite)) {}
+    ~hr_timed_scope_guard() { hr_timed_scope_end(&scope); }
+    hr_timed_scope_guard(const hr_timed_scope_guard &) = delete;
+    hr_timed_scope_guard &operator=(const hr_timed_scope_guard &) = delete;
+};
+#       define HR_TIMED_SCOPE(name) \
+    static volatile int HR_TIMED_SCOPE_CONCAT(hr_callsite_, __LINE__) = 0; \
+    hr_timed_scope_guard HR_TIMED_SCOPE_CONCAT(hr_timed_scope_, __LINE__)( \
+        hr_profile_callsite(&HR_TIMED_SCOPE_CONCAT(hr_callsite_, __LINE__), (name)))
+#   elif defined(__GNUC__) || defined(__clang__)
+#       define HR_TIMED_SCOPE(name) \
+    static volatile int HR_TIMED_SCOPE_CONCAT(hr_callsite_, __LINE__) = 0; \
+    const hr_timed_scope_t HR_TIMED_SCOPE_CONCAT(hr_timed_scope_, __LINE__) \
+        __attribute__((cleanup(hr_timed_scope_end))) = \
+        hr_timed_scope_begin(hr_profile_callsite(&HR_TIMED_SCOPE_CONCAT(hr_callsite_, __LINE__), (name)))
+#   endif
+#else
+#   define HR_TIMED_SCOPE(name) ((void)0)
+#endif // FLUENT_LIBC_CLOCK_NO_PROFILE
+
+#endif //FLUENT_LIBC_CLOCK_PROFILE_H
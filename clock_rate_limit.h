@@ -0,0 +1,381 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_RATE_LIMIT_H
+#define FLUENT_LIBC_CLOCK_RATE_LIMIT_H
+
+// ============= FLUENT LIB C =============
+// Rate Limiting Primitives
+// ----------------------------------------
+// Lock-free rate limiters keyed on the library's nanosecond timebase.
+// All refill math is whole nanoseconds per token; no floating point.
+//
+// Features:
+// - `hr_token_bucket_t`: Token bucket with burst capacity (token count + refill stamp)
+// - `hr_gcra_t`: Generic Cell Rate Algorithm, a single-word equivalent
+// - `_try_acquire_n()`: All-or-nothing batched acquire
+// - `hr_token_bucket_acquire_up_to()`: Take as many tokens as are available
+// - `_at()` variants take the current time, so callers can share one clock read
+//
+// Example:
+// ----------------------------------------
+//   hr_gcra_t limiter;
+//   hr_gcra_init(&limiter, 1000, 50, CLOCK_SOURCE_MONOTONIC_COARSE); // 1000/s, bursts of 50
+//   long long retry_after;
+//   if (!hr_gcra_try_acquire_n(&limiter, 1, &retry_after))
+//   {
+//       reject_request(retry_after);
+//   }
+//
+
+#include "clock.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \struct hr_token_bucket_t
+ * \brief Lock-free token bucket refilled at a whole number of nanoseconds per token.
+ */
+typedef struct
+{
+    volatile unsigned long long tokens; ///< Tokens currently in the bucket
+    volatile unsigned long long last;   ///< Time up to which refills were credited, in ns
+    long long interval;                 ///< Nanoseconds per token
+    unsigned long long burst;           ///< Bucket capacity
+    hr_clock_source_t source;           ///< Clock source read by the non-_at() functions
+} hr_token_bucket_t;
+
+/**
+ * \struct hr_gcra_t
+ * \brief Lock-free GCRA limiter; the whole state is one theoretical arrival time.
+ */
+typedef struct
+{
+    volatile unsigned long long tat; ///< Theoretical arrival time of the next request, in ns
+    long long interval;              ///< Emission interval: nanoseconds per token
+    long long limit;                 ///< Burst times interval: how far the TAT may run ahead
+    hr_clock_source_t source;        ///< Clock source read by the non-_at() functions
+} hr_gcra_t;
+
+/**
+ * \brief Converts a rate in tokens per second to whole nanoseconds per token.
+ *
+ * \return The interval (at least 1 ns), or 0 if the rate is 0.
+ */
+static inline long long hr_rate_limit_interval(const unsigned long long rate_per_second)
+{
+    if (rate_per_second == 0)
+    {
+        return 0;
+    }
+
+    const unsigned long long interval = 1000000000ULL / rate_per_second;
+    return interval > 0 ? (long long)interval : 1;
+}
+
+/**
+ * \brief Initializes a token bucket, initially full.
+ *
+ * \param bucket Pointer to the \p hr_token_bucket_t to initialize.
+ * \param rate_per_second Refill rate; rounded to whole nanoseconds per token (at most 1e9/s).
+ * \param burst Capacity: the most tokens that can be taken at once after an idle period.
+ * \param source Clock source read on acquire (e.g. CLOCK_SOURCE_MONOTONIC_COARSE or CLOCK_SOURCE_TSC).
+ * \return Non-zero on success, 0 if the pointer is NULL or the rate or burst is 0.
+ */
+static inline int hr_token_bucket_init(
+    hr_token_bucket_t *const bucket,
+    const unsigned long long rate_per_second,
+    const unsigned long long burst,
+    const hr_clock_source_t source
+)
+{
+    if (bucket == NULL || rate_per_second == 0 || burst == 0)
+    {
+        return 0; // Handle null pointer or invalid configuration
+    }
+
+    bucket->interval = hr_rate_limit_interval(rate_per_second);
+    bucket->burst = burst;
+    bucket->source = source;
+    hr_atomic_store_u64_relaxed(&bucket->tokens, burst);
+    hr_atomic_store_u64(&bucket->last, (unsigned long long)get_nano_time_ex(source));
+    return 1;
+}
+
+/**
+ * \brief Credits the tokens earned since the last refill.
+ *
+ * The thread that advances \p last owns the credit, so tokens are never
+ * double-counted. Time that does not add up to a whole token stays in
+ * \p last for the next refill. A full bucket discards it.
+ */
+static inline void hr_token_bucket_refill(hr_token_bucket_t *const bucket, const long long now)
+{
+    const unsigned long long last = hr_atomic_load_u64(&bucket->last);
+    if (now <= (long long)last)
+    {
+        return; // Nothing earned yet, or a reading from before another thread's refill
+    }
+
+    unsigned long long earned = (unsigned long long)(now - (long long)last) / (unsigned long long)bucket->interval;
+    if (earned == 0)
+    {
+        return;
+    }
+
+    const unsigned long long tokens = hr_atomic_load_u64_relaxed(&bucket->tokens);
+    const int saturates = earned >= bucket->burst || tokens + earned >= bucket->burst;
+    const unsigned long long next = saturates
+        ? (unsigned long long)now
+        : last + earned * (unsigned long long)bucket->interval;
+    if (!hr_atomic_cas_u64(&bucket->last, last, next))
+    {
+        return; // Another thread credited this interval
+    }
+
+    earned = earned > bucket->burst ? bucket->burst : earned;
+    unsigned long long current = hr_atomic_load_u64_relaxed(&bucket->tokens);
+    for (;;)
+    {
+        const unsigned long long filled = current + earned > bucket->burst ? bucket->burst : current + earned;
+        if (hr_atomic_cas_u64(&bucket->tokens, current, filled))
+        {
+            return;
+        }
+        current = hr_atomic_load_u64_relaxed(&bucket->tokens);
+    }
+}
+
+/**
+ * \brief Takes up to \p max tokens at time \p now.
+ *
+ * \param all_or_nothing Non-zero to take either \p max tokens or none.
+ * \return The number of tokens taken.
+ */
+static inline unsigned long long hr_token_bucket_take(
+    hr_token_bucket_t *const bucket,
+    const unsigned long long max,
+    const int all_or_nothing,
+    const long long now
+)
+{
+    hr_token_bucket_refill(bucket, now);
+    unsigned long long current = hr_atomic_load_u64_relaxed(&bucket->tokens);
+    for (;;)
+    {
+        const unsigned long long taken = current < max ? current : max;
+        if (taken == 0 || (all_or_nothing && taken < max))
+        {
+            return 0;
+        }
+
+        if (hr_atomic_cas_u64(&bucket->tokens, current, current - taken))
+        {
+            return taken;
+        }
+        current = hr_atomic_load_u64_relaxed(&bucket->tokens);
+    }
+}
+
+/**
+ * \brief Takes \p n tokens at time \p now if all of them are available.
+ *
+ * \return Non-zero if the tokens were taken, 0 otherwise (or if the pointer is NULL).
+ */
+static inline int hr_token_bucket_try_acquire_n_at(
+    hr_token_bucket_t *const bucket,
+    const unsigned long long n,
+    const long long now
+)
+{
+    if (bucket == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    return n == 0 || hr_token_bucket_take(bucket, n, 1, now) == n;
+}
+
+/**
+ * \brief Takes \p n tokens if all of them are available, reading the bucket's clock source once.
+ *
+ * \return Non-zero if the tokens were taken, 0 otherwise (or if the pointer is NULL).
+ */
+static inline int hr_token_bucket_try_acquire_n(hr_token_bucket_t *const bucket, const unsigned long long n)
+{
+    if (bucket == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    return hr_token_bucket_try_acquire_n_at(bucket, n, get_nano_time_ex(bucket->source));
+}
+
+/**
+ * \brief Takes one token if available.
+ *
+ * \return Non-zero if the token was taken, 0 otherwise (or if the pointer is NULL).
+ */
+static inline int hr_token_bucket_try_acquire(hr_token_bucket_t *const bucket)
+{
+    return hr_token_bucket_try_acquire_n(bucket, 1);
+}
+
+/**
+ * \brief Takes as many tokens as are available, up to \p max.
+ *
+ * \return The number of tokens taken, 0 if none were available or the pointer is NULL.
+ */
+static inline unsigned long long hr_token_bucket_acquire_up_to(hr_token_bucket_t *const bucket, const unsigned long long max)
+{
+    if (bucket == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    return hr_token_bucket_take(bucket, max, 0, get_nano_time_ex(bucket->source));
+}
+
+/**
+ * \brief Returns the number of tokens available right now.
+ *
+ * \return The token count, or 0 if the pointer is NULL.
+ */
+static inline unsigned long long hr_token_bucket_available(hr_token_bucket_t *const bucket)
+{
+    if (bucket == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    hr_token_bucket_refill(bucket, get_nano_time_ex(bucket->source));
+    return hr_atomic_load_u64_relaxed(&bucket->tokens);
+}
+
+/**
+ * \brief Initializes a GCRA limiter, initially allowing a full burst.
+ *
+ * \param gcra Pointer to the \p hr_gcra_t to initialize.
+ * \param rate_per_second Sustained rate; rounded to whole nanoseconds per token (at most 1e9/s).
+ * \param burst The most tokens that can be taken at once after an idle period.
+ * \param source Clock source read on acquire (e.g. CLOCK_SOURCE_MONOTONIC_COARSE or CLOCK_SOURCE_TSC).
+ * \return Non-zero on success, 0 if the pointer is NULL or the rate or burst is 0.
+ */
+static inline int hr_gcra_init(
+    hr_gcra_t *const gcra,
+    const unsigned long long rate_per_second,
+    const unsigned long long burst,
+    const hr_clock_source_t source
+)
+{
+    if (gcra == NULL || rate_per_second == 0 || burst == 0)
+    {
+        return 0; // Handle null pointer or invalid configuration
+    }
+
+    gcra->interval = hr_rate_limit_interval(rate_per_second);
+    const unsigned long long max_burst = 0x3FFFFFFFFFFFFFFFULL / (unsigned long long)gcra->interval;
+    gcra->limit = (long long)(burst < max_burst ? burst : max_burst) * gcra->interval;
+    gcra->source = source;
+    hr_atomic_store_u64(&gcra->tat, 0); // Any past TAT means "idle"
+    return 1;
+}
+
+/**
+ * \brief Takes \p n tokens at time \p now if all of them are available.
+ *
+ * \param gcra Pointer to the \p hr_gcra_t.
+ * \param n The number of tokens to take.
+ * \param now The current time of the limiter's clock source.
+ * \param retry_after Optional; on rejection receives the ns until the request would be accepted.
+ * \return Non-zero if the tokens were taken, 0 otherwise (or if the pointer is NULL).
+ */
+static inline int hr_gcra_try_acquire_n_at(
+    hr_gcra_t *const gcra,
+    const unsigned long long n,
+    const long long now,
+    long long *const retry_after
+)
+{
+    if (gcra == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    if (n > (unsigned long long)(gcra->limit / gcra->interval))
+    {
+        if (retry_after != NULL)
+        {
+            *retry_after = -1; // Can never succeed
+        }
+        return 0;
+    }
+
+    const long long cost = (long long)n * gcra->interval;
+    unsigned long long tat = hr_atomic_load_u64(&gcra->tat);
+    for (;;)
+    {
+        const long long base = (long long)tat > now ? (long long)tat : now;
+        const long long next = base + cost;
+        if (next - now > gcra->limit)
+        {
+            if (retry_after != NULL)
+            {
+                *retry_after = next - now - gcra->limit;
+            }
+            return 0;
+        }
+
+        if (hr_atomic_cas_u64(&gcra->tat, tat, (unsigned long long)next))
+        {
+            return 1;
+        }
+        tat = hr_atomic_load_u64(&gcra->tat);
+    }
+}
+
+/**
+ * \brief Takes \p n tokens if all of them are available, reading the limiter's clock source once.
+ *
+ * \param gcra Pointer to the \p hr_gcra_t.
+ * \param n The number of tokens to take.
+ * \param retry_after Optional; on rejection receives the ns until the request would be accepted, or -1 if never.
+ * \return Non-zero if the tokens were taken, 0 otherwise (or if the pointer is NULL).
+ */
+static inline int hr_gcra_try_acquire_n(hr_gcra_t *const gcra, const unsigned long long n, long long *const retry_after)
+{
+    if (gcra == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    return hr_gcra_try_acquire_n_at(gcra, n, get_nano_time_ex(gcra->source), retry_after);
+}
+
+/**
+ * \brief Takes one token if available.
+ *
+ * \return Non-zero if the token was taken, 0 otherwise (or if the pointer is NULL).
+ */
+static inline int hr_gcra_try_acquire(hr_gcra_t *const gcra)
+{
+    return hr_gcra_try_acquire_n(gcra, 1, NULL);
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_RATE_LIMIT_H
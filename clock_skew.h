@@ -0,0 +1,402 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_SKEW_H
+#define FLUENT_LIBC_CLOCK_SKEW_H
+
+// ============= FLUENT LIB C =============
+// Cross-CPU Timestamp Consistency
+// ----------------------------------------
+// Checks that stamps taken on different CPUs can be compared. A thread pinned
+// to each CPU plays ping-pong with one pinned to the reference CPU; every
+// hand-off brackets the remote stamp between two local ones, which bounds
+// the offset between the two clocks and catches stamps that go backwards.
+//
+// Features:
+// - `hr_clock_skew_measure()`: Offset bounds and violations for one CPU pair
+// - `hr_clock_verify_sync()`: Checks every CPU the caller may run on against the first and, for
+//   the TSC sources, records the verdict the TSC backend consults
+// - `hr_clock_set_source_verified()`: Verify, then select the source if safe
+//
+// Example:
+// ----------------------------------------
+//   hr_clock_skew_report_t report;
+//   if (hr_clock_set_source_verified(CLOCK_SOURCE_TSC, 0, &report) != CLOCK_SOURCE_TSC)
+//   {
+//       fprintf(stderr, "TSC skew %lld ns on CPU %d\n", report.max_skew_ns, report.worst_cpu);
+//   }
+//
+
+#include "clock.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SKEW_ROUNDS
+ * \brief Default number of ping-pong rounds per CPU.
+ */
+#ifndef FLUENT_LIBC_CLOCK_SKEW_ROUNDS
+#   define FLUENT_LIBC_CLOCK_SKEW_ROUNDS 2000
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SKEW_THRESHOLD_NS
+ * \brief Largest provable offset between two CPUs still considered consistent.
+ */
+#ifndef FLUENT_LIBC_CLOCK_SKEW_THRESHOLD_NS
+#   define FLUENT_LIBC_CLOCK_SKEW_THRESHOLD_NS 1000LL
+#endif
+
+/**
+ * \struct hr_clock_skew_pair_t
+ * \brief Offset of one CPU's clock relative to the reference CPU's.
+ *
+ * The offset is only known to lie in [offset_low_ns, offset_high_ns]; the
+ * bracket narrows to the fastest cache-line round trip observed.
+ */
+typedef struct
+{
+    int cpu;                        ///< CPU whose clock was compared
+    int pinned;                     ///< Non-zero if both threads were pinned as requested
+    long long offset_low_ns;        ///< Lower bound of the offset
+    long long offset_high_ns;       ///< Upper bound of the offset
+    long long round_trip_ns;        ///< Fastest round trip, in reference-CPU time
+    unsigned long long rounds;      ///< Completed ping-pong rounds
+    unsigned long long violations;  ///< Rounds whose remote stamp fell outside its local bracket
+} hr_clock_skew_pair_t;
+
+/**
+ * \struct hr_clock_skew_report_t
+ * \brief Result of hr_clock_verify_sync().
+ */
+typedef struct
+{
+    hr_clock_source_t source;      ///< Source that was checked
+    int cpus;                      ///< CPUs compared, including the reference
+    int unchecked;                 ///< CPUs that could not be compared (helper not started, or thread not pinned)
+    int reference_cpu;             ///< CPU all others were compared against, or -1
+    int worst_cpu;                 ///< CPU with the largest provable offset, or -1
+    long long max_skew_ns;         ///< Largest offset between any two CPUs that exceeds the measurement error
+    long long max_uncertainty_ns;  ///< Widest offset bracket (half-width) over all CPUs
+    unsigned long long violations; ///< Stamps that went backwards across a hand-off, over all CPUs
+    int consistent;                ///< Non-zero if every CPU was compared, with no violations and max_skew_ns <= FLUENT_LIBC_CLOCK_SKEW_THRESHOLD_NS
+} hr_clock_skew_report_t;
+
+/**
+ * \struct hr_clock_skew_channel_t
+ * \brief Hand-off state shared by the two ping-pong threads; the flag has a cache line to itself.
+ */
+typedef struct
+{
+    volatile int turn;               ///< 2r+1: reference pinged round r; 2r+2: remote answered
+    char turn_pad[64 - sizeof(int)];
+    volatile unsigned long long stamp; ///< Remote stamp of the current round
+    hr_clock_source_t source;        ///< Source both sides read
+    unsigned long long rounds;       ///< Rounds to play
+    int cpu;                         ///< CPU the remote thread pins itself to
+    volatile int pinned;             ///< Set by the remote thread if pinning succeeded
+} hr_clock_skew_channel_t;
+
+/**
+ * \brief Spins until \p turn reaches \p value, yielding if the peer is not running.
+ */
+static inline void hr_clock_skew_wait(const volatile int *const turn, const int value)
+{
+    unsigned int spins = 0;
+    while (hr_atomic_load_int(turn) != value)
+    {
+        if (++spins < 4096)
+        {
+            hr_cpu_relax();
+        }
+        else
+        {
+            hr_thread_yield(); // Peer is probably descheduled (oversubscribed CPU)
+        }
+    }
+}
+
+/**
+ * \brief Remote side: answers every ping with a stamp taken on its own CPU.
+ */
+static inline void hr_clock_skew_remote_main(void *const arg)
+{
+    hr_clock_skew_channel_t *const channel = (hr_clock_skew_channel_t *)arg;
+    hr_atomic_store_int(&channel->pinned, hr_thread_pin_cpu(channel->cpu));
+
+    for (unsigned long long round = 0; round < channel->rounds; round++)
+    {
+        hr_clock_skew_wait(&channel->turn, (int)(2 * round + 1));
+        hr_atomic_store_u64_relaxed(&channel->stamp, (unsigned long long)get_nano_time_ex(channel->source));
+        hr_atomic_store_int(&channel->turn, (int)(2 * round + 2));
+    }
+}
+
+/**
+ * \brief Gives the calling thread back the CPU set it had before it pinned itself.
+ *
+ * \param saved The set read before pinning, or NULL if it could not be read.
+ * \param pinned Whether the thread actually pinned itself.
+ */
+static inline void hr_clock_skew_restore_affinity(const hr_cpu_set_t *const saved, const int pinned)
+{
+    if (saved != NULL)
+    {
+        hr_thread_set_affinity(saved);
+    }
+    else if (pinned)
+    {
+        hr_thread_unpin(); // Best effort without a saved set
+    }
+}
+
+/**
+ * \brief Measures the offset of \p cpu's clock relative to \p reference_cpu's.
+ *
+ * The calling thread pins itself to \p reference_cpu (its own affinity is
+ * restored afterwards); a helper thread pins itself to \p cpu. For each round the
+ * caller reads t1, pings, the helper reads t2 and answers, and the caller
+ * reads t3. Causality requires t1 <= t2 <= t3 if the clocks agree, so the
+ * offset lies in [t2 - t3, t2 - t1]; rounds breaking that order are counted
+ * as violations. The result only means something if \p out->pinned is set.
+ *
+ * CLOCK_SOURCE_TSC is measured with the ordered CLOCK_SOURCE_TSCP read, so a
+ * speculatively early rdtsc is not mistaken for skew.
+ *
+ * \param reference_cpu The CPU to compare against.
+ * \param cpu The CPU to check.
+ * \param source The time source to check.
+ * \param rounds Ping-pong rounds, or 0 for FLUENT_LIBC_CLOCK_SKEW_ROUNDS.
+ * \param out Receives the measurement.
+ * \return Non-zero on success, 0 if \p out is NULL or the helper thread could not start.
+ */
+static inline int hr_clock_skew_measure(
+    const int reference_cpu,
+    const int cpu,
+    const hr_clock_source_t source,
+    const unsigned long long rounds,
+    hr_clock_skew_pair_t *const out
+)
+{
+    if (out == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    hr_clock_skew_channel_t channel;
+    memset(&channel, 0, sizeof(channel));
+    channel.source = source == CLOCK_SOURCE_TSC ? CLOCK_SOURCE_TSCP : source;
+    channel.rounds = rounds != 0 ? rounds : FLUENT_LIBC_CLOCK_SKEW_ROUNDS;
+    channel.cpu = cpu;
+
+    memset(out, 0, sizeof(*out));
+    out->cpu = cpu;
+    out->offset_low_ns = -0x7FFFFFFFFFFFFFFFLL - 1;
+    out->offset_high_ns = 0x7FFFFFFFFFFFFFFFLL;
+    out->round_trip_ns = 0x7FFFFFFFFFFFFFFFLL;
+
+    hr_cpu_set_t saved;
+    const int restore = hr_thread_get_affinity(&saved);
+    const int pinned = hr_thread_pin_cpu(reference_cpu);
+    (void)get_nano_time_ex(channel.source); // Calibrate / fault in before the helper starts
+
+    hr_thread_t remote;
+    if (!hr_thread_create(&remote, hr_clock_skew_remote_main, &channel))
+    {
+        hr_clock_skew_restore_affinity(restore ? &saved : NULL, pinned);
+        return 0;
+    }
+
+    for (unsigned long long round = 0; round < channel.rounds; round++)
+    {
+        const long long t1 = get_nano_time_ex(channel.source);
+        hr_atomic_store_int(&channel.turn, (int)(2 * round + 1));
+        hr_clock_skew_wait(&channel.turn, (int)(2 * round + 2));
+        const long long t3 = get_nano_time_ex(channel.source);
+        const long long t2 = (long long)hr_atomic_load_u64_relaxed(&channel.stamp);
+
+        out->violations += t2 < t1 || t3 < t2;
+        if (t2 - t3 > out->offset_low_ns)
+        {
+            out->offset_low_ns = t2 - t3;
+        }
+
+        if (t2 - t1 < out->offset_high_ns)
+        {
+            out->offset_high_ns = t2 - t1;
+        }
+
+        if (t3 - t1 < out->round_trip_ns)
+        {
+            out->round_trip_ns = t3 - t1;
+        }
+    }
+
+    hr_thread_join(&remote);
+    hr_clock_skew_restore_affinity(restore ? &saved : NULL, pinned);
+
+    out->rounds = channel.rounds;
+    out->pinned = pinned && channel.pinned;
+    return 1;
+}
+
+/**
+ * \brief Checks that \p source gives consistent stamps on every CPU.
+ *
+ * Each CPU the caller may run on (see hr_thread_get_affinity()) is measured
+ * against the first of them with hr_clock_skew_measure(). A CPU whose
+ * measurement could not pin both threads is not checked, and the result is
+ * then not consistent: two unpinned threads may share one CPU. The provable offset between any two CPUs i and j is how far their offset
+ * brackets are apart, max(0, low_i - high_j), which filters out the
+ * cache-line latency that makes each bracket wide.
+ *
+ * For CLOCK_SOURCE_TSC / _TSCP the verdict is also recorded with
+ * hr_clock_tsc_report_sync() when there is one: measured skew or violations
+ * disable the TSC backend for the rest of the process, a complete clean check
+ * marks it verified, and an incomplete check records nothing. Takes roughly rounds x CPUs x one cache-line round trip;
+ * run it once at startup, before selecting the TSC.
+ *
+ * \param source The time source to check.
+ * \param rounds Ping-pong rounds per CPU, or 0 for FLUENT_LIBC_CLOCK_SKEW_ROUNDS.
+ * \param report Receives the summary; may be NULL if only the verdict matters.
+ * \return Non-zero if the stamps are consistent across all CPUs.
+ */
+static inline int hr_clock_verify_sync(
+    const hr_clock_source_t source,
+    const unsigned long long rounds,
+    hr_clock_skew_report_t *const report
+)
+{
+    hr_clock_skew_report_t summary;
+    memset(&summary, 0, sizeof(summary));
+    summary.source = source;
+    summary.worst_cpu = -1;
+    summary.reference_cpu = -1;
+
+    const int tsc = source == CLOCK_SOURCE_TSC || source == CLOCK_SOURCE_TSCP;
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    if (tsc && !hr_clock_tsc_calibrate())
+#else
+    if (tsc)
+#endif
+    {
+        // No usable counter: nothing to verify, and nothing to fall back from
+        if (report != NULL)
+        {
+            *report = summary;
+        }
+        return 0;
+    }
+
+    hr_cpu_set_t allowed;
+    const int reference = hr_thread_get_affinity(&allowed) ? hr_cpu_set_next(&allowed, -1) : -1;
+    if (reference < 0)
+    {
+        // Affinity unknown: no pair could be pinned, so nothing can be checked
+        summary.unchecked = hr_cpu_count();
+        if (report != NULL)
+        {
+            *report = summary;
+        }
+        return 0;
+    }
+
+    // The reference CPU has offset 0 in [0, 0]
+    summary.reference_cpu = reference;
+    long long highest_low = 0, lowest_high = 0;
+    int highest_low_cpu = reference, lowest_high_cpu = reference;
+    summary.cpus = 1;
+
+    for (int cpu = hr_cpu_set_next(&allowed, reference); cpu >= 0; cpu = hr_cpu_set_next(&allowed, cpu))
+    {
+        hr_clock_skew_pair_t pair;
+        if (!hr_clock_skew_measure(reference, cpu, source, rounds, &pair) || !pair.pinned)
+        {
+            summary.unchecked++; // Could not check this CPU
+            continue;
+        }
+
+        summary.cpus++;
+        summary.violations += pair.violations;
+        if ((pair.offset_high_ns - pair.offset_low_ns) / 2 > summary.max_uncertainty_ns)
+        {
+            summary.max_uncertainty_ns = (pair.offset_high_ns - pair.offset_low_ns) / 2;
+        }
+
+        if (pair.offset_low_ns > highest_low)
+        {
+            highest_low = pair.offset_low_ns;
+            highest_low_cpu = cpu;
+        }
+
+        if (pair.offset_high_ns < lowest_high)
+        {
+            lowest_high = pair.offset_high_ns;
+            lowest_high_cpu = cpu;
+        }
+    }
+
+    if (highest_low > lowest_high)
+    {
+        summary.max_skew_ns = highest_low - lowest_high;
+        summary.worst_cpu = highest_low_cpu != reference ? highest_low_cpu : lowest_high_cpu;
+    }
+
+    const int skewed = summary.violations != 0 || summary.max_skew_ns > FLUENT_LIBC_CLOCK_SKEW_THRESHOLD_NS;
+    summary.consistent = !skewed && summary.unchecked == 0;
+
+#ifdef FLUENT_LIBC_CLOCK_HAS_TSC
+    if (tsc && (skewed || summary.consistent))
+    {
+        hr_clock_tsc_report_sync(summary.consistent); // Only a real verdict is recorded
+    }
+#endif
+
+    if (report != NULL)
+    {
+        *report = summary;
+    }
+    return summary.consistent;
+}
+
+/**
+ * \brief Verifies \p source across CPUs and selects it for get_nano_time() if consistent.
+ *
+ * \param source The desired time source.
+ * \param rounds Ping-pong rounds per CPU, or 0 for FLUENT_LIBC_CLOCK_SKEW_ROUNDS.
+ * \param report Receives the verification summary; may be NULL.
+ * \return The source in effect afterwards: \p source, or the previous one if the check failed
+ *         (CLOCK_SOURCE_MONOTONIC for a failed TSC check).
+ */
+static inline hr_clock_source_t hr_clock_set_source_verified(
+    const hr_clock_source_t source,
+    const unsigned long long rounds,
+    hr_clock_skew_report_t *const report
+)
+{
+    if (!hr_clock_verify_sync(source, rounds, report))
+    {
+        return hr_clock_get_source();
+    }
+
+    return hr_clock_set_source(source);
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_SKEW_H
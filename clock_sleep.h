@@ -0,0 +1,296 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_SLEEP_H
+#define FLUENT_LIBC_CLOCK_SLEEP_H
+
+// ============= FLUENT LIB C =============
+// High-Precision Sleep
+// ----------------------------------------
+// OS sleeps overshoot by tens of microseconds (Linux timer slack) up to a
+// whole millisecond (Windows). These helpers sleep coarsely until shortly
+// before the deadline and spin on `get_nano_time()` for the final stretch.
+//
+// Features:
+// - `hr_sleep_until()`: Sleep until an absolute `get_nano_time()` deadline
+// - `hr_sleep_for()`: Sleep for a duration in any `hr_clock_time_unit_t`
+// - `hr_sleep_set_spin_threshold()`: Tune the sleep / spin crossover
+// - `hr_sleep_calibrate()`: Learn this host's sleep overshoot and set the crossover
+//
+// Example:
+// ----------------------------------------
+//   hr_sleep_calibrate(NULL);
+//   long long next = get_nano_time();
+//   for (;;)
+//   {
+//       next += 20000; // One packet every 20 µs
+//       hr_sleep_until(next);
+//       send_packet();
+//   }
+//
+
+#include <errno.h>
+#include "clock.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SLEEP_SPIN_NS
+ * \brief Default crossover: the final stretch before a deadline that is spun instead of slept.
+ */
+#ifndef FLUENT_LIBC_CLOCK_SLEEP_SPIN_NS
+#   ifdef _WIN32
+#       define FLUENT_LIBC_CLOCK_SLEEP_SPIN_NS 1500000LL // 1.5 ms, covers the default timer resolution
+#   else
+#       define FLUENT_LIBC_CLOCK_SLEEP_SPIN_NS 100000LL  // 100 µs, twice the default timer slack
+#   endif
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_SAMPLES
+ * \brief Number of OS sleeps hr_sleep_calibrate() measures.
+ */
+#ifndef FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_SAMPLES
+#   define FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_SAMPLES 33
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_NS
+ * \brief Length of each OS sleep hr_sleep_calibrate() measures.
+ */
+#ifndef FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_NS
+#   define FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_NS 200000LL
+#endif
+
+#if defined(_WIN32) && !defined(FLUENT_LIBC_NO_WINDOWS_SDK) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#   define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002 // Windows 10 1803+
+#endif
+
+/**
+ * \struct hr_sleep_calibration_t
+ * \brief Measured overshoot of the OS sleep primitive, in nanoseconds.
+ */
+typedef struct
+{
+    long long overshoot_min;    ///< Smallest observed overshoot
+    long long overshoot_median; ///< Median observed overshoot
+    long long overshoot_max;    ///< Largest observed overshoot
+    long long spin_threshold;   ///< Crossover chosen from the measurements
+} hr_sleep_calibration_t;
+
+/**
+ * \brief Process-wide sleep / spin crossover in nanoseconds.
+ */
+FLUENT_LIBC_CLOCK_GLOBAL volatile unsigned long long hr_sleep_spin_ns = (unsigned long long)FLUENT_LIBC_CLOCK_SLEEP_SPIN_NS;
+
+#if defined(_WIN32) && !defined(FLUENT_LIBC_NO_WINDOWS_SDK)
+/**
+ * \brief Per-thread waitable timer, created on first use and kept for the thread's lifetime.
+ */
+FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL HANDLE hr_sleep_thread_timer = NULL;
+#endif
+
+/**
+ * \brief Sets the final stretch before a deadline that is spun instead of slept.
+ *
+ * 0 makes every sleep a pure spin; a negative value restores the default.
+ *
+ * \param nanos The crossover in nanoseconds.
+ */
+static inline void hr_sleep_set_spin_threshold(const long long nanos)
+{
+    const long long value = nanos < 0 ? FLUENT_LIBC_CLOCK_SLEEP_SPIN_NS : nanos;
+    hr_atomic_store_u64_relaxed(&hr_sleep_spin_ns, (unsigned long long)value);
+}
+
+/**
+ * \brief Returns the current sleep / spin crossover in nanoseconds.
+ */
+static inline long long hr_sleep_get_spin_threshold()
+{
+    return (long long)hr_atomic_load_u64_relaxed(&hr_sleep_spin_ns);
+}
+
+/**
+ * \brief Blocks in the OS until roughly \p deadline on the monotonic timeline.
+ *
+ * May return early on Windows if no timer could be created, and late by the
+ * OS wake-up latency everywhere; callers spin for the remainder.
+ *
+ * \param deadline The absolute wake-up time in monotonic nanoseconds.
+ */
+static inline void hr_sleep_os_until(const long long deadline)
+{
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+    if (hr_sleep_thread_timer == NULL)
+    {
+        hr_sleep_thread_timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (hr_sleep_thread_timer == NULL)
+        {
+            hr_sleep_thread_timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS); // Pre-1803
+        }
+    }
+
+    const long long remaining = deadline - hr_clock_monotonic_nanos();
+    if (remaining <= 0)
+    {
+        return;
+    }
+
+    LARGE_INTEGER due;
+    due.QuadPart = -(remaining / 100); // Relative, in 100 ns units
+    if (hr_sleep_thread_timer == NULL || due.QuadPart == 0
+        || !SetWaitableTimer(hr_sleep_thread_timer, &due, 0, NULL, NULL, FALSE))
+    {
+        Sleep((DWORD)(remaining / 1000000LL)); // Rounds down; the spin covers the rest
+        return;
+    }
+
+    WaitForSingleObject(hr_sleep_thread_timer, INFINITE);
+#   else
+    (void)deadline;
+#   endif
+#elif defined(TIMER_ABSTIME) && !defined(__APPLE__)
+    if (deadline <= 0)
+    {
+        return;
+    }
+
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline / 1000000000LL);
+    ts.tv_nsec = (long)(deadline % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+        // Absolute deadlines make retrying after a signal exact
+    }
+#else
+    hr_thread_sleep_nanos(deadline - hr_clock_monotonic_nanos());
+#endif
+}
+
+/**
+ * \brief Sleeps until \p deadline, then spins for the final stretch.
+ *
+ * Deadlines further away than the spin threshold are slept in the OS
+ * (clock_nanosleep with TIMER_ABSTIME on POSIX, a high-resolution waitable
+ * timer on Windows) until the spin threshold before the deadline. The rest is spun
+ * on get_nano_time() with a `pause` / `yield` hint.
+ *
+ * The OS sleeps on the monotonic clock, so the remaining time is carried over
+ * to that timeline from a reading of both clocks; this works for every source,
+ * whatever its epoch (BOOTTIME, TSC). CPU-time sources only advance while the
+ * thread runs, so with one selected the whole wait is spun.
+ *
+ * \param deadline The absolute deadline on the get_nano_time() timeline.
+ * \return How late the call returned, in nanoseconds (0 or more).
+ */
+static inline long long hr_sleep_until(const long long deadline)
+{
+    long long now = get_nano_time();
+    const long long threshold = hr_sleep_get_spin_threshold();
+    if (deadline - now > threshold && hr_clock_get_source() < CLOCK_SOURCE_THREAD_CPUTIME)
+    {
+        hr_sleep_os_until(hr_clock_monotonic_nanos() + (deadline - threshold - now));
+        now = get_nano_time();
+    }
+
+    while (now < deadline)
+    {
+        hr_cpu_relax();
+        now = get_nano_time();
+    }
+
+    return now - deadline;
+}
+
+/**
+ * \brief Sleeps for \p duration, then spins for the final stretch (see hr_sleep_until()).
+ *
+ * \param duration The duration to sleep.
+ * \param unit The unit of \p duration (see \p hr_clock_time_unit_t).
+ * \return How late the call returned in nanoseconds, or -1 if the unit is invalid.
+ */
+static inline long long hr_sleep_for(const long long duration, const hr_clock_time_unit_t unit)
+{
+    if ((unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1l; // Invalid unit
+    }
+
+    const long long start = get_nano_time();
+    const long long length = hr_clock_unit_nanos[unit];
+    if (duration <= 0)
+    {
+        return 0;
+    }
+
+    // Saturate instead of overflowing the deadline
+    const long long limit = 0x7FFFFFFFFFFFFFFFLL - (start > 0 ? start : 0);
+    const long long nanos = duration > limit / length ? limit : duration * length;
+    return hr_sleep_until(start + nanos);
+}
+
+/**
+ * \brief Measures how far the OS sleep overshoots on this host and sets the spin threshold.
+ *
+ * Takes FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_SAMPLES OS sleeps of
+ * FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_NS each (about 10 ms in total). The new
+ * threshold is the worst overshoot plus 25%, so the coarse sleep practically
+ * never wakes after the deadline.
+ *
+ * \param out Optional pointer receiving the measurements (may be NULL).
+ * \return The new spin threshold in nanoseconds.
+ */
+static inline long long hr_sleep_calibrate(hr_sleep_calibration_t *const out)
+{
+    long long overshoots[FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_SAMPLES];
+    hr_sleep_os_until(hr_clock_monotonic_nanos() + FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_NS); // Create the timer, settle
+    for (int i = 0; i < FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_SAMPLES; i++)
+    {
+        const long long deadline = hr_clock_monotonic_nanos() + FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_NS;
+        hr_sleep_os_until(deadline);
+        long long overshoot = hr_clock_monotonic_nanos() - deadline;
+        overshoot = overshoot < 0 ? 0 : overshoot; // Early wake-ups (Windows fallback) are spun anyway
+
+        // Insertion sort as we go; the sample count is small
+        int j = i;
+        for (; j > 0 && overshoots[j - 1] > overshoot; j--)
+        {
+            overshoots[j] = overshoots[j - 1];
+        }
+        overshoots[j] = overshoot;
+    }
+
+    hr_sleep_calibration_t result;
+    result.overshoot_min = overshoots[0];
+    result.overshoot_median = overshoots[FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_SAMPLES / 2];
+    result.overshoot_max = overshoots[FLUENT_LIBC_CLOCK_SLEEP_CALIBRATION_SAMPLES - 1];
+    result.spin_threshold = result.overshoot_max + result.overshoot_max / 4;
+    hr_sleep_set_spin_threshold(result.spin_threshold);
+    if (out != NULL)
+    {
+        *out = result;
+    }
+
+    return result.spin_threshold;
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_SLEEP_H
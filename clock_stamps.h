@@ -0,0 +1,866 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_STAMPS_H
+#define FLUENT_LIBC_CLOCK_STAMPS_H
+
+// ============= FLUENT LIB C =============
+// Compact Timestamp Files
+// ----------------------------------------
+// Streams raw get_nano_time() samples to disk as zigzag-varint deltas,
+// typically 1-3 bytes per stamp instead of 8, in blocks indexed by their
+// time range. Files are read through a memory mapping: blocks decode
+// straight from the mapped pages and range queries skip whole blocks.
+//
+// File layout (all integers little-endian):
+//   header  "HRSTAMP1", u32 version, u32 block size, u32 source, u32 reserved
+//   blocks  i64 first stamp, u32 count, u32 payload bytes, then count - 1
+//           zigzag varint deltas
+//   index   per block: i64 min, i64 max, u64 file offset, u32 count, u32 reserved
+//   trailer u64 index offset, u64 blocks, u64 stamps, "HRSTIDX1"
+//
+// Features:
+// - `hr_stamp_writer_open()` / `_append()` / `_close()`: Streaming writer
+// - `hr_stamp_reader_open()`: Zero-copy reader over a read-only mapping
+// - `hr_stamp_reader_seek()` / `_next()`: Iterate from a point in time
+// - `hr_stamp_reader_range()`: Copy out the stamps within [from, to]
+//
+// Example:
+// ----------------------------------------
+//   hr_stamp_writer_t writer;
+//   hr_stamp_writer_open(&writer, "stamps.bin", hr_clock_get_source(), 0);
+//   for (...) hr_stamp_writer_append(&writer, get_nano_time());
+//   hr_stamp_writer_close(&writer);
+//
+//   hr_stamp_reader_t reader;
+//   long long stamp;
+//   hr_stamp_reader_open(&reader, "stamps.bin");
+//   hr_stamp_reader_seek(&reader, from);
+//   while (hr_stamp_reader_next(&reader, &stamp) && stamp <= to) { ... }
+//   hr_stamp_reader_close(&reader);
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "clock.h"
+
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+#       include <windows.h>
+#   endif // FLUENT_LIBC_NO_WINDOWS_SDK
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_STAMP_BLOCK
+ * \brief Default number of stamps per block (the seek granularity).
+ */
+#ifndef FLUENT_LIBC_CLOCK_STAMP_BLOCK
+#   define FLUENT_LIBC_CLOCK_STAMP_BLOCK 4096
+#endif
+
+#define HR_STAMP_VERSION 1
+#define HR_STAMP_HEADER_SIZE 24
+#define HR_STAMP_BLOCK_HEADER_SIZE 16
+#define HR_STAMP_INDEX_ENTRY_SIZE 32
+#define HR_STAMP_TRAILER_SIZE 32
+#define HR_STAMP_VARINT_MAX 10 ///< Longest varint of a 64-bit value
+
+/**
+ * \struct hr_stamp_block_t
+ * \brief Index entry of one block.
+ */
+typedef struct
+{
+    long long min;             ///< Smallest stamp in the block
+    long long max;             ///< Largest stamp in the block
+    unsigned long long offset; ///< File offset of the block header
+    unsigned int count;        ///< Stamps in the block
+} hr_stamp_block_t;
+
+/**
+ * \struct hr_stamp_writer_t
+ * \brief Streaming writer; one block is buffered in memory and written when full.
+ */
+typedef struct
+{
+    FILE *file;                 ///< Output file
+    unsigned char *payload;     ///< Encoded deltas of the current block
+    size_t payload_size;        ///< Bytes used in \p payload
+    unsigned int block_size;    ///< Stamps per block
+    unsigned int block_count;   ///< Stamps in the current block
+    long long block_first;      ///< First stamp of the current block
+    long long previous;         ///< Last appended stamp
+    long long block_min;        ///< Smallest stamp of the current block
+    long long block_max;        ///< Largest stamp of the current block
+    hr_stamp_block_t *index;    ///< Entries of the completed blocks
+    size_t index_count;         ///< Completed blocks
+    size_t index_capacity;      ///< Allocated entries in \p index
+    unsigned long long offset;  ///< Bytes written so far
+    unsigned long long total;   ///< Stamps appended so far
+    int failed;                 ///< Non-zero once a write or allocation failed
+} hr_stamp_writer_t;
+
+/**
+ * \struct hr_stamp_reader_t
+ * \brief Reader over a mapped (or caller-provided) timestamp file, with an iteration cursor.
+ */
+typedef struct
+{
+    const unsigned char *data;     ///< Start of the file contents
+    size_t size;                   ///< Size of \p data in bytes
+    const unsigned char *index;    ///< Start of the index, inside \p data
+    unsigned long long blocks;     ///< Number of blocks
+    unsigned long long count;      ///< Number of stamps
+    unsigned int block_size;       ///< Stamps per full block
+    hr_clock_source_t source;      ///< Source the stamps were read from
+    int ordered;                   ///< Non-zero if block maxima never decrease, so seeks can bisect
+    unsigned long long block;      ///< Cursor: block being iterated
+    const unsigned char *cursor;   ///< Cursor: next varint in the block
+    const unsigned char *end;      ///< Cursor: end of the block payload
+    unsigned int remaining;        ///< Cursor: stamps left in the block
+    int first;                     ///< Cursor: the block's raw first stamp is next
+    long long previous;            ///< Cursor: last stamp returned
+    void *mapping;                 ///< Mapping handle to release, or NULL for caller-provided memory
+} hr_stamp_reader_t;
+
+// ============= ENCODING =============
+
+/**
+ * \brief Stores \p value as \p bytes little-endian bytes.
+ */
+static inline void hr_stamp_put_le(unsigned char *const out, unsigned long long value, const int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        out[i] = (unsigned char)value;
+        value >>= 8;
+    }
+}
+
+/**
+ * \brief Loads \p bytes little-endian bytes.
+ */
+static inline unsigned long long hr_stamp_get_le(const unsigned char *const in, const int bytes)
+{
+    unsigned long long value = 0;
+    for (int i = bytes - 1; i >= 0; i--)
+    {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+/**
+ * \brief Maps a signed delta to an unsigned one with small magnitudes first (0, -1, 1, -2, ...).
+ */
+static inline unsigned long long hr_stamp_zigzag(const long long delta)
+{
+    return ((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63);
+}
+
+/**
+ * \brief Inverse of hr_stamp_zigzag().
+ */
+static inline long long hr_stamp_unzigzag(const unsigned long long value)
+{
+    return (long long)((value >> 1) ^ (0 - (value & 1)));
+}
+
+/**
+ * \brief Encodes \p value as a LEB128 varint.
+ *
+ * \return The number of bytes written (1 to HR_STAMP_VARINT_MAX).
+ */
+static inline size_t hr_stamp_put_varint(unsigned char *const out, unsigned long long value)
+{
+    size_t length = 0;
+    while (value >= 0x80)
+    {
+        out[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (unsigned char)value;
+    return length;
+}
+
+/**
+ * \brief Decodes a LEB128 varint, refusing to read past \p end.
+ *
+ * \return The position after the varint, or NULL if it is truncated or too long.
+ */
+static inline const unsigned char *hr_stamp_get_varint(
+    const unsigned char *in,
+    const unsigned char *const end,
+    unsigned long long *const value
+)
+{
+    // Fast path: most deltas between neighbouring stamps fit in one or two bytes
+    if (end - in >= 2)
+    {
+        if (in[0] < 0x80)
+        {
+            *value = in[0];
+            return in + 1;
+        }
+
+        if (in[1] < 0x80)
+        {
+            *value = (unsigned long long)(in[0] & 0x7F) | ((unsigned long long)in[1] << 7);
+            return in + 2;
+        }
+    }
+
+    unsigned long long result = 0;
+    for (int shift = 0; shift < 64 && in < end; shift += 7)
+    {
+        const unsigned char byte = *in++;
+        result |= (unsigned long long)(byte & 0x7F) << shift;
+        if (byte < 0x80)
+        {
+            *value = result;
+            return in;
+        }
+    }
+
+    return NULL; // Truncated or overlong
+}
+
+// ============= WRITER =============
+
+/**
+ * \brief Writes \p size bytes, recording failure.
+ */
+static inline void hr_stamp_writer_write(hr_stamp_writer_t *const writer, const void *const data, const size_t size)
+{
+    if (!writer->failed && fwrite(data, 1, size, writer->file) != size)
+    {
+        writer->failed = 1;
+    }
+    writer->offset += size;
+}
+
+/**
+ * \brief Creates (or truncates) a timestamp file.
+ *
+ * \param writer Pointer to the \p hr_stamp_writer_t to initialize.
+ * \param path Path of the file to write.
+ * \param source The source the stamps come from, stored in the header.
+ * \param block_size Stamps per block, or 0 for FLUENT_LIBC_CLOCK_STAMP_BLOCK.
+ * \return Non-zero on success, 0 if a pointer is NULL, the file could not be created or memory ran out.
+ */
+static inline int hr_stamp_writer_open(
+    hr_stamp_writer_t *const writer,
+    const char *const path,
+    const hr_clock_source_t source,
+    const unsigned int block_size
+)
+{
+    if (writer == NULL || path == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    writer->block_size = block_size != 0 ? block_size : FLUENT_LIBC_CLOCK_STAMP_BLOCK;
+    writer->payload = (unsigned char *)malloc((size_t)writer->block_size * HR_STAMP_VARINT_MAX);
+    if (writer->payload == NULL)
+    {
+        return 0; // Out of memory
+    }
+
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL)
+    {
+        free(writer->payload);
+        writer->payload = NULL;
+        return 0;
+    }
+
+    unsigned char header[HR_STAMP_HEADER_SIZE];
+    memcpy(header, "HRSTAMP1", 8);
+    hr_stamp_put_le(header + 8, HR_STAMP_VERSION, 4);
+    hr_stamp_put_le(header + 12, writer->block_size, 4);
+    hr_stamp_put_le(header + 16, (unsigned long long)source, 4);
+    hr_stamp_put_le(header + 20, 0, 4);
+    hr_stamp_writer_write(writer, header, sizeof(header));
+    return !writer->failed;
+}
+
+/**
+ * \brief Writes the buffered block and adds it to the index.
+ */
+static inline void hr_stamp_writer_flush_block(hr_stamp_writer_t *const writer)
+{
+    if (writer->block_count == 0)
+    {
+        return; // Nothing buffered
+    }
+
+    if (writer->index_count == writer->index_capacity)
+    {
+        const size_t capacity = writer->index_capacity != 0 ? writer->index_capacity * 2 : 64;
+        hr_stamp_block_t *const index = (hr_stamp_block_t *)realloc(writer->index, capacity * sizeof(hr_stamp_block_t));
+        if (index == NULL)
+        {
+            writer->failed = 1; // Out of memory; the block is dropped
+            writer->block_count = 0;
+            writer->payload_size = 0;
+            return;
+        }
+        writer->index = index;
+        writer->index_capacity = capacity;
+    }
+
+    hr_stamp_block_t *const entry = &writer->index[writer->index_count++];
+    entry->min = writer->block_min;
+    entry->max = writer->block_max;
+    entry->offset = writer->offset;
+    entry->count = writer->block_count;
+
+    unsigned char header[HR_STAMP_BLOCK_HEADER_SIZE];
+    hr_stamp_put_le(header, (unsigned long long)writer->block_first, 8);
+    hr_stamp_put_le(header + 8, writer->block_count, 4);
+    hr_stamp_put_le(header + 12, (unsigned long long)writer->payload_size, 4);
+    hr_stamp_writer_write(writer, header, sizeof(header));
+    hr_stamp_writer_write(writer, writer->payload, writer->payload_size);
+
+    writer->block_count = 0;
+    writer->payload_size = 0;
+}
+
+/**
+ * \brief Appends one stamp.
+ *
+ * Stamps need not be sorted; out-of-order stamps just cost a few more bytes
+ * and widen their block's time range.
+ *
+ * \param writer Pointer to an open \p hr_stamp_writer_t.
+ * \param stamp The timestamp in nanoseconds.
+ * \return Non-zero on success, 0 if the pointer is NULL or the writer has failed.
+ */
+static inline int hr_stamp_writer_append(hr_stamp_writer_t *const writer, const long long stamp)
+{
+    if (writer == NULL || writer->file == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    if (writer->block_count == 0)
+    {
+        writer->block_first = stamp;
+        writer->block_min = stamp;
+        writer->block_max = stamp;
+    }
+    else
+    {
+        // Wrapping subtraction: the zigzag of the modular delta round-trips exactly
+        const long long delta = (long long)((unsigned long long)stamp - (unsigned long long)writer->previous);
+        writer->payload_size += hr_stamp_put_varint(writer->payload + writer->payload_size, hr_stamp_zigzag(delta));
+        writer->block_min = stamp < writer->block_min ? stamp : writer->block_min;
+        writer->block_max = stamp > writer->block_max ? stamp : writer->block_max;
+    }
+
+    writer->previous = stamp;
+    writer->total++;
+    if (++writer->block_count == writer->block_size)
+    {
+        hr_stamp_writer_flush_block(writer);
+    }
+
+    return !writer->failed;
+}
+
+/**
+ * \brief Appends \p n stamps.
+ *
+ * \return Non-zero on success, 0 if a pointer is NULL or the writer has failed.
+ */
+static inline int hr_stamp_writer_append_batch(
+    hr_stamp_writer_t *const writer,
+    const long long *const stamps,
+    const size_t n
+)
+{
+    if (writer == NULL || stamps == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        hr_stamp_writer_append(writer, stamps[i]);
+    }
+
+    return !writer->failed;
+}
+
+/**
+ * \brief Flushes the last block, writes the index and trailer, and closes the file.
+ *
+ * \param writer Pointer to an open \p hr_stamp_writer_t.
+ * \return Non-zero if the whole file was written successfully.
+ */
+static inline int hr_stamp_writer_close(hr_stamp_writer_t *const writer)
+{
+    if (writer == NULL || writer->file == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    hr_stamp_writer_flush_block(writer);
+
+    const unsigned long long index_offset = writer->offset;
+    for (size_t i = 0; i < writer->index_count; i++)
+    {
+        unsigned char entry[HR_STAMP_INDEX_ENTRY_SIZE];
+        hr_stamp_put_le(entry, (unsigned long long)writer->index[i].min, 8);
+        hr_stamp_put_le(entry + 8, (unsigned long long)writer->index[i].max, 8);
+        hr_stamp_put_le(entry + 16, writer->index[i].offset, 8);
+        hr_stamp_put_le(entry + 24, writer->index[i].count, 4);
+        hr_stamp_put_le(entry + 28, 0, 4);
+        hr_stamp_writer_write(writer, entry, sizeof(entry));
+    }
+
+    unsigned char trailer[HR_STAMP_TRAILER_SIZE];
+    hr_stamp_put_le(trailer, index_offset, 8);
+    hr_stamp_put_le(trailer + 8, (unsigned long long)writer->index_count, 8);
+    hr_stamp_put_le(trailer + 16, writer->total, 8);
+    memcpy(trailer + 24, "HRSTIDX1", 8);
+    hr_stamp_writer_write(writer, trailer, sizeof(trailer));
+
+    if (fclose(writer->file) != 0)
+    {
+        writer->failed = 1;
+    }
+
+    free(writer->payload);
+    free(writer->index);
+    writer->file = NULL;
+    writer->payload = NULL;
+    writer->index = NULL;
+    return !writer->failed;
+}
+
+// ============= READER =============
+
+/**
+ * \brief Opens a timestamp file held in memory; the memory must outlive the reader.
+ *
+ * The header, trailer and index are validated; block payloads are checked
+ * as they are decoded. The cursor starts before the first stamp, so
+ * hr_stamp_reader_next() iterates the whole file without a seek.
+ *
+ * \param reader Pointer to the \p hr_stamp_reader_t to initialize.
+ * \param data The file contents.
+ * \param size Size of \p data in bytes.
+ * \return Non-zero on success, 0 if a pointer is NULL or the contents are not a valid timestamp file.
+ */
+static inline int hr_stamp_reader_open_memory(hr_stamp_reader_t *const reader, const void *const data, const size_t size)
+{
+    if (reader == NULL || data == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+    memset(reader, 0, sizeof(*reader));
+    const unsigned char *const bytes = (const unsigned char *)data;
+    if (size < HR_STAMP_HEADER_SIZE + HR_STAMP_TRAILER_SIZE
+        || memcmp(bytes, "HRSTAMP1", 8) != 0
+        || hr_stamp_get_le(bytes + 8, 4) != HR_STAMP_VERSION
+        || memcmp(bytes + size - 8, "HRSTIDX1", 8) != 0)
+    {
+        return 0; // Not a (complete) timestamp file
+    }
+
+    const unsigned char *const trailer = bytes + size - HR_STAMP_TRAILER_SIZE;
+    const unsigned long long index_offset = hr_stamp_get_le(trailer, 8);
+    const unsigned long long blocks = hr_stamp_get_le(trailer + 8, 8);
+    const unsigned long long index_limit = (unsigned long long)(size - HR_STAMP_TRAILER_SIZE);
+    if (index_offset < HR_STAMP_HEADER_SIZE
+        || index_offset > index_limit
+        || blocks > (index_limit - index_offset) / HR_STAMP_INDEX_ENTRY_SIZE)
+    {
+        return 0; // Index out of bounds
+    }
+
+    reader->data = bytes;
+    reader->size = size;
+    reader->index = bytes + index_offset;
+    reader->blocks = blocks;
+    reader->count = hr_stamp_get_le(trailer + 16, 8);
+    reader->block_size = (unsigned int)hr_stamp_get_le(bytes + 12, 4);
+    reader->source = (hr_clock_source_t)hr_stamp_get_le(bytes + 16, 4);
+    reader->block = (unsigned long long)-1; // next() enters block 0
+    reader->ordered = 1;
+    for (unsigned long long block = 1; block < blocks && reader->ordered; block++)
+    {
+        const unsigned char *const entry = reader->index + block * HR_STAMP_INDEX_ENTRY_SIZE;
+        reader->ordered = (long long)hr_stamp_get_le(entry + 8, 8) >= (long long)hr_stamp_get_le(entry + 8 - HR_STAMP_INDEX_ENTRY_SIZE, 8);
+    }
+    return 1;
+}
+
+/**
+ * \brief Maps a timestamp file read-only and opens it.
+ *
+ * \param reader Pointer to the \p hr_stamp_reader_t to initialize.
+ * \param path Path of the file.
+ * \return Non-zero on success, 0 if a pointer is NULL, mapping failed or the file is invalid.
+ */
+static inline int hr_stamp_reader_open(hr_stamp_reader_t *const reader, const char *const path)
+{
+    if (reader == NULL || path == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+#if defined(_WIN32)
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0;
+#   else
+    const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return 0;
+    }
+
+    LARGE_INTEGER size;
+    const HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0
+        ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL)
+        : NULL;
+    CloseHandle(file); // The mapping keeps the file open
+    if (mapping == NULL)
+    {
+        return 0;
+    }
+
+    const void *const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // The view keeps the mapping alive
+    if (view == NULL)
+    {
+        return 0;
+    }
+
+    if (!hr_stamp_reader_open_memory(reader, view, (size_t)size.QuadPart))
+    {
+        UnmapViewOfFile(view);
+        return 0;
+    }
+
+    reader->mapping = (void *)view;
+    return 1;
+#   endif
+#else
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    struct stat info;
+    void *view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd); // The mapping keeps the file referenced
+    if (view == MAP_FAILED)
+    {
+        return 0;
+    }
+
+    if (!hr_stamp_reader_open_memory(reader, view, (size_t)info.st_size))
+    {
+        munmap(view, (size_t)info.st_size);
+        return 0;
+    }
+
+    reader->mapping = view;
+    return 1;
+#endif
+}
+
+/**
+ * \brief Releases the mapping of a reader opened with hr_stamp_reader_open().
+ */
+static inline void hr_stamp_reader_close(hr_stamp_reader_t *const reader)
+{
+    if (reader == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    if (reader->mapping != NULL)
+    {
+#if defined(_WIN32)
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+        UnmapViewOfFile(reader->mapping);
+#   endif
+#else
+        munmap(reader->mapping, reader->size);
+#endif
+    }
+
+    memset(reader, 0, sizeof(*reader));
+}
+
+/**
+ * \brief Reads the index entry of block \p block.
+ *
+ * \return Non-zero on success, 0 if a pointer is NULL or \p block is out of range.
+ */
+static inline int hr_stamp_reader_block(
+    const hr_stamp_reader_t *const reader,
+    const unsigned long long block,
+    hr_stamp_block_t *const out
+)
+{
+    if (reader == NULL || out == NULL || block >= reader->blocks)
+    {
+        return 0; // Handle null pointers / out of range
+    }
+
+    const unsigned char *const entry = reader->index + block * HR_STAMP_INDEX_ENTRY_SIZE;
+    out->min = (long long)hr_stamp_get_le(entry, 8);
+    out->max = (long long)hr_stamp_get_le(entry + 8, 8);
+    out->offset = hr_stamp_get_le(entry + 16, 8);
+    out->count = (unsigned int)hr_stamp_get_le(entry + 24, 4);
+    return 1;
+}
+
+/**
+ * \brief Points the cursor at the start of block \p block.
+ *
+ * \return Non-zero on success, 0 if the block is out of range or corrupt.
+ */
+static inline int hr_stamp_reader_enter_block(hr_stamp_reader_t *const reader, const unsigned long long block)
+{
+    hr_stamp_block_t entry;
+    reader->block = block;
+    reader->remaining = 0;
+    if (!hr_stamp_reader_block(reader, block, &entry)
+        || entry.offset < HR_STAMP_HEADER_SIZE
+        || entry.offset > (unsigned long long)(reader->index - reader->data) - HR_STAMP_BLOCK_HEADER_SIZE)
+    {
+        reader->block = reader->blocks;
+        return 0;
+    }
+
+    const unsigned char *const header = reader->data + entry.offset;
+    const unsigned long long payload = hr_stamp_get_le(header + 12, 4);
+    if (payload > (unsigned long long)(reader->index - header) - HR_STAMP_BLOCK_HEADER_SIZE)
+    {
+        reader->block = reader->blocks;
+        return 0; // Payload overruns the index
+    }
+
+    reader->cursor = header + HR_STAMP_BLOCK_HEADER_SIZE;
+    reader->end = reader->cursor + payload;
+    reader->remaining = (unsigned int)hr_stamp_get_le(header + 8, 4);
+    reader->previous = (long long)hr_stamp_get_le(header, 8);
+    reader->first = 1;
+    return 1;
+}
+
+/**
+ * \brief Returns the next stamp and advances the cursor across blocks.
+ *
+ * \param reader Pointer to the \p hr_stamp_reader_t.
+ * \param stamp Receives the stamp.
+ * \return Non-zero if a stamp was returned, 0 at the end (or on a corrupt block).
+ */
+static inline int hr_stamp_reader_next(hr_stamp_reader_t *const reader, long long *const stamp)
+{
+    if (reader == NULL || stamp == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+    while (reader->remaining == 0)
+    {
+        if (reader->block + 1 >= reader->blocks || !hr_stamp_reader_enter_block(reader, reader->block + 1))
+        {
+            reader->block = reader->blocks;
+            return 0; // End of file
+        }
+    }
+
+    if (reader->first)
+    {
+        reader->first = 0;
+        reader->remaining--;
+        *stamp = reader->previous; // The block's first stamp is stored raw
+        return 1;
+    }
+
+    unsigned long long zigzag;
+    const unsigned char *const next = hr_stamp_get_varint(reader->cursor, reader->end, &zigzag);
+    if (next == NULL)
+    {
+        reader->remaining = 0;
+        reader->block = reader->blocks;
+        return 0; // Corrupt payload
+    }
+
+    reader->cursor = next;
+    reader->remaining--;
+    reader->previous = (long long)((unsigned long long)reader->previous + (unsigned long long)hr_stamp_unzigzag(zigzag));
+    *stamp = reader->previous;
+    return 1;
+}
+
+/**
+ * \brief Positions the cursor at the first block that may hold stamps at or after \p from.
+ *
+ * Only the index is consulted: a binary search when block maxima never
+ * decrease (stamps appended in time order), a scan otherwise, so out-of-order
+ * files work too. hr_stamp_reader_next() then returns every stamp from that
+ * block on, so callers filter the first block's earlier stamps.
+ *
+ * \param reader Pointer to the \p hr_stamp_reader_t.
+ * \param from The earliest stamp of interest, in nanoseconds.
+ * \return Non-zero if such a block exists, 0 otherwise (the cursor is then at the end).
+ */
+static inline int hr_stamp_reader_seek(hr_stamp_reader_t *const reader, const long long from)
+{
+    if (reader == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    unsigned long long found = reader->blocks;
+    hr_stamp_block_t entry;
+    if (reader->ordered)
+    {
+        // First block whose max reaches from
+        unsigned long long low = 0, high = reader->blocks;
+        while (low < high)
+        {
+            const unsigned long long middle = low + (high - low) / 2;
+            if (hr_stamp_reader_block(reader, middle, &entry) && entry.max >= from)
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle + 1;
+            }
+        }
+        found = low;
+    }
+    else
+    {
+        for (unsigned long long block = 0; block < reader->blocks && found == reader->blocks; block++)
+        {
+            if (hr_stamp_reader_block(reader, block, &entry) && entry.max >= from)
+            {
+                found = block;
+            }
+        }
+    }
+
+    reader->remaining = 0;
+    if (found == reader->blocks)
+    {
+        reader->block = reader->blocks;
+        return 0;
+    }
+
+    reader->block = found - 1; // Just before the block; next() enters it
+    return 1;
+}
+
+/**
+ * \brief Rewinds the cursor to the first stamp.
+ */
+static inline void hr_stamp_reader_rewind(hr_stamp_reader_t *const reader)
+{
+    if (reader == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    reader->block = (unsigned long long)-1; // next() enters block 0
+    reader->remaining = 0;
+}
+
+/**
+ * \brief Copies the stamps within [\p from, \p to] in file order, skipping blocks outside the range.
+ *
+ * \param reader Pointer to the \p hr_stamp_reader_t (its cursor is moved).
+ * \param from The earliest stamp to copy.
+ * \param to The latest stamp to copy.
+ * \param out Destination array, or NULL to only count.
+ * \param capacity Capacity of \p out.
+ * \return The number of matching stamps, which may exceed \p capacity (only \p capacity are copied).
+ */
+static inline unsigned long long hr_stamp_reader_range(
+    hr_stamp_reader_t *const reader,
+    const long long from,
+    const long long to,
+    long long *const out,
+    const size_t capacity
+)
+{
+    if (reader == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    unsigned long long matched = 0;
+    for (unsigned long long block = 0; block < reader->blocks; block++)
+    {
+        hr_stamp_block_t entry;
+        if (!hr_stamp_reader_block(reader, block, &entry) || entry.max < from || entry.min > to)
+        {
+            continue; // Entirely outside the range
+        }
+
+        if (!hr_stamp_reader_enter_block(reader, block))
+        {
+            break; // Corrupt block
+        }
+
+        // Decode only this block: stop before next() would move on
+        long long stamp;
+        while (reader->remaining != 0 && hr_stamp_reader_next(reader, &stamp))
+        {
+            if (stamp >= from && stamp <= to)
+            {
+                if (out != NULL && matched < capacity)
+                {
+                    out[matched] = stamp;
+                }
+                matched++;
+            }
+        }
+    }
+
+    return matched;
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_STAMPS_H
@@ -0,0 +1,611 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_STATS_H
+#define FLUENT_LIBC_CLOCK_STATS_H
+
+// ============= FLUENT LIB C =============
+// Streaming Duration Statistics
+// ----------------------------------------
+// Running count / mean / variance (Welford), min / max and a time-decayed
+// EWMA of durations, in O(1) per sample. Each thread owns its accumulator
+// and updates it without locks; collectors take seqlock snapshots and merge
+// them (Chan et al.), so per-thread instances combine exactly.
+//
+// Features:
+// - `hr_duration_stats_add()` / `_add_at()` / `_record()`: One sample
+// - `hr_duration_stats_add_batch()`: Bulk ingestion (AVX2 min / max / sum / sum of squares)
+// - `hr_duration_stats_snapshot()` / `_merge()`: Combine per-thread instances
+// - `hr_duration_stats_mean()` / `_stddev()` / `_ewma()` / `_bound()`: Results in any unit
+//
+// Example:
+// ----------------------------------------
+//   static FLUENT_LIBC_CLOCK_THREAD_LOCAL hr_duration_stats_t rtt;
+//   hr_duration_stats_init(&rtt, 10, CLOCK_SECONDS); // EWMA half-life: 10 s
+//   hr_clock_t clk;
+//   hr_clock_tick(&clk);
+//   // ... request ...
+//   hr_duration_stats_record(&rtt, &clk);
+//   double timeout_ms = hr_duration_stats_bound(&rtt, 4.0, CLOCK_MILLISECONDS);
+//
+
+#include <math.h>
+#include <string.h>
+#include "clock.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_STATS_CHUNK
+ * \brief Samples reduced at a time by hr_duration_stats_add_batch().
+ */
+#ifndef FLUENT_LIBC_CLOCK_STATS_CHUNK
+#   define FLUENT_LIBC_CLOCK_STATS_CHUNK 1024
+#endif
+
+/**
+ * \struct hr_duration_stats_t
+ * \brief Streaming statistics of durations in nanoseconds.
+ *
+ * Only the owning thread may add samples; other threads read it through
+ * hr_duration_stats_snapshot() / hr_duration_stats_merge().
+ */
+typedef struct
+{
+    volatile unsigned long long sequence; ///< Seqlock counter, odd while the owner is writing
+    unsigned long long count;             ///< Number of samples
+    double mean;                          ///< Mean in nanoseconds
+    double m2;                            ///< Sum of squared deviations from the mean (ns^2)
+    long long min;                        ///< Smallest sample
+    long long max;                        ///< Largest sample
+    double ewma_sum;                      ///< Decayed sum of samples
+    double ewma_weight;                   ///< Decayed number of samples
+    long long ewma_time;                  ///< Time the EWMA terms were decayed to, in nanoseconds
+    double half_life_ns;                  ///< EWMA half-life in nanoseconds
+} hr_duration_stats_t;
+
+/**
+ * \brief Initializes an empty accumulator.
+ *
+ * \param stats Pointer to the \p hr_duration_stats_t to initialize.
+ * \param half_life EWMA half-life: a sample's weight halves every \p half_life.
+ * \param unit The unit of \p half_life (see \p hr_clock_time_unit_t).
+ * \return Non-zero on success, 0 if the pointer is NULL, the half-life is not positive or the unit is invalid.
+ */
+static inline int hr_duration_stats_init(
+    hr_duration_stats_t *const stats,
+    const long long half_life,
+    const hr_clock_time_unit_t unit
+)
+{
+    if (stats == NULL || half_life <= 0 || (unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return 0; // Handle null pointer / invalid configuration
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->min = 0x7FFFFFFFFFFFFFFFLL;
+    stats->max = -0x7FFFFFFFFFFFFFFFLL - 1;
+    stats->half_life_ns = (double)half_life * (double)hr_clock_unit_nanos[unit];
+    return 1;
+}
+
+/**
+ * \brief Marks the start of an update by the owning thread.
+ */
+static inline void hr_duration_stats_write_begin(hr_duration_stats_t *const stats)
+{
+    hr_atomic_store_u64_relaxed(&stats->sequence, stats->sequence + 1);
+    hr_atomic_fence_release();
+}
+
+/**
+ * \brief Publishes an update started with hr_duration_stats_write_begin().
+ */
+static inline void hr_duration_stats_write_end(hr_duration_stats_t *const stats)
+{
+    hr_atomic_store_u64(&stats->sequence, stats->sequence + 1);
+}
+
+/**
+ * \brief Adds a decayed sum / weight observed at \p at to the EWMA terms.
+ *
+ * The terms are decayed forward to \p at first; a contribution older than
+ * the terms is decayed instead, so out-of-order merges stay exact.
+ */
+static inline void hr_duration_stats_ewma_push(
+    hr_duration_stats_t *const stats,
+    double sum,
+    double weight,
+    const long long at
+)
+{
+    if (stats->ewma_weight == 0.0)
+    {
+        stats->ewma_time = at;
+    }
+    else if (at > stats->ewma_time)
+    {
+        const double decay = exp2(-(double)(at - stats->ewma_time) / stats->half_life_ns);
+        stats->ewma_sum *= decay;
+        stats->ewma_weight *= decay;
+        stats->ewma_time = at;
+    }
+    else if (at < stats->ewma_time)
+    {
+        const double decay = exp2(-(double)(stats->ewma_time - at) / stats->half_life_ns);
+        sum *= decay;
+        weight *= decay;
+    }
+
+    stats->ewma_sum += sum;
+    stats->ewma_weight += weight;
+}
+
+/**
+ * \brief Folds the moments of another sample set into \p stats (Chan et al.).
+ */
+static inline void hr_duration_stats_fold(
+    hr_duration_stats_t *const stats,
+    const unsigned long long count,
+    const double mean,
+    const double m2,
+    const long long min,
+    const long long max
+)
+{
+    if (count == 0)
+    {
+        return; // Nothing to fold
+    }
+
+    const double total = (double)stats->count + (double)count;
+    const double delta = mean - stats->mean;
+    stats->m2 += m2 + delta * delta * (double)stats->count * (double)count / total;
+    stats->mean += delta * (double)count / total;
+    stats->count += count;
+    stats->min = min < stats->min ? min : stats->min;
+    stats->max = max > stats->max ? max : stats->max;
+}
+
+/**
+ * \brief Adds one sample that completed at \p now.
+ *
+ * \param stats Pointer to the owning thread's \p hr_duration_stats_t.
+ * \param nanos The duration in nanoseconds.
+ * \param now When the sample was taken (get_nano_time() timeline), for the EWMA.
+ */
+static inline void hr_duration_stats_add_at(hr_duration_stats_t *const stats, const long long nanos, const long long now)
+{
+    if (stats == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    hr_duration_stats_write_begin(stats);
+
+    // Welford: one division per sample, no catastrophic cancellation
+    const double value = (double)nanos;
+    const double delta = value - stats->mean;
+    stats->count++;
+    stats->mean += delta / (double)stats->count;
+    stats->m2 += delta * (value - stats->mean);
+    stats->min = nanos < stats->min ? nanos : stats->min;
+    stats->max = nanos > stats->max ? nanos : stats->max;
+    hr_duration_stats_ewma_push(stats, value, 1.0, now);
+
+    hr_duration_stats_write_end(stats);
+}
+
+/**
+ * \brief Adds one sample taken now.
+ *
+ * Reads get_nano_time() for the EWMA; prefer hr_duration_stats_add_at() or
+ * hr_duration_stats_record() when a timestamp is already at hand.
+ */
+static inline void hr_duration_stats_add(hr_duration_stats_t *const stats, const long long nanos)
+{
+    hr_duration_stats_add_at(stats, nanos, get_nano_time());
+}
+
+/**
+ * \brief Adds the time elapsed since hr_clock_tick(), with a single clock read.
+ *
+ * \param stats Pointer to the owning thread's \p hr_duration_stats_t.
+ * \param clock Pointer to the started \p hr_clock_t.
+ * \return The recorded duration in nanoseconds, or -1 if any pointer is NULL.
+ */
+static inline long long hr_duration_stats_record(hr_duration_stats_t *const stats, const hr_clock_t *const clock)
+{
+    if (stats == NULL || clock == NULL)
+    {
+        return -1l; // Handle null pointers
+    }
+
+    const long long now = get_nano_time_ex(hr_clock_source_of(clock));
+    const long long elapsed = now - clock->start_time;
+    hr_duration_stats_add_at(stats, elapsed, now);
+    return elapsed;
+}
+
+#if defined(__AVX2__)
+/**
+ * \brief Min / max / sum of four lanes per iteration with AVX2.
+ *
+ * \return The number of elements reduced (a multiple of four).
+ */
+static inline size_t hr_duration_stats_reduce_avx2(
+    const long long *const in,
+    const size_t n,
+    long long *const min,
+    long long *const max,
+    unsigned long long *const sum
+)
+{
+    if (n < 4)
+    {
+        return 0;
+    }
+
+    __m256i lo = _mm256_set1_epi64x(*min);
+    __m256i hi = _mm256_set1_epi64x(*max);
+    __m256i total = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i value = _mm256_loadu_si256((const __m256i *)(in + i));
+        lo = _mm256_blendv_epi8(lo, value, _mm256_cmpgt_epi64(lo, value));
+        hi = _mm256_blendv_epi8(hi, value, _mm256_cmpgt_epi64(value, hi));
+        total = _mm256_add_epi64(total, value);
+    }
+
+    long long lanes_lo[4], lanes_hi[4], lanes_sum[4];
+    _mm256_storeu_si256((__m256i *)lanes_lo, lo);
+    _mm256_storeu_si256((__m256i *)lanes_hi, hi);
+    _mm256_storeu_si256((__m256i *)lanes_sum, total);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        *min = lanes_lo[lane] < *min ? lanes_lo[lane] : *min;
+        *max = lanes_hi[lane] > *max ? lanes_hi[lane] : *max;
+        *sum += (unsigned long long)lanes_sum[lane];
+    }
+
+    return i;
+}
+
+/**
+ * \brief Sum of squared deviations from \p center, four lanes per iteration with AVX2.
+ *
+ * AVX2 cannot convert 64-bit integers to doubles, so each deviation (known
+ * to be below 2^51 in magnitude) is added to the bit pattern of 1.5 * 2^52
+ * and the bias is subtracted back as a double.
+ *
+ * \return The number of elements processed (a multiple of four).
+ */
+static inline size_t hr_duration_stats_squares_avx2(
+    const long long *const in,
+    const size_t n,
+    const long long center,
+    double *const squares
+)
+{
+    if (n < 4)
+    {
+        return 0;
+    }
+
+    const __m256i center_v = _mm256_set1_epi64x(center);
+    const __m256i bias = _mm256_set1_epi64x(0x4338000000000000LL);
+    const __m256d bias_d = _mm256_set1_pd(6755399441055744.0); // 1.5 * 2^52
+    __m256d total = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i deviation = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i *)(in + i)), center_v);
+        const __m256d value = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(deviation, bias)), bias_d);
+        total = _mm256_add_pd(total, _mm256_mul_pd(value, value));
+    }
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, total);
+    *squares += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    return i;
+}
+#endif // __AVX2__
+
+/**
+ * \brief Adds a chunk of at most FLUENT_LIBC_CLOCK_STATS_CHUNK samples.
+ */
+static inline void hr_duration_stats_add_chunk(
+    hr_duration_stats_t *const stats,
+    const long long *const samples,
+    const size_t n,
+    const long long now
+)
+{
+    // Pass 1: min / max / exact integer sum
+    long long min = 0x7FFFFFFFFFFFFFFFLL, max = -0x7FFFFFFFFFFFFFFFLL - 1;
+    unsigned long long wrapped_sum = 0; // Modular, exact once the range check below passes
+    size_t i = 0;
+#if defined(__AVX2__)
+    i += hr_duration_stats_reduce_avx2(samples, n, &min, &max, &wrapped_sum);
+#endif
+    for (; i < n; i++)
+    {
+        min = samples[i] < min ? samples[i] : min;
+        max = samples[i] > max ? samples[i] : max;
+        wrapped_sum += (unsigned long long)samples[i];
+    }
+
+    // The fast path needs an exact sum (|x| <= 2^52, n <= 2^10) and deviations below 2^51
+    if (min < -(1LL << 52) || max > (1LL << 52) || max - min >= (1LL << 51))
+    {
+        for (i = 0; i < n; i++)
+        {
+            const double value = (double)samples[i];
+            const double delta = value - stats->mean;
+            stats->count++;
+            stats->mean += delta / (double)stats->count;
+            stats->m2 += delta * (value - stats->mean);
+            stats->min = samples[i] < stats->min ? samples[i] : stats->min;
+            stats->max = samples[i] > stats->max ? samples[i] : stats->max;
+            hr_duration_stats_ewma_push(stats, value, 1.0, now);
+        }
+        return;
+    }
+
+    // Pass 2: squared deviations from the integer mean, then correct for its rounding
+    const long long sum = (long long)wrapped_sum;
+    const long long center = sum / (long long)n;
+    const long long remainder = sum - center * (long long)n; // Exact sum of deviations
+    double squares = 0.0;
+    i = 0;
+#if defined(__AVX2__)
+    i += hr_duration_stats_squares_avx2(samples, n, center, &squares);
+#endif
+    for (; i < n; i++)
+    {
+        const double deviation = (double)(samples[i] - center);
+        squares += deviation * deviation;
+    }
+
+    const double shift = (double)remainder / (double)n;
+    hr_duration_stats_fold(stats, n, (double)center + shift, squares - (double)remainder * shift, min, max);
+    hr_duration_stats_ewma_push(stats, (double)sum, (double)n, now);
+}
+
+/**
+ * \brief Adds many samples at once, e.g. durations recorded earlier.
+ *
+ * Samples are reduced in chunks (min / max / sum, then squared deviations,
+ * with AVX2 when available) and folded in with the parallel-variance
+ * formula, which gives the same moments as adding them one by one.
+ * For the EWMA all samples count as taken at \p now.
+ *
+ * \param stats Pointer to the owning thread's \p hr_duration_stats_t.
+ * \param samples Array of \p n durations in nanoseconds.
+ * \param n Number of samples.
+ * \param now When the samples were taken (get_nano_time() timeline).
+ */
+static inline void hr_duration_stats_add_batch(
+    hr_duration_stats_t *const stats,
+    const long long *const samples,
+    const size_t n,
+    const long long now
+)
+{
+    if (stats == NULL || samples == NULL)
+    {
+        return; // Handle null pointers
+    }
+
+    hr_duration_stats_write_begin(stats);
+    for (size_t done = 0; done < n; done += FLUENT_LIBC_CLOCK_STATS_CHUNK)
+    {
+        const size_t chunk = n - done < FLUENT_LIBC_CLOCK_STATS_CHUNK ? n - done : FLUENT_LIBC_CLOCK_STATS_CHUNK;
+        hr_duration_stats_add_chunk(stats, samples + done, chunk, now);
+    }
+    hr_duration_stats_write_end(stats);
+}
+
+/**
+ * \brief Takes a consistent copy of an accumulator another thread may be updating.
+ *
+ * Lock-free: retries while the owner is mid-update, never blocks it.
+ *
+ * \param stats Pointer to the source \p hr_duration_stats_t.
+ * \param out Receives the copy (with an even, stable sequence).
+ * \return Non-zero on success, 0 if any pointer is NULL.
+ */
+static inline int hr_duration_stats_snapshot(const hr_duration_stats_t *const stats, hr_duration_stats_t *const out)
+{
+    if (stats == NULL || out == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+    for (;;)
+    {
+        const unsigned long long before = hr_atomic_load_u64(&stats->sequence);
+        if (before & 1)
+        {
+            hr_cpu_relax();
+            continue; // Writer in progress
+        }
+
+        memcpy(out, (const void *)stats, sizeof(*out));
+        hr_atomic_fence_acquire();
+        if (hr_atomic_load_u64_relaxed(&stats->sequence) == before)
+        {
+            out->sequence = 0;
+            return 1;
+        }
+    }
+}
+
+/**
+ * \brief Merges \p other (e.g. another thread's accumulator) into \p stats.
+ *
+ * \p other is read through hr_duration_stats_snapshot(), so its owner may
+ * keep adding samples. \p stats must be owned by the caller; its half-life is kept.
+ *
+ * \param stats Pointer to the destination \p hr_duration_stats_t.
+ * \param other Pointer to the \p hr_duration_stats_t to merge in.
+ */
+static inline void hr_duration_stats_merge(hr_duration_stats_t *const stats, const hr_duration_stats_t *const other)
+{
+    hr_duration_stats_t copy;
+    if (stats == NULL || stats == other || !hr_duration_stats_snapshot(other, &copy))
+    {
+        return; // Handle null pointers / self-merge
+    }
+
+    hr_duration_stats_write_begin(stats);
+    hr_duration_stats_fold(stats, copy.count, copy.mean, copy.m2, copy.min, copy.max);
+    if (copy.ewma_weight > 0.0)
+    {
+        hr_duration_stats_ewma_push(stats, copy.ewma_sum, copy.ewma_weight, copy.ewma_time);
+    }
+    hr_duration_stats_write_end(stats);
+}
+
+/**
+ * \brief Returns the number of samples.
+ */
+static inline unsigned long long hr_duration_stats_count(const hr_duration_stats_t *const stats)
+{
+    return stats != NULL ? stats->count : 0;
+}
+
+/**
+ * \brief Returns the mean in \p unit, 0 if empty, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline double hr_duration_stats_mean(const hr_duration_stats_t *const stats, const hr_clock_time_unit_t unit)
+{
+    if (stats == NULL || (unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1.0; // Handle null pointer / invalid unit
+    }
+
+    return stats->mean / (double)hr_clock_unit_nanos[unit];
+}
+
+/**
+ * \brief Returns the sample variance (n - 1 denominator) in \p unit squared.
+ *
+ * \return The variance, 0 with fewer than two samples, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline double hr_duration_stats_variance(const hr_duration_stats_t *const stats, const hr_clock_time_unit_t unit)
+{
+    if (stats == NULL || (unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1.0; // Handle null pointer / invalid unit
+    }
+
+    if (stats->count < 2)
+    {
+        return 0.0;
+    }
+
+    const double length = (double)hr_clock_unit_nanos[unit];
+    const double variance = stats->m2 / (double)(stats->count - 1);
+    return (variance > 0.0 ? variance : 0.0) / (length * length);
+}
+
+/**
+ * \brief Returns the sample standard deviation in \p unit, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline double hr_duration_stats_stddev(const hr_duration_stats_t *const stats, const hr_clock_time_unit_t unit)
+{
+    const double variance = hr_duration_stats_variance(stats, unit);
+    return variance < 0.0 ? -1.0 : sqrt(variance);
+}
+
+/**
+ * \brief Returns the smallest sample in \p unit, 0 if empty, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_duration_stats_min(const hr_duration_stats_t *const stats, const hr_clock_time_unit_t unit)
+{
+    if (stats == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    return clock_nanos_to_unit(stats->count != 0 ? stats->min : 0, unit);
+}
+
+/**
+ * \brief Returns the largest sample in \p unit, 0 if empty, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_duration_stats_max(const hr_duration_stats_t *const stats, const hr_clock_time_unit_t unit)
+{
+    if (stats == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    return clock_nanos_to_unit(stats->count != 0 ? stats->max : 0, unit);
+}
+
+/**
+ * \brief Returns the time-decayed mean in \p unit.
+ *
+ * Samples are weighted by 2^(-age / half-life); with no new samples the
+ * value stays put, since decay scales every weight alike.
+ *
+ * \return The EWMA, 0 if empty, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline double hr_duration_stats_ewma(const hr_duration_stats_t *const stats, const hr_clock_time_unit_t unit)
+{
+    if (stats == NULL || (unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1.0; // Handle null pointer / invalid unit
+    }
+
+    if (stats->ewma_weight <= 0.0)
+    {
+        return 0.0;
+    }
+
+    return stats->ewma_sum / stats->ewma_weight / (double)hr_clock_unit_nanos[unit];
+}
+
+/**
+ * \brief Returns EWMA + \p sigmas x stddev in \p unit, e.g. an adaptive timeout.
+ *
+ * \return The bound, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline double hr_duration_stats_bound(
+    const hr_duration_stats_t *const stats,
+    const double sigmas,
+    const hr_clock_time_unit_t unit
+)
+{
+    if (stats == NULL || (unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return -1.0; // Handle null pointer / invalid unit
+    }
+
+    return hr_duration_stats_ewma(stats, unit) + sigmas * hr_duration_stats_stddev(stats, unit);
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_STATS_H
@@ -0,0 +1,257 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_STOPWATCH_H
+#define FLUENT_LIBC_CLOCK_STOPWATCH_H
+
+// ============= FLUENT LIB C =============
+// Accumulating / Lap Stopwatch
+// ----------------------------------------
+// A stopwatch that can be paused and resumed, and splits laps with a
+// single clock read each: the timestamp ending one lap starts the next.
+//
+// Features:
+// - `hr_stopwatch_start()`: Reset and start running
+// - `hr_stopwatch_pause()` / `hr_stopwatch_resume()`: Exclude time from the measurement
+// - `hr_stopwatch_lap()`: End the current lap and start the next one
+// - `hr_stopwatch_total()`: Running time across all laps
+// - Inline lap statistics: count, min, max, sum, mean
+//
+// Example:
+// ----------------------------------------
+//   hr_stopwatch_t sw;
+//   hr_stopwatch_start(&sw);
+//   for (int i = 0; i < n; i++)
+//   {
+//       // ... one iteration ...
+//       hr_stopwatch_lap(&sw);
+//   }
+//   printf("mean: %lld ns\n", hr_stopwatch_mean(&sw, CLOCK_NANOSECONDS));
+//
+
+#include "clock.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \struct hr_stopwatch_t
+ * \brief Pausable stopwatch with lap statistics.
+ */
+typedef struct
+{
+    long long segment_start;  ///< Start of the current running segment, in ns
+    long long total_nanos;    ///< Running time of all completed segments
+    long long lap_nanos;      ///< Running time of the current lap in completed segments
+    long long lap_min;        ///< Shortest completed lap
+    long long lap_max;        ///< Longest completed lap
+    long long lap_sum;        ///< Sum of all completed laps
+    unsigned long long laps;  ///< Number of completed laps
+    hr_clock_source_t source; ///< The source every reading uses
+    int running;              ///< Non-zero unless paused
+} hr_stopwatch_t;
+
+/**
+ * \brief Resets the stopwatch and starts it, reading the active clock source.
+ *
+ * \param sw Pointer to the \p hr_stopwatch_t to start.
+ */
+static inline void hr_stopwatch_start(hr_stopwatch_t *const sw)
+{
+    if (sw == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    sw->source = hr_clock_get_source();
+    sw->total_nanos = 0;
+    sw->lap_nanos = 0;
+    sw->lap_min = 0;
+    sw->lap_max = 0;
+    sw->lap_sum = 0;
+    sw->laps = 0;
+    sw->running = 1;
+    sw->segment_start = get_nano_time_ex(sw->source);
+}
+
+/**
+ * \brief Pauses the stopwatch; the time until hr_stopwatch_resume() is not counted.
+ *
+ * Pausing an already paused stopwatch does nothing.
+ *
+ * \param sw Pointer to the \p hr_stopwatch_t to pause.
+ */
+static inline void hr_stopwatch_pause(hr_stopwatch_t *const sw)
+{
+    if (sw == NULL || !sw->running)
+    {
+        return; // Handle null pointer or already paused
+    }
+
+    const long long segment = get_nano_time_ex(sw->source) - sw->segment_start;
+    sw->total_nanos += segment;
+    sw->lap_nanos += segment;
+    sw->running = 0;
+}
+
+/**
+ * \brief Resumes a paused stopwatch.
+ *
+ * Resuming a running stopwatch does nothing.
+ *
+ * \param sw Pointer to the \p hr_stopwatch_t to resume.
+ */
+static inline void hr_stopwatch_resume(hr_stopwatch_t *const sw)
+{
+    if (sw == NULL || sw->running)
+    {
+        return; // Handle null pointer or already running
+    }
+
+    sw->running = 1;
+    sw->segment_start = get_nano_time_ex(sw->source);
+}
+
+/**
+ * \brief Ends the current lap, records it in the statistics and starts the next one.
+ *
+ * A running stopwatch reads the clock exactly once: the timestamp ending this
+ * lap is also the start of the next. A paused stopwatch does not read it at all.
+ *
+ * \param sw Pointer to the \p hr_stopwatch_t.
+ * \return The duration of the lap that just ended in nanoseconds, or -1 if the pointer is NULL.
+ */
+static inline long long hr_stopwatch_lap(hr_stopwatch_t *const sw)
+{
+    if (sw == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    long long lap = sw->lap_nanos;
+    if (sw->running)
+    {
+        const long long now = get_nano_time_ex(sw->source);
+        const long long segment = now - sw->segment_start;
+        sw->total_nanos += segment;
+        sw->segment_start = now; // The next lap starts where this one ended
+        lap += segment;
+    }
+
+    sw->lap_min = sw->laps == 0 || lap < sw->lap_min ? lap : sw->lap_min;
+    sw->lap_max = sw->laps == 0 || lap > sw->lap_max ? lap : sw->lap_max;
+    sw->lap_sum += lap;
+    sw->laps++;
+    sw->lap_nanos = 0;
+    return lap;
+}
+
+/**
+ * \brief Returns the total running time since hr_stopwatch_start(), excluding pauses.
+ *
+ * \param sw Pointer to the \p hr_stopwatch_t.
+ * \param unit The time unit in which to return the total (see \p hr_clock_time_unit_t).
+ * \return The total running time in the specified unit, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_stopwatch_total(const hr_stopwatch_t *const sw, const hr_clock_time_unit_t unit)
+{
+    if (sw == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    long long total = sw->total_nanos;
+    if (sw->running)
+    {
+        total += get_nano_time_ex(sw->source) - sw->segment_start;
+    }
+
+    return clock_nanos_to_unit(total, unit);
+}
+
+/**
+ * \brief Returns the shortest completed lap.
+ *
+ * \return The shortest lap in the specified unit, or -1 if the pointer is NULL, no lap completed or the unit is invalid.
+ */
+static inline long long hr_stopwatch_min(const hr_stopwatch_t *const sw, const hr_clock_time_unit_t unit)
+{
+    if (sw == NULL || sw->laps == 0)
+    {
+        return -1l; // Handle null pointer or no laps
+    }
+
+    return clock_nanos_to_unit(sw->lap_min, unit);
+}
+
+/**
+ * \brief Returns the longest completed lap.
+ *
+ * \return The longest lap in the specified unit, or -1 if the pointer is NULL, no lap completed or the unit is invalid.
+ */
+static inline long long hr_stopwatch_max(const hr_stopwatch_t *const sw, const hr_clock_time_unit_t unit)
+{
+    if (sw == NULL || sw->laps == 0)
+    {
+        return -1l; // Handle null pointer or no laps
+    }
+
+    return clock_nanos_to_unit(sw->lap_max, unit);
+}
+
+/**
+ * \brief Returns the sum of all completed laps.
+ *
+ * \return The summed lap time in the specified unit, or -1 if the pointer is NULL or the unit is invalid.
+ */
+static inline long long hr_stopwatch_sum(const hr_stopwatch_t *const sw, const hr_clock_time_unit_t unit)
+{
+    if (sw == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    return clock_nanos_to_unit(sw->lap_sum, unit);
+}
+
+/**
+ * \brief Returns the number of completed laps.
+ *
+ * \return The lap count, or 0 if the pointer is NULL.
+ */
+static inline unsigned long long hr_stopwatch_count(const hr_stopwatch_t *const sw)
+{
+    return sw == NULL ? 0 : sw->laps;
+}
+
+/**
+ * \brief Returns the mean duration of the completed laps (truncated).
+ *
+ * \return The mean lap in the specified unit, or -1 if the pointer is NULL, no lap completed or the unit is invalid.
+ */
+static inline long long hr_stopwatch_mean(const hr_stopwatch_t *const sw, const hr_clock_time_unit_t unit)
+{
+    if (sw == NULL || sw->laps == 0)
+    {
+        return -1l; // Handle null pointer or no laps
+    }
+
+    return clock_nanos_to_unit(sw->lap_sum / (long long)sw->laps, unit);
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_STOPWATCH_H
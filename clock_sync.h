@@ -0,0 +1,408 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_SYNC_H
+#define FLUENT_LIBC_CLOCK_SYNC_H
+
+// ============= FLUENT LIB C =============
+// Cross-host Clock Offset Estimation
+// ----------------------------------------
+// NTP-style estimate of how a remote host's get_nano_time() timeline maps
+// onto the local one, so that trace stamps taken on different machines can
+// be placed on a single axis.
+//
+// Features:
+// - `hr_clock_sync_exchange()`: One four-timestamp exchange through a user transport
+// - `hr_clock_sync_add()`: Feed an exchange measured elsewhere (async transports)
+// - `hr_clock_sync_model()`: Lock-free copy of the current offset / drift model
+// - `hr_clock_sync_to_local()` / `_to_remote()`: Convert stamps (one multiply, one add)
+//
+// Each exchange yields t1 (local send), t2 (remote receive), t3 (remote
+// send) and t4 (local receive), hence an offset ((t2 - t1) + (t3 - t4)) / 2
+// whose error is bounded by half the round trip (t4 - t1) - (t3 - t2).
+// The estimator keeps the last FLUENT_LIBC_CLOCK_SYNC_HISTORY exchanges,
+// trusts only those whose round trip is close to the fastest one (queueing
+// delay is what makes offsets wrong) and fits a line through their offsets,
+// giving the offset at a reference point plus the relative drift.
+//
+// One thread feeds the estimator; any thread may read the model.
+//
+// Example:
+// ----------------------------------------
+//   // Transport: send t1, wait for the peer's receive / send stamps
+//   static int ping(void *sock, long long t1, long long *t2, long long *t3) { ... }
+//
+//   hr_clock_sync_t peer;
+//   hr_clock_sync_init(&peer);
+//   for (int i = 0; i < 16; i++) hr_clock_sync_exchange(&peer, ping, sock);
+//
+//   hr_clock_sync_model_t model;
+//   hr_clock_sync_model(&peer, &model);
+//   long long local = hr_clock_sync_to_local(&model, remote_stamp);
+//
+
+#include <string.h>
+#include "clock.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SYNC_HISTORY
+ * \brief Number of recent exchanges the estimator fits over.
+ */
+#ifndef FLUENT_LIBC_CLOCK_SYNC_HISTORY
+#   define FLUENT_LIBC_CLOCK_SYNC_HISTORY 32
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SYNC_MIN_SPAN_NS
+ * \brief Minimum time covered by the trusted exchanges before drift is estimated (1 s).
+ */
+#ifndef FLUENT_LIBC_CLOCK_SYNC_MIN_SPAN_NS
+#   define FLUENT_LIBC_CLOCK_SYNC_MIN_SPAN_NS 1000000000LL
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_SYNC_MAX_DRIFT
+ * \brief Largest relative drift accepted from the fit (500 ppm); larger values are clamped.
+ */
+#ifndef FLUENT_LIBC_CLOCK_SYNC_MAX_DRIFT
+#   define FLUENT_LIBC_CLOCK_SYNC_MAX_DRIFT 0.0005
+#endif
+
+/**
+ * \typedef hr_clock_sync_transport_t
+ * \brief Performs one exchange with the peer.
+ *
+ * Sends a request (which may carry \p t1), then waits for the reply carrying
+ * the peer's get_nano_time() when it received the request (\p t2) and when
+ * it sent the reply (\p t3).
+ *
+ * \return Non-zero on success, 0 if the exchange failed (e.g. timed out).
+ */
+typedef int (*hr_clock_sync_transport_t)(void *ctx, long long t1, long long *t2, long long *t3);
+
+/**
+ * \struct hr_clock_sync_sample_t
+ * \brief One exchange, reduced to what the estimator needs.
+ */
+typedef struct
+{
+    long long local;  ///< Local midpoint (t1 + t4) / 2
+    long long offset; ///< Remote minus local time at \p local
+    long long delay;  ///< Round trip without the peer's processing time
+} hr_clock_sync_sample_t;
+
+/**
+ * \struct hr_clock_sync_model_t
+ * \brief Linear map between the remote and local timelines.
+ *
+ * remote = remote_ref + d + d * to_remote_q32 / 2^32 with d = local - local_ref,
+ * and the inverse through to_local_q32.
+ */
+typedef struct
+{
+    long long local_ref;      ///< Local time of the reference point
+    long long remote_ref;     ///< Remote time at \p local_ref
+    long long to_remote_q32;  ///< Remote rate / local rate - 1, in 32.32 fixed point
+    long long to_local_q32;   ///< Local rate / remote rate - 1, in 32.32 fixed point
+    long long uncertainty_ns; ///< Half the fastest trusted round trip: bound on the offset error
+    int valid;                ///< Non-zero once at least one exchange succeeded
+} hr_clock_sync_model_t;
+
+/**
+ * \struct hr_clock_sync_t
+ * \brief Offset / drift estimator for one peer.
+ */
+typedef struct
+{
+    volatile unsigned long long sequence;                           ///< Seqlock counter, odd while the model is updated
+    hr_clock_sync_model_t model;                                    ///< Current model
+    hr_clock_sync_sample_t samples[FLUENT_LIBC_CLOCK_SYNC_HISTORY]; ///< Ring of recent exchanges
+    unsigned int head;                                              ///< Next ring slot
+    unsigned int count;                                             ///< Exchanges in the ring
+    double drift;                                                   ///< Last fitted drift (remote rate / local rate - 1)
+    unsigned long long exchanges;                                   ///< Exchanges accepted
+    unsigned long long failures;                                    ///< Exchanges failed or rejected
+} hr_clock_sync_t;
+
+/**
+ * \brief Initializes an estimator with no exchanges.
+ *
+ * \param sync Pointer to the \p hr_clock_sync_t to initialize.
+ */
+static inline void hr_clock_sync_init(hr_clock_sync_t *const sync)
+{
+    if (sync == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    memset(sync, 0, sizeof(*sync));
+}
+
+/**
+ * \brief Multiplies \p value by a signed 32.32 fixed-point factor, truncating toward zero.
+ */
+static inline long long hr_clock_sync_scale(const long long value, const long long factor_q32)
+{
+    const unsigned long long sign = (unsigned long long)((value ^ factor_q32) >> 63); // All ones if the signs differ
+    const unsigned long long sign_v = (unsigned long long)(value >> 63);
+    const unsigned long long sign_f = (unsigned long long)(factor_q32 >> 63);
+    unsigned long long low;
+    const unsigned long long high = hr_clock_mul_wide(
+        ((unsigned long long)value ^ sign_v) - sign_v,
+        ((unsigned long long)factor_q32 ^ sign_f) - sign_f,
+        &low
+    );
+
+    const unsigned long long magnitude = (low >> 32) | (high << 32);
+    return (long long)((magnitude ^ sign) - sign);
+}
+
+/**
+ * \brief Refits the model over the exchanges in the ring.
+ */
+static inline void hr_clock_sync_fit(hr_clock_sync_t *const sync)
+{
+    // Trust only exchanges whose round trip is within 50% (+1 us) of the fastest
+    long long best = sync->samples[0].delay;
+    unsigned int newest = (sync->head + FLUENT_LIBC_CLOCK_SYNC_HISTORY - 1) % FLUENT_LIBC_CLOCK_SYNC_HISTORY;
+    for (unsigned int i = 1; i < sync->count; i++)
+    {
+        best = sync->samples[i].delay < best ? sync->samples[i].delay : best;
+    }
+
+    const long long limit = best + best / 2 + 1000;
+    double sum_x = 0.0, sum_y = 0.0;
+    long long first = 0, last = 0, reference = 0;
+    unsigned int trusted = 0;
+    for (unsigned int k = 0; k < sync->count; k++)
+    {
+        // Oldest to newest, so the reference ends up on the newest trusted exchange
+        const unsigned int i = (newest + FLUENT_LIBC_CLOCK_SYNC_HISTORY - (sync->count - 1 - k)) % FLUENT_LIBC_CLOCK_SYNC_HISTORY;
+        const hr_clock_sync_sample_t *const sample = &sync->samples[i];
+        if (sample->delay > limit)
+        {
+            continue;
+        }
+
+        if (trusted == 0)
+        {
+            first = sample->local;
+        }
+
+        last = sample->local;
+        reference = last;
+        sum_x += (double)(sample->local - first);
+        sum_y += (double)sample->offset;
+        trusted++;
+    }
+
+    // Least squares over the trusted offsets, x relative to the oldest one
+    const double mean_x = sum_x / trusted;
+    const double mean_y = sum_y / trusted;
+    if (trusted >= 2 && last - first >= FLUENT_LIBC_CLOCK_SYNC_MIN_SPAN_NS)
+    {
+        double sxx = 0.0, sxy = 0.0;
+        for (unsigned int i = 0; i < sync->count; i++)
+        {
+            const hr_clock_sync_sample_t *const sample = &sync->samples[i];
+            if (sample->delay <= limit)
+            {
+                const double dx = (double)(sample->local - first) - mean_x;
+                sxx += dx * dx;
+                sxy += dx * ((double)sample->offset - mean_y);
+            }
+        }
+
+        const double drift = sxx > 0.0 ? sxy / sxx : 0.0;
+        sync->drift = drift > FLUENT_LIBC_CLOCK_SYNC_MAX_DRIFT ? FLUENT_LIBC_CLOCK_SYNC_MAX_DRIFT
+            : drift < -FLUENT_LIBC_CLOCK_SYNC_MAX_DRIFT ? -FLUENT_LIBC_CLOCK_SYNC_MAX_DRIFT
+            : drift;
+    }
+
+    // Offset of the fitted line at the reference point; with too short a span
+    // the previous drift is kept and the line passes through the trusted mean
+    const double offset = mean_y + sync->drift * ((double)(reference - first) - mean_x);
+
+    hr_atomic_store_u64_relaxed(&sync->sequence, sync->sequence + 1);
+    hr_atomic_fence_release();
+    sync->model.local_ref = reference;
+    sync->model.remote_ref = reference + (long long)(offset >= 0.0 ? offset + 0.5 : offset - 0.5);
+    sync->model.to_remote_q32 = (long long)(sync->drift * 4294967296.0);
+    sync->model.to_local_q32 = (long long)((1.0 / (1.0 + sync->drift) - 1.0) * 4294967296.0);
+    sync->model.uncertainty_ns = (best + 1) / 2;
+    sync->model.valid = 1;
+    hr_atomic_store_u64(&sync->sequence, sync->sequence + 1);
+}
+
+/**
+ * \brief Feeds one four-timestamp exchange and refits the model.
+ *
+ * \param sync Pointer to the \p hr_clock_sync_t to update.
+ * \param t1 Local get_nano_time() when the request was sent.
+ * \param t2 Remote get_nano_time() when the request was received.
+ * \param t3 Remote get_nano_time() when the reply was sent.
+ * \param t4 Local get_nano_time() when the reply was received.
+ * \return Non-zero if accepted, 0 if the pointer is NULL or the stamps are inconsistent.
+ */
+static inline int hr_clock_sync_add(
+    hr_clock_sync_t *const sync,
+    const long long t1,
+    const long long t2,
+    const long long t3,
+    const long long t4
+)
+{
+    if (sync == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    const long long delay = (t4 - t1) - (t3 - t2);
+    if (t4 < t1 || t3 < t2 || delay < 0)
+    {
+        sync->failures++;
+        return 0; // Stamps out of order
+    }
+
+    hr_clock_sync_sample_t *const sample = &sync->samples[sync->head];
+    sample->local = t1 + (t4 - t1) / 2;
+    sample->offset = ((t2 - t1) + (t3 - t4)) / 2;
+    sample->delay = delay;
+    sync->head = (sync->head + 1) % FLUENT_LIBC_CLOCK_SYNC_HISTORY;
+    sync->count += sync->count < FLUENT_LIBC_CLOCK_SYNC_HISTORY;
+    sync->exchanges++;
+
+    hr_clock_sync_fit(sync);
+    return 1;
+}
+
+/**
+ * \brief Runs one exchange through \p transport and feeds it to the estimator.
+ *
+ * \param sync Pointer to the \p hr_clock_sync_t to update.
+ * \param transport Callback performing the exchange.
+ * \param ctx Passed to \p transport.
+ * \return Non-zero if the exchange succeeded and was accepted.
+ */
+static inline int hr_clock_sync_exchange(
+    hr_clock_sync_t *const sync,
+    const hr_clock_sync_transport_t transport,
+    void *const ctx
+)
+{
+    if (sync == NULL || transport == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    long long t2 = 0, t3 = 0;
+    const long long t1 = get_nano_time();
+    if (!transport(ctx, t1, &t2, &t3))
+    {
+        sync->failures++;
+        return 0;
+    }
+
+    return hr_clock_sync_add(sync, t1, t2, t3, get_nano_time());
+}
+
+/**
+ * \brief Copies the current model; lock-free, safe while another thread feeds exchanges.
+ *
+ * \param sync Pointer to the \p hr_clock_sync_t to read.
+ * \param out Receives the model.
+ * \return Non-zero if the model is valid (at least one exchange accepted).
+ */
+static inline int hr_clock_sync_model(const hr_clock_sync_t *const sync, hr_clock_sync_model_t *const out)
+{
+    if (sync == NULL || out == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+    for (;;)
+    {
+        const unsigned long long before = hr_atomic_load_u64(&sync->sequence);
+        if (before & 1)
+        {
+            hr_cpu_relax();
+            continue; // Update in progress
+        }
+
+        memcpy(out, (const void *)&sync->model, sizeof(*out));
+        hr_atomic_fence_acquire();
+        if (hr_atomic_load_u64_relaxed(&sync->sequence) == before)
+        {
+            return out->valid;
+        }
+    }
+}
+
+/**
+ * \brief Converts a remote get_nano_time() stamp to the local timeline.
+ *
+ * \param model Pointer to a model from hr_clock_sync_model().
+ * \param remote The remote stamp.
+ * \return The local time the stamp corresponds to.
+ */
+static inline long long hr_clock_sync_to_local(const hr_clock_sync_model_t *const model, const long long remote)
+{
+    const long long delta = remote - model->remote_ref;
+    return model->local_ref + delta + hr_clock_sync_scale(delta, model->to_local_q32);
+}
+
+/**
+ * \brief Converts a local get_nano_time() stamp to the remote timeline.
+ *
+ * \param model Pointer to a model from hr_clock_sync_model().
+ * \param local The local stamp.
+ * \return The remote time the stamp corresponds to.
+ */
+static inline long long hr_clock_sync_to_remote(const hr_clock_sync_model_t *const model, const long long local)
+{
+    const long long delta = local - model->local_ref;
+    return model->remote_ref + delta + hr_clock_sync_scale(delta, model->to_remote_q32);
+}
+
+/**
+ * \brief Fills the reply stamps on the peer side of an exchange.
+ *
+ * Call with the receive stamp taken as early as possible; \p t3 is read
+ * here, so call it right before sending the reply.
+ *
+ * \param received get_nano_time() when the request arrived (becomes t2).
+ * \param t2 Receives \p received.
+ * \param t3 Receives the current get_nano_time().
+ */
+static inline void hr_clock_sync_respond(const long long received, long long *const t2, long long *const t3)
+{
+    if (t2 == NULL || t3 == NULL)
+    {
+        return; // Handle null pointers
+    }
+
+    *t2 = received;
+    *t3 = get_nano_time();
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_SYNC_H
@@ -0,0 +1,518 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_THREAD_H
+#define FLUENT_LIBC_CLOCK_THREAD_H
+
+// ============= FLUENT LIB C =============
+// Minimal Thread Helpers
+// ----------------------------------------
+// Cross-platform (Windows + POSIX) background threads for the clock
+// utilities that need one (trace drainer, cached clock ticker, ...).
+//
+// Features:
+// - `hr_thread_t`: Native thread handle
+// - `hr_thread_create()` / `hr_thread_join()`: Start and wait for a thread
+// - `hr_thread_exit_register()`: Run a callback when the calling thread exits
+// - `hr_thread_sleep_nanos()`: Relative OS sleep
+// - `hr_thread_yield()`: Give up the rest of the time slice
+// - `hr_cpu_relax()`: Spin-loop hint (`pause` / `yield`)
+// - `hr_cpu_count()` / `hr_thread_pin_cpu()`: CPU topology and affinity
+// - `hr_thread_get_affinity()` / `hr_thread_set_affinity()`: Save and restore a thread's CPU set
+//
+
+#include <string.h>
+#include "clock.h"
+
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+#       include <windows.h>
+#   endif // FLUENT_LIBC_NO_WINDOWS_SDK
+#else
+#   include <pthread.h>
+#   include <sched.h>
+#   include <unistd.h>
+#   if defined(__linux__)
+#       include <sys/syscall.h>
+#   endif
+#endif
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \brief Signature of a thread entry point.
+ */
+typedef void (*hr_thread_fn_t)(void *arg);
+
+/**
+ * \struct hr_thread_t
+ * \brief Native thread handle plus the entry point it runs.
+ */
+typedef struct
+{
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+    HANDLE handle;     ///< Win32 thread handle
+#   endif
+#else
+    pthread_t handle;  ///< POSIX thread handle
+#endif
+    hr_thread_fn_t fn; ///< The function the thread runs
+    void *arg;         ///< The argument passed to \p fn
+} hr_thread_t;
+
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+/**
+ * \brief Adapts an \p hr_thread_fn_t to the Win32 thread signature.
+ */
+static inline DWORD WINAPI hr_thread_trampoline(LPVOID param)
+{
+    hr_thread_t *const thread = (hr_thread_t *)param;
+    thread->fn(thread->arg);
+    return 0;
+}
+#   endif
+#else
+/**
+ * \brief Adapts an \p hr_thread_fn_t to the pthread signature.
+ */
+static inline void *hr_thread_trampoline(void *param)
+{
+    hr_thread_t *const thread = (hr_thread_t *)param;
+    thread->fn(thread->arg);
+    return NULL;
+}
+#endif
+
+/**
+ * \brief Starts a thread running \p fn(\p arg).
+ *
+ * \p thread must stay valid until hr_thread_join() returns.
+ *
+ * \param thread Pointer to an \p hr_thread_t structure to fill.
+ * \param fn The function to run.
+ * \param arg The argument passed to \p fn.
+ * \return Non-zero on success, 0 if the thread could not be created.
+ */
+static inline int hr_thread_create(hr_thread_t *const thread, const hr_thread_fn_t fn, void *const arg)
+{
+    if (thread == NULL || fn == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+    thread->fn = fn;
+    thread->arg = arg;
+#ifdef _WIN32
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0; // Threads are not available
+#   else
+    thread->handle = CreateThread(NULL, 0, hr_thread_trampoline, thread, 0, NULL);
+    return thread->handle != NULL;
+#   endif
+#else
+    return pthread_create(&thread->handle, NULL, hr_thread_trampoline, thread) == 0;
+#endif
+}
+
+/**
+ * \brief Waits for a thread started with hr_thread_create() to finish.
+ *
+ * \param thread Pointer to the \p hr_thread_t to wait for.
+ */
+static inline void hr_thread_join(hr_thread_t *const thread)
+{
+    if (thread == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#   endif
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+}
+
+/**
+ * \def FLUENT_LIBC_CLOCK_THREAD_EXIT_CALL
+ * \brief Calling convention of an \p hr_thread_exit_fn_t (the FLS callback one on Windows).
+ */
+#if defined(_WIN32) && !defined(FLUENT_LIBC_NO_WINDOWS_SDK)
+#   define FLUENT_LIBC_CLOCK_THREAD_EXIT_CALL WINAPI
+#else
+#   define FLUENT_LIBC_CLOCK_THREAD_EXIT_CALL
+#endif
+
+/**
+ * \brief Signature of a thread-exit callback; receives the value registered by the exiting thread.
+ */
+typedef void (FLUENT_LIBC_CLOCK_THREAD_EXIT_CALL *hr_thread_exit_fn_t)(void *value);
+
+/**
+ * \struct hr_thread_exit_key_t
+ * \brief A lazily created thread-exit slot; zero-initialize it (e.g. as a global).
+ */
+typedef struct
+{
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+    DWORD index;       ///< FLS slot
+#   endif
+#else
+    pthread_key_t key; ///< pthread key
+#endif
+    volatile int once; ///< hr_clock_once_begin() state of the slot creation
+    int created;       ///< Non-zero if the slot could be created
+} hr_thread_exit_key_t;
+
+/**
+ * \brief Arranges for \p fn(\p value) to run when the calling thread exits.
+ *
+ * The slot is created on first use with \p fn, so every call on the same
+ * \p key must pass the same callback. Registering again on the same thread
+ * replaces the value. The callback runs on the exiting thread (a pthread key
+ * destructor, or an FLS callback on Windows); threads that never return
+ * through the OS, such as the main thread calling exit(), do not run it.
+ *
+ * \param key The slot, shared by every thread.
+ * \param fn The callback.
+ * \param value The non-NULL value passed to \p fn.
+ * \return Non-zero on success, 0 if the slot could not be created or is not supported.
+ */
+static inline int hr_thread_exit_register(hr_thread_exit_key_t *const key, const hr_thread_exit_fn_t fn, void *const value)
+{
+    if (key == NULL || fn == NULL || value == NULL)
+    {
+        return 0; // Handle null pointers
+    }
+
+    if (hr_clock_once_begin(&key->once))
+    {
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+        key->index = FlsAlloc(fn);
+        key->created = key->index != FLS_OUT_OF_INDEXES;
+#   endif
+#else
+        key->created = pthread_key_create(&key->key, fn) == 0;
+#endif
+        hr_clock_once_end(&key->once);
+    }
+
+    if (!key->created)
+    {
+        return 0; // No slot available
+    }
+
+#ifdef _WIN32
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0;
+#   else
+    return FlsSetValue(key->index, value) != 0;
+#   endif
+#else
+    return pthread_setspecific(key->key, value) == 0;
+#endif
+}
+
+/**
+ * \brief Suspends the calling thread for at least \p nanos nanoseconds.
+ *
+ * This is a plain OS sleep; expect it to overshoot by the scheduler's timer slack.
+ *
+ * \param nanos The duration to sleep, in nanoseconds.
+ */
+static inline void hr_thread_sleep_nanos(const long long nanos)
+{
+    if (nanos <= 0)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+    Sleep((DWORD)((nanos + 999999LL) / 1000000LL));
+#   endif
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(nanos / 1000000000LL);
+    ts.tv_nsec = (long)(nanos % 1000000000LL);
+    while (nanosleep(&ts, &ts) != 0)
+    {
+        // Interrupted by a signal, sleep for the remainder
+    }
+#endif
+}
+
+/**
+ * \brief Gives up the rest of the calling thread's time slice.
+ */
+static inline void hr_thread_yield()
+{
+#ifdef _WIN32
+#   ifndef FLUENT_LIBC_NO_WINDOWS_SDK
+    SwitchToThread();
+#   endif
+#else
+    sched_yield();
+#endif
+}
+
+/**
+ * \brief Returns the number of online logical CPUs (at least 1).
+ */
+static inline int hr_cpu_count()
+{
+#ifdef _WIN32
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 1;
+#   else
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#   endif
+#else
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+/**
+ * \brief Restricts the calling thread to a single logical CPU.
+ *
+ * Supported on Linux (raw sched_setaffinity, so _GNU_SOURCE is not required)
+ * and Windows (first processor group only).
+ *
+ * \param cpu The zero-based CPU index.
+ * \return Non-zero on success, 0 if pinning failed or is not supported.
+ */
+static inline int hr_thread_pin_cpu(const int cpu)
+{
+    if (cpu < 0)
+    {
+        return 0; // Invalid CPU
+    }
+
+#if defined(_WIN32)
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0;
+#   else
+    if (cpu >= (int)(sizeof(DWORD_PTR) * 8))
+    {
+        return 0; // Outside the first processor group
+    }
+
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#   endif
+#elif defined(__linux__) && defined(SYS_sched_setaffinity)
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {0};
+    if (cpu >= 1024)
+    {
+        return 0; // Outside the mask
+    }
+
+    mask[cpu / (8 * sizeof(unsigned long))] = 1UL << (cpu % (8 * sizeof(unsigned long)));
+    return syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask) == 0;
+#else
+    return 0; // Not supported
+#endif
+}
+
+/**
+ * \brief Removes any CPU restriction set with hr_thread_pin_cpu().
+ *
+ * \return Non-zero on success, 0 if it failed or is not supported.
+ */
+static inline int hr_thread_unpin()
+{
+#if defined(_WIN32)
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0;
+#   else
+    DWORD_PTR process_mask, system_mask;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+    {
+        return 0;
+    }
+
+    return SetThreadAffinityMask(GetCurrentThread(), process_mask) != 0;
+#   endif
+#elif defined(__linux__) && defined(SYS_sched_setaffinity)
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))];
+    memset(mask, 0xFF, sizeof(mask));
+    return syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask) == 0;
+#else
+    return 0; // Not supported
+#endif
+}
+
+/**
+ * \def FLUENT_LIBC_CLOCK_MAX_CPUS
+ * \brief Number of CPUs an \p hr_cpu_set_t can describe.
+ */
+#ifndef FLUENT_LIBC_CLOCK_MAX_CPUS
+#   define FLUENT_LIBC_CLOCK_MAX_CPUS 1024
+#endif
+
+/**
+ * \struct hr_cpu_set_t
+ * \brief A set of logical CPUs, laid out like the Linux affinity mask.
+ */
+typedef struct
+{
+    unsigned long bits[FLUENT_LIBC_CLOCK_MAX_CPUS / (8 * sizeof(unsigned long))]; ///< One bit per CPU
+} hr_cpu_set_t;
+
+/**
+ * \brief Checks whether \p cpu is in \p set.
+ */
+static inline int hr_cpu_set_has(const hr_cpu_set_t *const set, const int cpu)
+{
+    const int word_bits = (int)(8 * sizeof(unsigned long));
+    if (set == NULL || cpu < 0 || cpu >= FLUENT_LIBC_CLOCK_MAX_CPUS)
+    {
+        return 0; // Handle null pointer or out-of-range CPU
+    }
+
+    return (set->bits[cpu / word_bits] >> (cpu % word_bits)) & 1UL ? 1 : 0;
+}
+
+/**
+ * \brief Returns the lowest CPU in \p set above \p after, or -1 if there is none.
+ *
+ * Pass -1 as \p after to get the first CPU.
+ */
+static inline int hr_cpu_set_next(const hr_cpu_set_t *const set, const int after)
+{
+    for (int cpu = after < 0 ? 0 : after + 1; cpu < FLUENT_LIBC_CLOCK_MAX_CPUS; cpu++)
+    {
+        if (hr_cpu_set_has(set, cpu))
+        {
+            return cpu;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * \brief Reads the set of CPUs the calling thread may run on.
+ *
+ * Under cpusets / containers this is narrower than the CPUs hr_cpu_count()
+ * reports, and every CPU in it can be pinned to.
+ *
+ * \param out Receives the set.
+ * \return Non-zero on success, 0 if it failed or is not supported.
+ */
+static inline int hr_thread_get_affinity(hr_cpu_set_t *const out)
+{
+    if (out == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    memset(out, 0, sizeof(*out));
+#if defined(_WIN32)
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0;
+#   else
+    // Windows has no getter: swap in the process mask to learn the thread's, then put it back
+    DWORD_PTR process_mask, system_mask;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+    {
+        return 0;
+    }
+
+    const DWORD_PTR thread_mask = SetThreadAffinityMask(GetCurrentThread(), process_mask);
+    if (thread_mask == 0)
+    {
+        return 0;
+    }
+
+    SetThreadAffinityMask(GetCurrentThread(), thread_mask);
+    const int word_bits = (int)(8 * sizeof(unsigned long));
+    for (int cpu = 0; cpu < (int)(sizeof(DWORD_PTR) * 8); cpu++)
+    {
+        if ((thread_mask >> cpu) & 1)
+        {
+            out->bits[cpu / word_bits] |= 1UL << (cpu % word_bits);
+        }
+    }
+    return 1;
+#   endif
+#elif defined(__linux__) && defined(SYS_sched_getaffinity)
+    return syscall(SYS_sched_getaffinity, 0, sizeof(out->bits), out->bits) > 0;
+#else
+    return 0; // Not supported
+#endif
+}
+
+/**
+ * \brief Restricts the calling thread to \p set, e.g. one saved with hr_thread_get_affinity().
+ *
+ * \param set The CPUs to allow.
+ * \return Non-zero on success, 0 if it failed or is not supported.
+ */
+static inline int hr_thread_set_affinity(const hr_cpu_set_t *const set)
+{
+    if (set == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+#if defined(_WIN32)
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0;
+#   else
+    DWORD_PTR mask = 0;
+    for (int cpu = 0; cpu < (int)(sizeof(DWORD_PTR) * 8); cpu++)
+    {
+        if (hr_cpu_set_has(set, cpu))
+        {
+            mask |= (DWORD_PTR)1 << cpu;
+        }
+    }
+
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#   endif
+#elif defined(__linux__) && defined(SYS_sched_setaffinity)
+    return syscall(SYS_sched_setaffinity, 0, sizeof(set->bits), set->bits) == 0;
+#else
+    return 0; // Not supported
+#endif
+}
+
+/**
+ * \brief Tells the CPU the caller is spinning (x86 `pause`, AArch64 `yield`).
+ */
+static inline void hr_cpu_relax()
+{
+#if defined(FLUENT_LIBC_CLOCK_X86)
+    _mm_pause();
+#elif defined(FLUENT_LIBC_CLOCK_ARM64)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_THREAD_H
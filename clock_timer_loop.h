@@ -0,0 +1,300 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_TIMER_LOOP_H
+#define FLUENT_LIBC_CLOCK_TIMER_LOOP_H
+
+// ============= FLUENT LIB C =============
+// Timer Loop (one kernel timer per thread)
+// ----------------------------------------
+// Drives an `hr_timer_wheel_t` from a single kernel timer, so any number of
+// pending timeouts cost one timerfd and, at most, one re-arm per wake-up
+// instead of a kernel timer (or syscall) per wait.
+//
+// Features:
+// - `hr_timer_loop_init()`: Wheel plus a non-blocking timerfd (Linux)
+// - `hr_timer_loop_add()` / `hr_timer_loop_cancel()`: O(1); re-arms only for a new earliest timer
+// - `hr_timer_loop_fd()`: Readable when timers are due; register it with epoll or io_uring
+// - `hr_timer_loop_dispatch()`: Fire due timers and re-arm for the next expiry
+// - `hr_timer_loop_wait()`: Standalone loop step (poll(2), or the OS sleep elsewhere)
+//
+// The timerfd runs on CLOCK_MONOTONIC with absolute expiries; expiries on
+// the get_nano_time() timeline are carried over to it when armed, so any
+// clock source works. Without timerfd (other platforms) the fd is -1 and
+// hr_timer_loop_wait() sleeps until the next expiry instead. A loop belongs
+// to one thread; callbacks run on that thread inside dispatch and may add
+// and cancel timers.
+//
+// Example:
+// ----------------------------------------
+//   hr_timer_loop_t loop;
+//   hr_timer_loop_init(&loop, 1u << 20, 0);
+//   hr_timer_loop_add(&loop, get_nano_time() + 5000000LL, on_timeout, conn);
+//   // epoll: add hr_timer_loop_fd(&loop) for EPOLLIN, call hr_timer_loop_dispatch() when ready
+//   while (hr_timer_loop_wait(&loop) >= 0) { }
+//   hr_timer_loop_destroy(&loop);
+//
+
+#include "clock.h"
+#include "clock_sleep.h"
+#include "clock_timer_wheel.h"
+
+#if defined(__linux__)
+#   include <errno.h>
+#   include <poll.h>
+#   include <sys/timerfd.h>
+#   include <unistd.h>
+#   define FLUENT_LIBC_CLOCK_HAS_TIMERFD 1
+#endif
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \struct hr_timer_loop_t
+ * \brief A timer wheel paired with the kernel timer that wakes it.
+ */
+typedef struct
+{
+    hr_timer_wheel_t wheel; ///< Pending timers
+    int fd;                 ///< timerfd, or -1 where unavailable
+    int dispatching;        ///< Non-zero while hr_timer_loop_dispatch() fires timers
+    long long armed;        ///< Expiry the kernel timer is armed for, or -1 if disarmed
+} hr_timer_loop_t;
+
+/**
+ * \brief Initializes the wheel and creates the kernel timer.
+ *
+ * \param loop Pointer to the \p hr_timer_loop_t to initialize.
+ * \param capacity Maximum number of pending timers.
+ * \param tick_ns Wheel tick in nanoseconds, or 0 for FLUENT_LIBC_CLOCK_TIMER_WHEEL_TICK_NS.
+ * \return Non-zero on success, 0 on invalid arguments or allocation failure.
+ */
+static inline int hr_timer_loop_init(hr_timer_loop_t *const loop, const unsigned int capacity, const long long tick_ns)
+{
+    if (loop == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    if (!hr_timer_wheel_init(&loop->wheel, capacity, tick_ns, get_nano_time()))
+    {
+        return 0;
+    }
+
+    loop->fd = -1;
+    loop->dispatching = 0;
+    loop->armed = -1;
+#if defined(FLUENT_LIBC_CLOCK_HAS_TIMERFD)
+    loop->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (loop->fd < 0)
+    {
+        loop->fd = -1; // hr_timer_loop_wait() falls back to sleeping
+    }
+#endif
+
+    return 1;
+}
+
+/**
+ * \brief Closes the kernel timer and releases the wheel. Pending timers are dropped.
+ *
+ * \param loop Pointer to the \p hr_timer_loop_t to destroy.
+ */
+static inline void hr_timer_loop_destroy(hr_timer_loop_t *const loop)
+{
+    if (loop == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+#if defined(FLUENT_LIBC_CLOCK_HAS_TIMERFD)
+    if (loop->fd >= 0)
+    {
+        close(loop->fd);
+    }
+#endif
+
+    loop->fd = -1;
+    loop->armed = -1;
+    hr_timer_wheel_destroy(&loop->wheel);
+}
+
+/**
+ * \brief Returns the descriptor that becomes readable when timers are due, or -1.
+ */
+static inline int hr_timer_loop_fd(const hr_timer_loop_t *const loop)
+{
+    return loop == NULL ? -1 : loop->fd;
+}
+
+/**
+ * \brief Arms the kernel timer for \p expiry (absolute, on the get_nano_time() timeline).
+ */
+static inline void hr_timer_loop_arm(hr_timer_loop_t *const loop, const long long expiry)
+{
+    loop->armed = expiry;
+#if defined(FLUENT_LIBC_CLOCK_HAS_TIMERFD)
+    if (loop->fd >= 0)
+    {
+        // An all-zero it_value would disarm, so overdue expiries become 1 ns
+        const long long mono = hr_clock_monotonic_nanos() + (expiry - get_nano_time());
+        const long long at = mono > 0 ? mono : 1;
+        struct itimerspec spec;
+        spec.it_interval.tv_sec = 0;
+        spec.it_interval.tv_nsec = 0;
+        spec.it_value.tv_sec = (time_t)(at / 1000000000LL);
+        spec.it_value.tv_nsec = (long)(at % 1000000000LL);
+        timerfd_settime(loop->fd, TFD_TIMER_ABSTIME, &spec, NULL);
+    }
+#endif
+}
+
+/**
+ * \brief Schedules a one-shot timer; see hr_timer_wheel_add().
+ *
+ * The kernel timer is only re-armed when this timer becomes the earliest.
+ *
+ * \param loop Pointer to the \p hr_timer_loop_t.
+ * \param deadline Absolute expiry time on the get_nano_time() timeline.
+ * \param fn Callback, invoked from hr_timer_loop_dispatch().
+ * \param arg Argument passed to \p fn.
+ * \return The timer id, or 0 if a pointer is NULL or the pool is exhausted.
+ */
+static inline hr_timer_id_t hr_timer_loop_add(
+    hr_timer_loop_t *const loop,
+    const long long deadline,
+    const hr_timer_fn_t fn,
+    void *const arg
+)
+{
+    if (loop == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    const hr_timer_id_t id = hr_timer_wheel_add(&loop->wheel, deadline, 0, fn, arg);
+    if (id != 0 && !loop->dispatching)
+    {
+        // The wheel fires on tick boundaries; arm for the one this timer lands on
+        const long long tick = loop->wheel.tick_ns;
+        const long long expiry = deadline > 0 ? (deadline / tick + (deadline % tick != 0)) * tick : 0;
+        if (loop->armed < 0 || expiry < loop->armed)
+        {
+            hr_timer_loop_arm(loop, expiry);
+        }
+    }
+
+    return id;
+}
+
+/**
+ * \brief Cancels a pending timer; see hr_timer_wheel_cancel().
+ *
+ * The kernel timer is left armed: a wake-up with nothing due costs less
+ * than re-arming on every cancel.
+ */
+static inline int hr_timer_loop_cancel(hr_timer_loop_t *const loop, const hr_timer_id_t id)
+{
+    return loop == NULL ? 0 : hr_timer_wheel_cancel(&loop->wheel, id);
+}
+
+/**
+ * \brief Fires every due timer and re-arms the kernel timer for the next expiry.
+ *
+ * Call when hr_timer_loop_fd() is readable (or at any time; it is cheap when
+ * nothing is due).
+ *
+ * \param loop Pointer to the \p hr_timer_loop_t.
+ * \return The number of timers fired.
+ */
+static inline size_t hr_timer_loop_dispatch(hr_timer_loop_t *const loop)
+{
+    if (loop == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+#if defined(FLUENT_LIBC_CLOCK_HAS_TIMERFD)
+    if (loop->fd >= 0)
+    {
+        unsigned long long expirations;
+        const ssize_t drained = read(loop->fd, &expirations, sizeof(expirations)); // Non-blocking
+        (void)drained;
+    }
+#endif
+
+    loop->dispatching = 1;
+    const size_t fired = hr_timer_wheel_advance(&loop->wheel, get_nano_time());
+    loop->dispatching = 0;
+
+    // A fired timerfd is disarmed; one armed for a later expiry can stay
+    const long long next = hr_timer_wheel_next_expiry(&loop->wheel);
+    if (next < 0)
+    {
+        loop->armed = loop->armed > get_nano_time() ? loop->armed : -1;
+    }
+    else if (next != loop->armed)
+    {
+        hr_timer_loop_arm(loop, next);
+    }
+
+    return fired;
+}
+
+/**
+ * \brief Blocks until the next expiry, then dispatches.
+ *
+ * \param loop Pointer to the \p hr_timer_loop_t.
+ * \return The number of timers fired, or -1 if the pointer is NULL or no timer is pending.
+ */
+static inline long long hr_timer_loop_wait(hr_timer_loop_t *const loop)
+{
+    if (loop == NULL || hr_timer_wheel_active(&loop->wheel) == 0)
+    {
+        return -1l; // Handle null pointer or nothing to wait for
+    }
+
+    const long long next = hr_timer_wheel_next_expiry(&loop->wheel);
+#if defined(FLUENT_LIBC_CLOCK_HAS_TIMERFD)
+    if (loop->fd >= 0)
+    {
+        if (next != loop->armed)
+        {
+            hr_timer_loop_arm(loop, next);
+        }
+
+        struct pollfd ready;
+        ready.fd = loop->fd;
+        ready.events = POLLIN;
+        ready.revents = 0;
+        int result;
+        do
+        {
+            result = poll(&ready, 1, -1);
+        } while (result < 0 && errno == EINTR); // The timer stays armed across signals
+
+        return (long long)hr_timer_loop_dispatch(loop);
+    }
+#endif
+
+    hr_sleep_os_until(hr_clock_monotonic_nanos() + (next - get_nano_time()));
+    return (long long)hr_timer_loop_dispatch(loop);
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_TIMER_LOOP_H
@@ -0,0 +1,630 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_TIMER_WHEEL_H
+#define FLUENT_LIBC_CLOCK_TIMER_WHEEL_H
+
+// ============= FLUENT LIB C =============
+// Hierarchical Timer Wheel
+// ----------------------------------------
+// Thousands of one-shot and periodic timeouts keyed on the library's
+// nanosecond timebase, with O(1) insert and cancel. Timers far in the
+// future sit in coarser levels and cascade down as the wheel advances.
+//
+// Features:
+// - `hr_timer_wheel_init()`: Pre-allocate a fixed pool of timer nodes
+// - `hr_timer_wheel_add()`: Schedule a one-shot or periodic timer (O(1))
+// - `hr_timer_wheel_cancel()`: Cancel by id (O(1), stale ids are rejected)
+// - `hr_timer_wheel_advance()`: Fire every timer due at a given time
+// - `hr_timer_wheel_poll()`: Advance to the current coarse clock reading
+// - `hr_timer_wheel_next_expiry()`: When to wake up next (event loop timeouts)
+//
+// Example:
+// ----------------------------------------
+//   static void on_timeout(void *arg, hr_timer_id_t id, long long deadline) { ... }
+//
+//   hr_timer_wheel_t wheel;
+//   hr_timer_wheel_init(&wheel, 4096, 0, hr_timer_wheel_now(&wheel));
+//   hr_timer_id_t id = hr_timer_wheel_add(&wheel, get_nano_time() + 50000000LL, 0, on_timeout, conn);
+//   ...
+//   hr_timer_wheel_poll(&wheel); // From the event loop
+//   hr_timer_wheel_destroy(&wheel);
+//
+
+#include <stdlib.h>
+#include "clock.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS
+ * \brief log2 of the number of slots per level.
+ */
+#ifndef FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS
+#   define FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS 8
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS
+ * \brief Number of levels; the wheel spans 2^(BITS * LEVELS) ticks before timers are re-queued.
+ */
+#ifndef FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS
+#   define FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS 4
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_TIMER_WHEEL_TICK_NS
+ * \brief Default tick length (1 ms), roughly the resolution of the coarse clock.
+ */
+#ifndef FLUENT_LIBC_CLOCK_TIMER_WHEEL_TICK_NS
+#   define FLUENT_LIBC_CLOCK_TIMER_WHEEL_TICK_NS 1000000LL
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_TIMER_WHEEL_SOURCE
+ * \brief Clock source hr_timer_wheel_poll() reads.
+ *
+ * CLOCK_MONOTONIC_COARSE shares CLOCK_MONOTONIC's timeline, so deadlines taken
+ * from get_nano_time() stay comparable. On Windows the coarse source
+ * (GetTickCount64) has a different origin, so the wheel uses QPC there.
+ */
+#ifndef FLUENT_LIBC_CLOCK_TIMER_WHEEL_SOURCE
+#   if !defined(_WIN32) && defined(CLOCK_MONOTONIC_COARSE)
+#       define FLUENT_LIBC_CLOCK_TIMER_WHEEL_SOURCE CLOCK_SOURCE_MONOTONIC_COARSE
+#   else
+#       define FLUENT_LIBC_CLOCK_TIMER_WHEEL_SOURCE CLOCK_SOURCE_MONOTONIC
+#   endif
+#endif
+
+#define FLUENT_LIBC_CLOCK_TIMER_WHEEL_SLOTS (1u << FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS)
+#define FLUENT_LIBC_CLOCK_TIMER_WHEEL_MASK (FLUENT_LIBC_CLOCK_TIMER_WHEEL_SLOTS - 1u)
+#define FLUENT_LIBC_CLOCK_TIMER_WHEEL_LISTS (FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS * FLUENT_LIBC_CLOCK_TIMER_WHEEL_SLOTS)
+#define FLUENT_LIBC_CLOCK_TIMER_WHEEL_FIRING FLUENT_LIBC_CLOCK_TIMER_WHEEL_LISTS         // List being fired
+#define FLUENT_LIBC_CLOCK_TIMER_WHEEL_DUE (FLUENT_LIBC_CLOCK_TIMER_WHEEL_LISTS + 1u)     // Added after its tick was processed
+#define FLUENT_LIBC_CLOCK_TIMER_WHEEL_RUNNING (FLUENT_LIBC_CLOCK_TIMER_WHEEL_LISTS + 2u) // Periodic timer in its callback
+#define FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL 0xFFFFFFFFu
+
+/**
+ * \brief Timer handle: generation in the upper 32 bits, pool index in the lower 32. 0 is never valid.
+ */
+typedef unsigned long long hr_timer_id_t;
+
+/**
+ * \brief Timer callback, invoked from hr_timer_wheel_advance().
+ *
+ * The callback may add and cancel timers, including its own.
+ *
+ * \param arg The argument given to hr_timer_wheel_add().
+ * \param id The id of the timer that fired.
+ * \param deadline The deadline that expired, in nanoseconds.
+ */
+typedef void (*hr_timer_fn_t)(void *arg, hr_timer_id_t id, long long deadline);
+
+/**
+ * \struct hr_timer_node_t
+ * \brief A pooled timer; lives in exactly one slot list or in the free list.
+ */
+typedef struct
+{
+    long long deadline;      ///< Absolute expiry time in nanoseconds
+    long long period;        ///< Re-arm interval, or 0 for one-shot timers
+    hr_timer_fn_t fn;        ///< Callback
+    void *arg;               ///< Callback argument
+    unsigned int next;       ///< Next node in the list, or NIL
+    unsigned int prev;       ///< Previous node in the list, or NIL
+    unsigned int list;       ///< Slot list holding the node, or NIL when free
+    unsigned int generation; ///< Bumped every time the node is released
+} hr_timer_node_t;
+
+/**
+ * \struct hr_timer_wheel_t
+ * \brief A hierarchical timer wheel with a fixed node pool.
+ */
+typedef struct
+{
+    hr_timer_node_t *nodes;                                      ///< Node pool
+    unsigned int capacity;                                       ///< Number of nodes in the pool
+    unsigned int free_head;                                      ///< First free node, or NIL
+    unsigned int active;                                         ///< Number of scheduled timers
+    unsigned int counts[FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS];   ///< Timers per level
+    unsigned int lists[FLUENT_LIBC_CLOCK_TIMER_WHEEL_LISTS + 2]; ///< Slot list heads, plus the firing and due lists
+    unsigned long long current;                                  ///< Next tick to process
+    long long tick_ns;                                           ///< Tick length in nanoseconds
+} hr_timer_wheel_t;
+
+/**
+ * \brief Reads the clock the wheel is meant to be driven with.
+ *
+ * \param wheel Unused; present for symmetry with the other wheel functions.
+ * \return The current time of FLUENT_LIBC_CLOCK_TIMER_WHEEL_SOURCE in nanoseconds.
+ */
+static inline long long hr_timer_wheel_now(const hr_timer_wheel_t *const wheel)
+{
+    (void)wheel;
+    return get_nano_time_ex(FLUENT_LIBC_CLOCK_TIMER_WHEEL_SOURCE);
+}
+
+/**
+ * \brief Initializes a wheel and allocates its node pool in one block.
+ *
+ * \param wheel Pointer to the \p hr_timer_wheel_t to initialize.
+ * \param capacity Maximum number of timers scheduled at once.
+ * \param tick_ns Tick length in nanoseconds, or 0 for FLUENT_LIBC_CLOCK_TIMER_WHEEL_TICK_NS.
+ * \param now The current time; the wheel starts at this tick.
+ * \return Non-zero on success, 0 if the pointer is NULL or allocation failed.
+ */
+static inline int hr_timer_wheel_init(
+    hr_timer_wheel_t *const wheel,
+    const unsigned int capacity,
+    const long long tick_ns,
+    const long long now
+)
+{
+    if (wheel == NULL || capacity == 0 || capacity == FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        return 0; // Handle null pointer or invalid capacity
+    }
+
+    wheel->nodes = (hr_timer_node_t *)malloc((size_t)capacity * sizeof(hr_timer_node_t));
+    if (wheel->nodes == NULL)
+    {
+        return 0;
+    }
+
+    wheel->capacity = capacity;
+    wheel->active = 0;
+    wheel->tick_ns = tick_ns > 0 ? tick_ns : FLUENT_LIBC_CLOCK_TIMER_WHEEL_TICK_NS;
+    wheel->current = now > 0 ? (unsigned long long)now / (unsigned long long)wheel->tick_ns : 0;
+    for (unsigned int i = 0; i < FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS; i++)
+    {
+        wheel->counts[i] = 0;
+    }
+
+    for (unsigned int i = 0; i <= FLUENT_LIBC_CLOCK_TIMER_WHEEL_DUE; i++)
+    {
+        wheel->lists[i] = FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+    }
+
+    for (unsigned int i = 0; i < capacity; i++)
+    {
+        wheel->nodes[i].next = i + 1 < capacity ? i + 1 : FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+        wheel->nodes[i].list = FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+        wheel->nodes[i].generation = 1;
+    }
+
+    wheel->free_head = 0;
+    return 1;
+}
+
+/**
+ * \brief Releases the node pool. Pending timers are dropped without firing.
+ *
+ * \param wheel Pointer to the \p hr_timer_wheel_t to destroy.
+ */
+static inline void hr_timer_wheel_destroy(hr_timer_wheel_t *const wheel)
+{
+    if (wheel == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    free(wheel->nodes);
+    wheel->nodes = NULL;
+    wheel->capacity = 0;
+    wheel->active = 0;
+    wheel->free_head = FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+}
+
+/**
+ * \brief Unlinks a node from whichever slot list holds it.
+ */
+static inline void hr_timer_wheel_unlink(hr_timer_wheel_t *const wheel, hr_timer_node_t *const node)
+{
+    if (node->prev != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        wheel->nodes[node->prev].next = node->next;
+    }
+    else
+    {
+        wheel->lists[node->list] = node->next;
+    }
+
+    if (node->next != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        wheel->nodes[node->next].prev = node->prev;
+    }
+
+    if (node->list < FLUENT_LIBC_CLOCK_TIMER_WHEEL_LISTS)
+    {
+        wheel->counts[node->list >> FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS]--;
+    }
+}
+
+/**
+ * \brief Pushes a node at the head of a slot list.
+ */
+static inline void hr_timer_wheel_link(hr_timer_wheel_t *const wheel, const unsigned int index, const unsigned int list)
+{
+    hr_timer_node_t *const node = &wheel->nodes[index];
+    node->list = list;
+    node->prev = FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+    node->next = wheel->lists[list];
+    if (node->next != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        wheel->nodes[node->next].prev = index;
+    }
+
+    wheel->lists[list] = index;
+    if (list < FLUENT_LIBC_CLOCK_TIMER_WHEEL_LISTS)
+    {
+        wheel->counts[list >> FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS]++;
+    }
+}
+
+/**
+ * \brief Places a node in the slot matching its deadline relative to the current tick.
+ *
+ * Deadlines are rounded up to whole ticks so a timer never fires early.
+ * Timers whose tick was already processed go to the due list, which the next
+ * hr_timer_wheel_advance() fires first; timers beyond the wheel's span go to
+ * the farthest top-level slot and are re-queued when it cascades.
+ */
+static inline void hr_timer_wheel_place(hr_timer_wheel_t *const wheel, const unsigned int index)
+{
+    const unsigned long long tick_ns = (unsigned long long)wheel->tick_ns;
+    const long long deadline = wheel->nodes[index].deadline;
+    unsigned long long expiry = deadline > 0 ? ((unsigned long long)deadline + tick_ns - 1) / tick_ns : 0;
+    if (expiry < wheel->current)
+    {
+        hr_timer_wheel_link(wheel, index, FLUENT_LIBC_CLOCK_TIMER_WHEEL_DUE); // current already points past it
+        return;
+    }
+
+    unsigned long long delta = expiry - wheel->current;
+    unsigned int level = 0;
+    while (level + 1 < FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS
+        && delta >> (FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS * (level + 1)) != 0)
+    {
+        level++;
+    }
+
+    const unsigned int span_bits = FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS * FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS;
+    if (span_bits < 64 && delta >> span_bits != 0)
+    {
+        expiry = wheel->current + ((1ULL << span_bits) - 1); // Re-queued on cascade
+    }
+
+    const unsigned int slot = (unsigned int)(expiry >> (FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS * level))
+        & FLUENT_LIBC_CLOCK_TIMER_WHEEL_MASK;
+    hr_timer_wheel_link(wheel, index, (level << FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS) | slot);
+}
+
+/**
+ * \brief Returns a node to the pool and invalidates its id.
+ */
+static inline void hr_timer_wheel_release(hr_timer_wheel_t *const wheel, const unsigned int index)
+{
+    hr_timer_node_t *const node = &wheel->nodes[index];
+    node->generation = node->generation + 1 ? node->generation + 1 : 1; // Ids are never 0
+    node->list = FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+    node->next = wheel->free_head;
+    wheel->free_head = index;
+    wheel->active--;
+}
+
+/**
+ * \brief Resolves an id to its pool index, or NIL if it is stale or malformed.
+ */
+static inline unsigned int hr_timer_wheel_lookup(const hr_timer_wheel_t *const wheel, const hr_timer_id_t id)
+{
+    const unsigned int index = (unsigned int)(id & 0xFFFFFFFFULL);
+    if (index >= wheel->capacity
+        || wheel->nodes[index].generation != (unsigned int)(id >> 32)
+        || wheel->nodes[index].list == FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        return FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+    }
+
+    return index;
+}
+
+/**
+ * \brief Schedules a timer. O(1), no allocation.
+ *
+ * \param wheel Pointer to the \p hr_timer_wheel_t.
+ * \param deadline Absolute expiry time in nanoseconds (same timeline as get_nano_time()).
+ * \param period Re-arm interval in nanoseconds for periodic timers, or 0 for a one-shot timer.
+ * \param fn Callback invoked when the timer fires.
+ * \param arg Argument passed to \p fn.
+ * \return The timer id, or 0 if a pointer is NULL or the pool is exhausted.
+ */
+static inline hr_timer_id_t hr_timer_wheel_add(
+    hr_timer_wheel_t *const wheel,
+    const long long deadline,
+    const long long period,
+    const hr_timer_fn_t fn,
+    void *const arg
+)
+{
+    if (wheel == NULL || fn == NULL || wheel->free_head == FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        return 0; // Handle null pointers or exhausted pool
+    }
+
+    const unsigned int index = wheel->free_head;
+    hr_timer_node_t *const node = &wheel->nodes[index];
+    wheel->free_head = node->next;
+    wheel->active++;
+
+    node->deadline = deadline;
+    node->period = period > 0 ? period : 0;
+    node->fn = fn;
+    node->arg = arg;
+    hr_timer_wheel_place(wheel, index);
+    return ((hr_timer_id_t)node->generation << 32) | index;
+}
+
+/**
+ * \brief Cancels a scheduled timer. O(1).
+ *
+ * Cancelling a periodic timer from its own callback stops it from re-arming.
+ *
+ * \param wheel Pointer to the \p hr_timer_wheel_t.
+ * \param id The id returned by hr_timer_wheel_add().
+ * \return Non-zero if the timer was cancelled, 0 if it already fired, was cancelled or the id is invalid.
+ */
+static inline int hr_timer_wheel_cancel(hr_timer_wheel_t *const wheel, const hr_timer_id_t id)
+{
+    if (wheel == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    const unsigned int index = hr_timer_wheel_lookup(wheel, id);
+    if (index == FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        return 0;
+    }
+
+    if (wheel->nodes[index].list != FLUENT_LIBC_CLOCK_TIMER_WHEEL_RUNNING)
+    {
+        hr_timer_wheel_unlink(wheel, &wheel->nodes[index]);
+    }
+
+    hr_timer_wheel_release(wheel, index);
+    return 1;
+}
+
+/**
+ * \brief Returns the number of scheduled timers.
+ */
+static inline unsigned int hr_timer_wheel_active(const hr_timer_wheel_t *const wheel)
+{
+    return wheel == NULL ? 0 : wheel->active;
+}
+
+/**
+ * \brief Re-queues every timer of one higher-level slot into the levels below.
+ */
+static inline void hr_timer_wheel_cascade(hr_timer_wheel_t *const wheel, const unsigned int list)
+{
+    unsigned int index = wheel->lists[list];
+    wheel->lists[list] = FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+    while (index != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        const unsigned int next = wheel->nodes[index].next;
+        wheel->counts[list >> FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS]--;
+        hr_timer_wheel_place(wheel, index);
+        index = next;
+    }
+}
+
+/**
+ * \brief Fires every timer in one level-0 slot or the due list; the current tick must already point past it.
+ *
+ * \return The number of callbacks invoked.
+ */
+static inline size_t hr_timer_wheel_fire(hr_timer_wheel_t *const wheel, const unsigned int list, const long long now)
+{
+    // Detach the slot so timers re-added by callbacks land in a later tick
+    unsigned int index = wheel->lists[list];
+    wheel->lists[list] = FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL;
+    wheel->lists[FLUENT_LIBC_CLOCK_TIMER_WHEEL_FIRING] = index;
+    for (; index != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL; index = wheel->nodes[index].next)
+    {
+        wheel->nodes[index].list = FLUENT_LIBC_CLOCK_TIMER_WHEEL_FIRING;
+        if (list < FLUENT_LIBC_CLOCK_TIMER_WHEEL_LISTS)
+        {
+            wheel->counts[0]--;
+        }
+    }
+
+    size_t fired = 0;
+    while ((index = wheel->lists[FLUENT_LIBC_CLOCK_TIMER_WHEEL_FIRING]) != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        hr_timer_node_t *const node = &wheel->nodes[index];
+        hr_timer_wheel_unlink(wheel, node);
+
+        const hr_timer_id_t id = ((hr_timer_id_t)node->generation << 32) | index;
+        const hr_timer_fn_t fn = node->fn;
+        void *const arg = node->arg;
+        const long long deadline = node->deadline;
+        if (node->period == 0)
+        {
+            hr_timer_wheel_release(wheel, index); // The node may be reused by the callback
+            fn(arg, id, deadline);
+        }
+        else
+        {
+            node->list = FLUENT_LIBC_CLOCK_TIMER_WHEEL_RUNNING;
+            fn(arg, id, deadline);
+            if (node->generation == (unsigned int)(id >> 32) && node->list == FLUENT_LIBC_CLOCK_TIMER_WHEEL_RUNNING)
+            {
+                // Re-arm on the original cadence, skipping periods that were missed entirely
+                node->deadline += node->period;
+                if (node->deadline <= now)
+                {
+                    node->deadline += ((now - node->deadline) / node->period + 1) * node->period;
+                }
+                hr_timer_wheel_place(wheel, index);
+            }
+        }
+
+        fired++;
+    }
+
+    return fired;
+}
+
+/**
+ * \brief Fires every timer whose deadline is at or before \p now, in tick order.
+ *
+ * Ticks with no timer in reach are skipped in bulk, so advancing across a long
+ * idle gap is cheap. Timers fire at most one tick after their deadline (plus
+ * however late the caller advances) and never before it.
+ *
+ * \param wheel Pointer to the \p hr_timer_wheel_t.
+ * \param now The current time in nanoseconds.
+ * \return The number of timers fired.
+ */
+static inline size_t hr_timer_wheel_advance(hr_timer_wheel_t *const wheel, const long long now)
+{
+    if (wheel == NULL || now < 0)
+    {
+        return 0; // Handle null pointer
+    }
+
+    const unsigned long long target = (unsigned long long)now / (unsigned long long)wheel->tick_ns;
+    size_t fired = 0;
+    if (wheel->lists[FLUENT_LIBC_CLOCK_TIMER_WHEEL_DUE] != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        fired += hr_timer_wheel_fire(wheel, FLUENT_LIBC_CLOCK_TIMER_WHEEL_DUE, now);
+    }
+
+    while (wheel->current <= target)
+    {
+        // Jump to the next tick where the lowest occupied level has work
+        unsigned int lowest = 0;
+        while (lowest < FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS && wheel->counts[lowest] == 0)
+        {
+            lowest++;
+        }
+
+        if (lowest == FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS)
+        {
+            wheel->current = target + 1; // Nothing scheduled
+            break;
+        }
+
+        if (lowest > 0)
+        {
+            const unsigned long long span = 1ULL << (FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS * lowest);
+            const unsigned long long boundary = (wheel->current + span - 1) & ~(span - 1);
+            if (boundary > target)
+            {
+                wheel->current = target + 1;
+                break;
+            }
+
+            wheel->current = boundary;
+        }
+
+        // Cascade from the top so timers can fall through several levels at once
+        for (unsigned int level = FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+        {
+            const unsigned int shift = FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS * level;
+            if ((wheel->current & ((1ULL << shift) - 1)) == 0)
+            {
+                const unsigned int slot = (unsigned int)(wheel->current >> shift) & FLUENT_LIBC_CLOCK_TIMER_WHEEL_MASK;
+                hr_timer_wheel_cascade(wheel, (level << FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS) | slot);
+            }
+        }
+
+        const unsigned int slot = (unsigned int)wheel->current & FLUENT_LIBC_CLOCK_TIMER_WHEEL_MASK;
+        wheel->current++;
+        if (wheel->lists[slot] != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+        {
+            fired += hr_timer_wheel_fire(wheel, slot, now);
+        }
+    }
+
+    return fired;
+}
+
+/**
+ * \brief Advances the wheel to the current reading of FLUENT_LIBC_CLOCK_TIMER_WHEEL_SOURCE.
+ *
+ * \param wheel Pointer to the \p hr_timer_wheel_t.
+ * \return The number of timers fired.
+ */
+static inline size_t hr_timer_wheel_poll(hr_timer_wheel_t *const wheel)
+{
+    return hr_timer_wheel_advance(wheel, hr_timer_wheel_now(wheel));
+}
+
+/**
+ * \brief Returns the earliest time at which hr_timer_wheel_advance() has work to do.
+ *
+ * This is exact for timers within one level-0 revolution and a lower bound
+ * (the next cascade) otherwise, which makes it a safe event loop timeout.
+ * Timers added after their tick was processed make it return a past time.
+ *
+ * \param wheel Pointer to the \p hr_timer_wheel_t.
+ * \return The time in nanoseconds, or -1 if the pointer is NULL or no timer is scheduled.
+ */
+static inline long long hr_timer_wheel_next_expiry(const hr_timer_wheel_t *const wheel)
+{
+    if (wheel == NULL || wheel->active == 0)
+    {
+        return -1l; // Handle null pointer or empty wheel
+    }
+
+    if (wheel->lists[FLUENT_LIBC_CLOCK_TIMER_WHEEL_DUE] != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+    {
+        // Already due: the start of the last processed tick
+        return (long long)((wheel->current != 0 ? wheel->current - 1 : 0) * (unsigned long long)wheel->tick_ns);
+    }
+
+    unsigned long long earliest = ~0ULL;
+    for (unsigned int level = 0; level < FLUENT_LIBC_CLOCK_TIMER_WHEEL_LEVELS; level++)
+    {
+        if (wheel->counts[level] == 0)
+        {
+            continue;
+        }
+
+        // Each slot of this level is visited at a multiple of its span
+        const unsigned int shift = FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS * level;
+        const unsigned long long first = (wheel->current + (1ULL << shift) - 1) >> shift;
+        for (unsigned long long k = first; k < first + FLUENT_LIBC_CLOCK_TIMER_WHEEL_SLOTS; k++)
+        {
+            const unsigned int list = (level << FLUENT_LIBC_CLOCK_TIMER_WHEEL_BITS)
+                | ((unsigned int)k & FLUENT_LIBC_CLOCK_TIMER_WHEEL_MASK);
+            if (wheel->lists[list] != FLUENT_LIBC_CLOCK_TIMER_WHEEL_NIL)
+            {
+                earliest = k << shift < earliest ? k << shift : earliest;
+                break;
+            }
+        }
+    }
+
+    return (long long)(earliest * (unsigned long long)wheel->tick_ns);
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_TIMER_WHEEL_H
@@ -0,0 +1,644 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_TRACE_H
+#define FLUENT_LIBC_CLOCK_TRACE_H
+
+// ============= FLUENT LIB C =============
+// Scoped Timer Zones / Trace Recorder
+// ----------------------------------------
+// Low-overhead, always-on profiler built on `get_nano_time()`.
+//
+// Features:
+// - `HR_ZONE(name)`: Record begin/end of the enclosing scope
+// - `HR_ZONE_BEGIN(name)` / `HR_ZONE_END(name)`: Explicit zone boundaries
+// - `hr_trace_start()` / `hr_trace_stop()`: Background drainer writing a binary trace
+// - `hr_trace_flush()`: Drain all per-thread buffers synchronously
+// - `hr_trace_export_chrome()`: Convert a binary trace to Chrome Trace / Perfetto JSON
+//
+// Every thread records into its own single-producer/single-consumer ring
+// buffer: no locks and no allocation on the hot path (the ring is allocated
+// on the thread's first zone, or eagerly with `hr_trace_thread_init()`).
+// When a ring is full, new events are dropped and counted. A thread's ring
+// is retired when it exits and handed to a later thread once drained, so
+// thread churn does not grow memory.
+//
+// Zones compile to nothing unless FLUENT_LIBC_CLOCK_TRACE is defined.
+// `HR_ZONE()` needs `__attribute__((cleanup))` in C (GCC/Clang) or C++.
+//
+// Example:
+// ----------------------------------------
+//   hr_trace_start("app.hrtrace");
+//   {
+//       HR_ZONE("parse");
+//       // ... some work ...
+//   }
+//   hr_trace_stop();
+//   hr_trace_export_chrome("app.hrtrace", "app.json");
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "clock.h"
+#include "clock_bench.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_TRACE_RING_EVENTS
+ * \brief Capacity of each per-thread ring buffer, in events (power of two).
+ */
+#ifndef FLUENT_LIBC_CLOCK_TRACE_RING_EVENTS
+#   define FLUENT_LIBC_CLOCK_TRACE_RING_EVENTS 16384
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_TRACE_MAX_NAMES
+ * \brief Number of distinct zone name pointers the drainer can intern (power of two).
+ */
+#ifndef FLUENT_LIBC_CLOCK_TRACE_MAX_NAMES
+#   define FLUENT_LIBC_CLOCK_TRACE_MAX_NAMES 4096
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_TRACE_DRAIN_INTERVAL_NS
+ * \brief How often the background drainer empties the ring buffers.
+ */
+#ifndef FLUENT_LIBC_CLOCK_TRACE_DRAIN_INTERVAL_NS
+#   define FLUENT_LIBC_CLOCK_TRACE_DRAIN_INTERVAL_NS 1000000LL // 1 ms
+#endif
+
+/**
+ * \enum hr_trace_event_type_t
+ * \brief Kind of a trace event; the values are the record tags of the binary format.
+ */
+typedef enum
+{
+    HR_TRACE_BEGIN = 'B', ///< A zone was entered
+    HR_TRACE_END = 'E',   ///< A zone was left
+} hr_trace_event_type_t;
+
+/**
+ * \struct hr_trace_event_t
+ * \brief A single zone boundary, as stored in the ring buffer.
+ */
+typedef struct
+{
+    long long timestamp; ///< get_nano_time() at the boundary
+    const char *name;    ///< Zone name; must outlive the trace (use string literals)
+    int type;            ///< \p hr_trace_event_type_t
+} hr_trace_event_t;
+
+/**
+ * \struct hr_trace_ring_t
+ * \brief Per-thread SPSC ring buffer; the owning thread produces, the drainer consumes.
+ */
+typedef struct hr_trace_ring_t
+{
+    volatile unsigned long long head;    ///< Next slot to write (producer-owned)
+    char head_pad[64 - sizeof(unsigned long long)];
+    volatile unsigned long long tail;    ///< Next slot to read (consumer-owned)
+    char tail_pad[64 - sizeof(unsigned long long)];
+    volatile unsigned long long dropped; ///< Events lost because the ring was full
+    struct hr_trace_ring_t *next;        ///< Next registered ring
+    volatile int retired;                ///< Non-zero once the owning thread has exited
+    unsigned int thread_id;              ///< Sequential id reported as "tid"
+    hr_trace_event_t events[FLUENT_LIBC_CLOCK_TRACE_RING_EVENTS]; ///< Event storage
+} hr_trace_ring_t;
+
+/**
+ * \struct hr_trace_state_t
+ * \brief Process-wide trace recorder state.
+ */
+typedef struct
+{
+    volatile int recording;            ///< Non-zero while zones are being recorded
+    volatile int draining;             ///< Guards the consumer side of every ring
+    volatile int running;              ///< Non-zero while the drainer thread should keep going
+    volatile int next_thread_id;       ///< Last assigned ring thread id
+    void *volatile rings;              ///< Lock-free list of registered \p hr_trace_ring_t
+    hr_thread_exit_key_t exit_key;     ///< Retires a thread's ring when it exits
+    FILE *file;                        ///< Binary output, NULL when not started
+    hr_thread_t drainer;               ///< Background drainer thread
+    unsigned int name_count;           ///< Number of interned names
+    const char *names[FLUENT_LIBC_CLOCK_TRACE_MAX_NAMES]; ///< Interned name pointers (hash table)
+    unsigned int name_ids[FLUENT_LIBC_CLOCK_TRACE_MAX_NAMES]; ///< Id of each interned name
+} hr_trace_state_t;
+
+FLUENT_LIBC_CLOCK_GLOBAL hr_trace_state_t hr_trace_state = FLUENT_LIBC_CLOCK_ZERO_INIT;
+FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL hr_trace_ring_t *hr_trace_thread_ring = NULL;
+
+/**
+ * \brief Thread-exit callback: retires the exiting thread's ring so another thread can take it over.
+ */
+static inline void FLUENT_LIBC_CLOCK_THREAD_EXIT_CALL hr_trace_thread_exit(void *const value)
+{
+    hr_trace_ring_t *const ring = (hr_trace_ring_t *)value;
+    if (hr_trace_thread_ring == ring)
+    {
+        hr_trace_thread_ring = NULL; // A later zone on this thread gets a fresh ring
+    }
+
+    hr_atomic_store_int(&ring->retired, 1);
+}
+
+/**
+ * \brief Gives the calling thread a ring buffer, if it has none yet.
+ *
+ * Called implicitly by the first zone on each thread; call it explicitly at
+ * thread start to keep the allocation out of the first measured zone. A
+ * drained ring retired by an exited thread is reused before a new one is
+ * allocated.
+ *
+ * \return The calling thread's ring, or NULL if the allocation failed.
+ */
+static inline hr_trace_ring_t *hr_trace_thread_init()
+{
+    if (hr_trace_thread_ring != NULL)
+    {
+        return hr_trace_thread_ring;
+    }
+
+    // Rings are never freed, since the drainer walks the list without a lock
+    hr_trace_ring_t *ring = NULL;
+    for (hr_trace_ring_t *candidate = (hr_trace_ring_t *)hr_atomic_load_ptr(&hr_trace_state.rings);
+         candidate != NULL;
+         candidate = candidate->next)
+    {
+        if (hr_atomic_load_int(&candidate->retired)
+            && hr_atomic_load_u64(&candidate->tail) == hr_atomic_load_u64(&candidate->head)
+            && hr_atomic_cas_int(&candidate->retired, 1, 0))
+        {
+            ring = candidate; // Drained, so the drainer no longer reads its thread id
+            break;
+        }
+    }
+
+    const int reused = ring != NULL;
+    if (!reused)
+    {
+        ring = (hr_trace_ring_t *)calloc(1, sizeof(hr_trace_ring_t));
+        if (ring == NULL)
+        {
+            return NULL; // Out of memory
+        }
+    }
+
+    // Every thread gets its own id, even on a reused ring
+    int id;
+    do
+    {
+        id = hr_atomic_load_int(&hr_trace_state.next_thread_id);
+    } while (!hr_atomic_cas_int(&hr_trace_state.next_thread_id, id, id + 1));
+    ring->thread_id = (unsigned int)id + 1;
+
+    if (!reused)
+    {
+        void *head;
+        do
+        {
+            head = hr_atomic_load_ptr(&hr_trace_state.rings);
+            ring->next = (hr_trace_ring_t *)head;
+        } while (!hr_atomic_cas_ptr(&hr_trace_state.rings, head, ring));
+    }
+
+    hr_thread_exit_register(&hr_trace_state.exit_key, hr_trace_thread_exit, ring);
+    hr_trace_thread_ring = ring;
+    return ring;
+}
+
+/**
+ * \brief Appends an event to the calling thread's ring buffer.
+ *
+ * Does nothing unless a trace is being recorded (see hr_trace_start()).
+ *
+ * \param name The zone name; must outlive the trace (use string literals).
+ * \param type The \p hr_trace_event_type_t of the event.
+ */
+static inline void hr_trace_emit(const char *const name, const int type)
+{
+    if (!hr_atomic_load_int(&hr_trace_state.recording))
+    {
+        return; // Not recording
+    }
+
+    const long long now = get_nano_time();
+    hr_trace_ring_t *const ring = hr_trace_thread_ring != NULL ? hr_trace_thread_ring : hr_trace_thread_init();
+    if (ring == NULL)
+    {
+        return; // No ring buffer available
+    }
+
+    const unsigned long long head = ring->head; // Only this thread writes head
+    if (head - hr_atomic_load_u64(&ring->tail) >= FLUENT_LIBC_CLOCK_TRACE_RING_EVENTS)
+    {
+        hr_atomic_store_u64_relaxed(&ring->dropped, ring->dropped + 1);
+        return; // Ring full
+    }
+
+    hr_trace_event_t *const event = &ring->events[head & (FLUENT_LIBC_CLOCK_TRACE_RING_EVENTS - 1)];
+    event->timestamp = now;
+    event->name = name;
+    event->type = type;
+    hr_atomic_store_u64(&ring->head, head + 1); // Publish the event
+}
+
+/**
+ * \brief Writes \p value as \p size little-endian bytes.
+ */
+static inline void hr_trace_write_le(FILE *const file, unsigned long long value, const int size)
+{
+    unsigned char bytes[8];
+    for (int i = 0; i < size; i++)
+    {
+        bytes[i] = (unsigned char)(value & 0xFF);
+        value >>= 8;
+    }
+
+    fwrite(bytes, 1, (size_t)size, file);
+}
+
+/**
+ * \brief Reads \p size little-endian bytes.
+ *
+ * \return Non-zero on success, 0 at end of file.
+ */
+static inline int hr_trace_read_le(FILE *const file, unsigned long long *const value, const int size)
+{
+    unsigned char bytes[8];
+    if (fread(bytes, 1, (size_t)size, file) != (size_t)size)
+    {
+        return 0; // End of file
+    }
+
+    *value = 0;
+    for (int i = size - 1; i >= 0; i--)
+    {
+        *value = (*value << 8) | bytes[i];
+    }
+
+    return 1;
+}
+
+/**
+ * \brief Returns the id of a zone name, writing its definition record on first sight.
+ *
+ * Names are interned by pointer; only the drainer calls this.
+ */
+static inline unsigned int hr_trace_intern(const char *const name)
+{
+    unsigned long long hash = (unsigned long long)(size_t)name * 0x9E3779B97F4A7C15ULL;
+    for (unsigned int probe = 0; probe < FLUENT_LIBC_CLOCK_TRACE_MAX_NAMES; probe++)
+    {
+        const unsigned int slot = (unsigned int)((hash >> 40) + probe) & (FLUENT_LIBC_CLOCK_TRACE_MAX_NAMES - 1);
+        if (hr_trace_state.names[slot] == name)
+        {
+            return hr_trace_state.name_ids[slot];
+        }
+
+        if (hr_trace_state.names[slot] == NULL)
+        {
+            const size_t length = strlen(name) > 0xFFFF ? 0xFFFF : strlen(name);
+            hr_trace_state.names[slot] = name;
+            hr_trace_state.name_ids[slot] = ++hr_trace_state.name_count;
+
+            // Name record: 'N', u32 id, u16 length, bytes
+            fputc('N', hr_trace_state.file);
+            hr_trace_write_le(hr_trace_state.file, hr_trace_state.name_ids[slot], 4);
+            hr_trace_write_le(hr_trace_state.file, length, 2);
+            fwrite(name, 1, length, hr_trace_state.file);
+            return hr_trace_state.name_ids[slot];
+        }
+    }
+
+    return 0; // Table full, reported as an unnamed zone
+}
+
+/**
+ * \brief Moves every pending event from the ring buffers to the trace file.
+ *
+ * The background drainer calls this periodically; it may also be called by
+ * hand, e.g. when no drainer thread is wanted. Concurrent calls are serialized.
+ *
+ * \return The number of events written.
+ */
+static inline unsigned long long hr_trace_flush()
+{
+    while (!hr_atomic_cas_int(&hr_trace_state.draining, 0, 1))
+    {
+        hr_thread_yield(); // Another thread is draining
+    }
+
+    unsigned long long written = 0;
+    for (hr_trace_ring_t *ring = (hr_trace_ring_t *)hr_atomic_load_ptr(&hr_trace_state.rings);
+         ring != NULL;
+         ring = ring->next)
+    {
+        const unsigned long long head = hr_atomic_load_u64(&ring->head);
+        unsigned long long tail = ring->tail; // Only the drainer writes tail
+        if (hr_trace_state.file != NULL)
+        {
+            for (; tail != head; tail++)
+            {
+                const hr_trace_event_t *const event = &ring->events[tail & (FLUENT_LIBC_CLOCK_TRACE_RING_EVENTS - 1)];
+                const unsigned int name_id = hr_trace_intern(event->name);
+
+                // Event record: type, u32 thread id, u32 name id, i64 timestamp
+                fputc(event->type, hr_trace_state.file);
+                hr_trace_write_le(hr_trace_state.file, ring->thread_id, 4);
+                hr_trace_write_le(hr_trace_state.file, name_id, 4);
+                hr_trace_write_le(hr_trace_state.file, (unsigned long long)event->timestamp, 8);
+                written++;
+            }
+        }
+
+        hr_atomic_store_u64(&ring->tail, head); // Release the slots
+    }
+
+    if (hr_trace_state.file != NULL)
+    {
+        fflush(hr_trace_state.file);
+    }
+
+    hr_atomic_store_int(&hr_trace_state.draining, 0);
+    return written;
+}
+
+/**
+ * \brief Returns the number of events dropped so far because a ring buffer was full.
+ */
+static inline unsigned long long hr_trace_dropped()
+{
+    unsigned long long dropped = 0;
+    for (hr_trace_ring_t *ring = (hr_trace_ring_t *)hr_atomic_load_ptr(&hr_trace_state.rings);
+         ring != NULL;
+         ring = ring->next)
+    {
+        dropped += hr_atomic_load_u64_relaxed(&ring->dropped);
+    }
+
+    return dropped;
+}
+
+/**
+ * \brief Entry point of the background drainer thread.
+ */
+static inline void hr_trace_drainer_main(void *const arg)
+{
+    (void)arg;
+    while (hr_atomic_load_int(&hr_trace_state.running))
+    {
+        hr_trace_flush();
+        hr_thread_sleep_nanos(FLUENT_LIBC_CLOCK_TRACE_DRAIN_INTERVAL_NS);
+    }
+}
+
+/**
+ * \brief Starts recording zones into a binary trace file.
+ *
+ * \param path The file to create; any existing file is overwritten.
+ * \param background Non-zero to start a drainer thread, 0 to drain only via hr_trace_flush().
+ * \return Non-zero on success, 0 if a trace is already running or the file could not be opened.
+ */
+static inline int hr_trace_start_ex(const char *const path, const int background)
+{
+    if (path == NULL || hr_trace_state.file != NULL)
+    {
+        return 0; // Handle null pointer or trace already running
+    }
+
+    FILE *const file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return 0; // Could not open the file
+    }
+
+    // Discard whatever was recorded before this trace
+    hr_trace_flush();
+    memset((void *)hr_trace_state.names, 0, sizeof(hr_trace_state.names));
+    hr_trace_state.name_count = 0;
+
+    // Header: magic, u32 version
+    fwrite("HRTRACE", 1, 8, file);
+    hr_trace_write_le(file, 1, 4);
+    hr_trace_state.file = file;
+
+    hr_atomic_store_int(&hr_trace_state.running, background);
+    if (background && !hr_thread_create(&hr_trace_state.drainer, hr_trace_drainer_main, NULL))
+    {
+        hr_atomic_store_int(&hr_trace_state.running, 0); // Drain manually instead
+    }
+
+    hr_atomic_store_int(&hr_trace_state.recording, 1);
+    return 1;
+}
+
+/**
+ * \brief Starts recording zones, drained by a background thread.
+ *
+ * \param path The file to create; any existing file is overwritten.
+ * \return Non-zero on success, 0 if a trace is already running or the file could not be opened.
+ */
+static inline int hr_trace_start(const char *const path)
+{
+    return hr_trace_start_ex(path, 1);
+}
+
+/**
+ * \brief Stops recording, drains the remaining events and closes the trace file.
+ */
+static inline void hr_trace_stop()
+{
+    if (hr_trace_state.file == NULL)
+    {
+        return; // Not running
+    }
+
+    hr_atomic_store_int(&hr_trace_state.recording, 0);
+    if (hr_atomic_load_int(&hr_trace_state.running))
+    {
+        hr_atomic_store_int(&hr_trace_state.running, 0);
+        hr_thread_join(&hr_trace_state.drainer);
+    }
+
+    hr_trace_flush();
+    fclose(hr_trace_state.file);
+    hr_trace_state.file = NULL;
+}
+
+/**
+ * \brief Converts a binary trace written by hr_trace_start() to Chrome Trace JSON.
+ *
+ * The output loads in chrome://tracing and https://ui.perfetto.dev. Timestamps
+ * are relative to the first event, in microseconds with nanosecond decimals.
+ *
+ * \param trace_path The binary trace to read.
+ * \param json_path The JSON file to create.
+ * \return The number of events exported, or -1 if a file could not be opened or the trace is malformed.
+ */
+static inline long long hr_trace_export_chrome(const char *const trace_path, const char *const json_path)
+{
+    if (trace_path == NULL || json_path == NULL)
+    {
+        return -1l; // Handle null pointers
+    }
+
+    FILE *const in = fopen(trace_path, "rb");
+    if (in == NULL)
+    {
+        return -1l; // Could not open the trace
+    }
+
+    char magic[8];
+    unsigned long long version;
+    if (fread(magic, 1, 8, in) != 8 || memcmp(magic, "HRTRACE", 8) != 0 || !hr_trace_read_le(in, &version, 4))
+    {
+        fclose(in);
+        return -1l; // Not a trace file
+    }
+
+    FILE *const out = fopen(json_path, "w");
+    if (out == NULL)
+    {
+        fclose(in);
+        return -1l; // Could not create the output
+    }
+
+    char **names = NULL;
+    unsigned long long capacity = 0;
+    long long exported = 0;
+    long long origin = 0;
+    int tag;
+
+    fputs("{\"traceEvents\":[", out);
+    while ((tag = fgetc(in)) != EOF)
+    {
+        unsigned long long id, length, thread_id, timestamp;
+        if (tag == 'N')
+        {
+            if (!hr_trace_read_le(in, &id, 4) || !hr_trace_read_le(in, &length, 2))
+            {
+                exported = -1l;
+                break; // Truncated record
+            }
+
+            if (id >= capacity)
+            {
+                const unsigned long long grown = id * 2 + 16;
+                char **const resized = (char **)realloc(names, grown * sizeof(char *));
+                if (resized == NULL)
+                {
+                    exported = -1l;
+                    break; // Out of memory
+                }
+                memset(resized + capacity, 0, (grown - capacity) * sizeof(char *));
+                names = resized;
+                capacity = grown;
+            }
+
+            free(names[id]);
+            names[id] = (char *)malloc(length + 1);
+            if (names[id] == NULL || fread(names[id], 1, length, in) != length)
+            {
+                exported = -1l;
+                break; // Out of memory or truncated record
+            }
+            names[id][length] = '\0';
+            continue;
+        }
+
+        if ((tag != HR_TRACE_BEGIN && tag != HR_TRACE_END)
+            || !hr_trace_read_le(in, &thread_id, 4)
+            || !hr_trace_read_le(in, &id, 4)
+            || !hr_trace_read_le(in, &timestamp, 8))
+        {
+            exported = -1l;
+            break; // Unknown or truncated record
+        }
+
+        if (exported == 0)
+        {
+            origin = (long long)timestamp;
+        }
+
+        const long long relative = (long long)timestamp - origin;
+        const unsigned long long magnitude = relative < 0 ? 0 - (unsigned long long)relative : (unsigned long long)relative;
+        fputs(exported == 0 ? "\n{\"name\":" : ",\n{\"name\":", out);
+        hr_bench_write_json_string(out, id < capacity && names[id] != NULL ? names[id] : "(unnamed)");
+        fprintf(
+            out,
+            ",\"ph\":\"%c\",\"ts\":%s%llu.%03llu,\"pid\":1,\"tid\":%llu}",
+            tag,
+            relative < 0 ? "-" : "",
+            magnitude / 1000,
+            magnitude % 1000,
+            thread_id
+        );
+        exported++;
+    }
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", out);
+
+    for (unsigned long long i = 0; i < capacity; i++)
+    {
+        free(names[i]);
+    }
+    free(names);
+    fclose(out);
+    fclose(in);
+    return exported;
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+// ============= ZONES =============
+
+#if defined(FLUENT_LIBC_CLOCK_TRACE)
+#   define HR_ZONE_CONCAT_INNER(a, b) a##b
+#   define HR_ZONE_CONCAT(a, b) HR_ZONE_CONCAT_INNER(a, b)
+#   define HR_ZONE_BEGIN(name) hr_trace_emit((name), HR_TRACE_BEGIN)
+#   define HR_ZONE_END(name) hr_trace_emit((name), HR_TRACE_END)
+#   if defined(__cplusplus)
+struct hr_trace_zone_guard
+{
+    const char *name;
+    explicit hr_trace_zone_guard(const char *zone) : name(zone) { hr_trace_emit(name, HR_TRACE_BEGIN); }
+    ~hr_trace_zone_guard() { hr_trace_emit(name, HR_TRACE_END); }
+    hr_trace_zone_guard(const hr_trace_zone_guard &) = delete;
+    hr_trace_zone_guard &operator=(const hr_trace_zone_guard &) = delete;
+};
+#       define HR_ZONE(name) hr_trace_zone_guard HR_ZONE_CONCAT(hr_zone_, __LINE__)(name)
+#   elif defined(__GNUC__) || defined(__clang__)
+/**
+ * \brief Cleanup handler closing a zone opened by HR_ZONE().
+ */
+static inline void hr_trace_zone_cleanup(const char *const *const name)
+{
+    hr_trace_emit(*name, HR_TRACE_END);
+}
+#       define HR_ZONE(name) \
+    const char *HR_ZONE_CONCAT(hr_zone_, __LINE__) __attribute__((cleanup(hr_trace_zone_cleanup))) = \
+        (hr_trace_emit((name), HR_TRACE_BEGIN), (name))
+#   endif
+#else
+#   define HR_ZONE_BEGIN(name) ((void)0)
+#   define HR_ZONE_END(name) ((void)0)
+#   define HR_ZONE(name) ((void)0)
+#endif // FLUENT_LIBC_CLOCK_TRACE
+
+#endif //FLUENT_LIBC_CLOCK_TRACE_H
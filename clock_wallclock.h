@@ -0,0 +1,314 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_WALLCLOCK_H
+#define FLUENT_LIBC_CLOCK_WALLCLOCK_H
+
+// ============= FLUENT LIB C =============
+// Wall-Clock (UTC) Companion
+// ----------------------------------------
+// Maps `get_nano_time()` values to Unix epoch nanoseconds through a
+// snapshotted monotonic <-> realtime offset, and formats them as
+// ISO-8601 / RFC 3339 UTC without locales, allocation or strftime.
+//
+// Features:
+// - `hr_wallclock_to_epoch_nanos()`: Convert a `get_nano_time()` value to epoch ns
+// - `hr_wallclock_now()`: Current epoch ns at monotonic-clock cost
+// - `hr_wallclock_refresh()`: Re-snapshot the offset (also done periodically, for NTP steps)
+// - `hr_wallclock_format_iso8601()`: "2025-01-31T12:34:56.789012345Z", date prefix cached per second
+//
+// Example:
+// ----------------------------------------
+//   char line[HR_WALLCLOCK_ISO8601_SIZE];
+//   hr_wallclock_format_iso8601(hr_wallclock_now(), 6, line, sizeof(line));
+//   printf("%s request done\n", line);
+//
+
+#include <string.h>
+#include "clock.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_WALLCLOCK_REFRESH_NS
+ * \brief Default age after which the offset is re-snapshotted (1 s).
+ */
+#ifndef FLUENT_LIBC_CLOCK_WALLCLOCK_REFRESH_NS
+#   define FLUENT_LIBC_CLOCK_WALLCLOCK_REFRESH_NS 1000000000LL
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_WALLCLOCK_SAMPLES
+ * \brief Bracketed reads per snapshot; the tightest bracket wins.
+ */
+#ifndef FLUENT_LIBC_CLOCK_WALLCLOCK_SAMPLES
+#   define FLUENT_LIBC_CLOCK_WALLCLOCK_SAMPLES 5
+#endif
+
+/**
+ * \def HR_WALLCLOCK_ISO8601_SIZE
+ * \brief Buffer size that fits any timestamp hr_wallclock_format_iso8601() writes, NUL included.
+ */
+#define HR_WALLCLOCK_ISO8601_SIZE 32
+
+/**
+ * \struct hr_wallclock_state_t
+ * \brief Process-wide monotonic <-> realtime mapping.
+ *
+ * The two words may be read torn across a refresh; either snapshot is valid.
+ */
+typedef struct
+{
+    volatile unsigned long long offset;    ///< Realtime minus get_nano_time(), in ns (two's complement)
+    volatile unsigned long long refreshed; ///< get_nano_time() of the last snapshot, 0 if none
+    volatile unsigned long long interval;  ///< Refresh interval in ns, 0 for the default
+} hr_wallclock_state_t;
+
+FLUENT_LIBC_CLOCK_GLOBAL hr_wallclock_state_t hr_wallclock_state = FLUENT_LIBC_CLOCK_ZERO_INIT;
+
+/**
+ * \struct hr_wallclock_prefix_t
+ * \brief Per-thread cache of the formatted "YYYY-MM-DDTHH:MM:SS" of one second.
+ */
+typedef struct
+{
+    long long second; ///< Epoch second the prefix belongs to
+    int valid;        ///< Non-zero once \p text is filled
+    char text[20];    ///< Formatted prefix and NUL
+} hr_wallclock_prefix_t;
+
+FLUENT_LIBC_CLOCK_GLOBAL_THREAD_LOCAL hr_wallclock_prefix_t hr_wallclock_thread_prefix = {0, 0, {0}};
+
+/**
+ * \brief Reads the realtime (UTC) clock directly.
+ *
+ * \return Nanoseconds since 1970-01-01T00:00:00Z.
+ */
+static inline long long hr_wallclock_realtime_nanos()
+{
+#ifdef _WIN32
+#   ifdef FLUENT_LIBC_NO_WINDOWS_SDK
+    return 0LL; // Return 0
+#   else
+    FILETIME ft;
+    GetSystemTimePreciseAsFileTime(&ft); // 100 ns units since 1601
+    const unsigned long long ticks = ((unsigned long long)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return ((long long)ticks - 116444736000000000LL) * 100LL;
+#   endif // FLUENT_LIBC_NO_WINDOWS_SDK
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+/**
+ * \brief Snapshots the realtime - get_nano_time() offset.
+ *
+ * Each realtime read is bracketed by two monotonic reads and paired with
+ * their midpoint; the narrowest bracket has the smallest error.
+ */
+static inline void hr_wallclock_refresh()
+{
+    long long best_offset = 0;
+    long long best_width = -1;
+    long long best_at = 0;
+    for (int i = 0; i < FLUENT_LIBC_CLOCK_WALLCLOCK_SAMPLES; i++)
+    {
+        const long long before = get_nano_time();
+        const long long real = hr_wallclock_realtime_nanos();
+        const long long after = get_nano_time();
+        if (best_width < 0 || after - before < best_width)
+        {
+            best_width = after - before;
+            best_at = before + (after - before) / 2;
+            best_offset = real - best_at;
+        }
+    }
+
+    hr_atomic_store_u64_relaxed(&hr_wallclock_state.offset, (unsigned long long)best_offset);
+    hr_atomic_store_u64(&hr_wallclock_state.refreshed, (unsigned long long)(best_at != 0 ? best_at : 1));
+}
+
+/**
+ * \brief Sets how old the offset may get before it is re-snapshotted.
+ *
+ * Shorter intervals pick up NTP steps sooner; slewing is tracked either way.
+ *
+ * \param interval_ns The interval in nanoseconds, or 0 for FLUENT_LIBC_CLOCK_WALLCLOCK_REFRESH_NS.
+ */
+static inline void hr_wallclock_set_refresh_interval(const long long interval_ns)
+{
+    hr_atomic_store_u64_relaxed(&hr_wallclock_state.interval, interval_ns > 0 ? (unsigned long long)interval_ns : 0);
+}
+
+/**
+ * \brief Converts a get_nano_time() value to Unix epoch nanoseconds.
+ *
+ * The offset is re-snapshotted when \p nanos is more than the refresh
+ * interval past the last snapshot, so this costs an add in the common case.
+ *
+ * \param nanos A get_nano_time() value on a monotonic source.
+ * \return Nanoseconds since 1970-01-01T00:00:00Z.
+ */
+static inline long long hr_wallclock_to_epoch_nanos(const long long nanos)
+{
+    const unsigned long long interval = hr_atomic_load_u64_relaxed(&hr_wallclock_state.interval);
+    const long long refreshed = (long long)hr_atomic_load_u64(&hr_wallclock_state.refreshed);
+    if (refreshed == 0
+        || nanos - refreshed > (interval != 0 ? (long long)interval : FLUENT_LIBC_CLOCK_WALLCLOCK_REFRESH_NS))
+    {
+        hr_wallclock_refresh();
+    }
+
+    return nanos + (long long)hr_atomic_load_u64_relaxed(&hr_wallclock_state.offset);
+}
+
+/**
+ * \brief Returns the current Unix time in nanoseconds, read through the monotonic clock.
+ */
+static inline long long hr_wallclock_now()
+{
+    return hr_wallclock_to_epoch_nanos(get_nano_time());
+}
+
+/**
+ * \brief Writes \p value as exactly \p width zero-padded decimal digits.
+ */
+static inline char *hr_wallclock_put_digits(char *out, unsigned long long value, const int width)
+{
+    for (int i = width - 1; i >= 0; i--)
+    {
+        out[i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+
+    return out + width;
+}
+
+/**
+ * \brief Formats "YYYY-MM-DDTHH:MM:SS" for an epoch second (proleptic Gregorian, UTC).
+ *
+ * Uses Howard Hinnant's days-to-civil algorithm. Years are written with four
+ * digits, which covers every second a 64-bit nanosecond timestamp can reach
+ * (1677 to 2262).
+ *
+ * \return The number of characters written (no NUL).
+ */
+static inline int hr_wallclock_format_prefix(const long long second, char *const out)
+{
+    long long days = second / 86400;
+    long long rem = second % 86400;
+    if (rem < 0)
+    {
+        rem += 86400;
+        days--;
+    }
+
+    // Shift the epoch to 0000-03-01 so leap days end each 400-year era
+    const long long z = days + 719468;
+    const long long era = (z >= 0 ? z : z - 146096) / 146097;
+    const long long doe = z - era * 146097;
+    const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const long long mp = (5 * doy + 2) / 153;
+    const long long day = doy - (153 * mp + 2) / 5 + 1;
+    const long long month = mp < 10 ? mp + 3 : mp - 9;
+    const long long year = yoe + era * 400 + (month <= 2);
+
+    char *p = hr_wallclock_put_digits(out, (unsigned long long)year, 4);
+    *p++ = '-';
+    p = hr_wallclock_put_digits(p, (unsigned long long)month, 2);
+    *p++ = '-';
+    p = hr_wallclock_put_digits(p, (unsigned long long)day, 2);
+    *p++ = 'T';
+    p = hr_wallclock_put_digits(p, (unsigned long long)(rem / 3600), 2);
+    *p++ = ':';
+    p = hr_wallclock_put_digits(p, (unsigned long long)(rem / 60 % 60), 2);
+    *p++ = ':';
+    p = hr_wallclock_put_digits(p, (unsigned long long)(rem % 60), 2);
+    return (int)(p - out);
+}
+
+/**
+ * \brief Formats epoch nanoseconds as an ISO-8601 / RFC 3339 UTC timestamp.
+ *
+ * Produces "YYYY-MM-DDTHH:MM:SS[.fraction]Z" with \p digits fractional digits.
+ * The date and time of day are cached per thread for the last formatted
+ * second, so consecutive log lines only format the fraction.
+ *
+ * \param epoch_nanos Nanoseconds since 1970-01-01T00:00:00Z (see hr_wallclock_now()).
+ * \param digits Fractional digits, 0 (seconds) to 9 (nanoseconds); clamped.
+ * \param buffer Destination; HR_WALLCLOCK_ISO8601_SIZE bytes always suffice.
+ * \param size Size of \p buffer in bytes.
+ * \return The length of the string written (without NUL), or 0 if the pointer is NULL or the buffer is too small.
+ */
+static inline size_t hr_wallclock_format_iso8601(
+    const long long epoch_nanos,
+    int digits,
+    char *const buffer,
+    const size_t size
+)
+{
+    if (buffer == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    digits = digits < 0 ? 0 : (digits > 9 ? 9 : digits);
+    long long second = epoch_nanos / 1000000000LL;
+    long long fraction = epoch_nanos % 1000000000LL;
+    if (fraction < 0)
+    {
+        fraction += 1000000000LL;
+        second--;
+    }
+
+    hr_wallclock_prefix_t *const cache = &hr_wallclock_thread_prefix;
+    if (!cache->valid || cache->second != second)
+    {
+        cache->text[hr_wallclock_format_prefix(second, cache->text)] = '\0';
+        cache->second = second;
+        cache->valid = 1;
+    }
+
+    const size_t prefix = 19; // "YYYY-MM-DDTHH:MM:SS"
+    const size_t length = prefix + (digits > 0 ? (size_t)digits + 1 : 0) + 1;
+    if (length + 1 > size)
+    {
+        return 0; // Buffer too small
+    }
+
+    memcpy(buffer, cache->text, prefix);
+    char *p = buffer + prefix;
+    if (digits > 0)
+    {
+        static const long long powers[] = {
+            1000000000LL, 100000000LL, 10000000LL, 1000000LL, 100000LL, 10000LL, 1000LL, 100LL, 10LL, 1LL
+        };
+        *p++ = '.';
+        p = hr_wallclock_put_digits(p, (unsigned long long)(fraction / powers[digits]), digits); // Truncates
+    }
+
+    *p++ = 'Z';
+    *p = '\0';
+    return length;
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_WALLCLOCK_H
@@ -0,0 +1,462 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_CLOCK_WINDOW_H
+#define FLUENT_LIBC_CLOCK_WINDOW_H
+
+// ============= FLUENT LIB C =============
+// Fixed-interval Window Series
+// ----------------------------------------
+// Rolls timing samples up into consecutive windows of a fixed length
+// (e.g. 1 s or 1 min) for export. The windows live in a preallocated ring:
+// window `now / interval` maps to slot `window % windows`, and the first
+// sample of a new window recycles the slot it lands on, so rotation is O(1)
+// and recording never allocates.
+//
+// Features:
+// - `hr_window_series_init()`: Pre-allocate the ring (optionally one histogram per window)
+// - `hr_window_series_record_at()`: Add a sample to the window containing `now`
+// - `hr_window_series_record()`: Same, reading the current time
+// - `hr_window_series_record_clock()`: Stop an `hr_clock_t` and record the interval
+// - `hr_window_series_snapshot()`: Lock-free copy of the retained windows, oldest first
+// - `hr_window_series_histogram()`: Lock-free copy of one window's histogram
+//
+// Recording is safe from any number of threads; every field is updated with
+// relaxed atomics. A slot is taken over by CAS on its window number, the new
+// owner resets it and then publishes the window, so recorders of the new
+// window only wait for that reset. Samples that arrive after their slot has
+// been recycled for a later window are dropped and counted.
+//
+// Example:
+// ----------------------------------------
+//   hr_window_series_t per_second;
+//   hr_window_series_init(&per_second, 120, 1, CLOCK_SECONDS, 0);
+//   ...
+//   hr_window_series_record_clock(&per_second, &request_clock); // Request threads
+//   ...
+//   hr_window_t windows[120];                                   // Exporter thread
+//   size_t n = hr_window_series_snapshot(&per_second, get_nano_time(), windows, 120);
+//   for (size_t i = 0; i < n; i++)
+//   {
+//       if (windows[i].complete) export(windows[i].start, windows[i].count, windows[i].sum);
+//   }
+//   hr_window_series_destroy(&per_second);
+//
+
+#include <stdlib.h>
+#include "clock.h"
+#include "clock_histogram.h"
+#include "clock_thread.h"
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/**
+ * \def FLUENT_LIBC_CLOCK_WINDOW_CLAIMED
+ * \brief Window number marking a slot whose new owner is resetting it.
+ */
+#define FLUENT_LIBC_CLOCK_WINDOW_CLAIMED (~0ULL)
+
+/**
+ * \def FLUENT_LIBC_CLOCK_WINDOW_BIAS
+ * \brief Added to min / max so that unsigned comparisons order signed samples.
+ */
+#define FLUENT_LIBC_CLOCK_WINDOW_BIAS (1ULL << 63)
+
+/**
+ * \struct hr_window_bucket_t
+ * \brief One slot of the ring.
+ */
+typedef struct
+{
+    volatile unsigned long long window; ///< Window number + 1, 0 when never used, CLAIMED while resetting
+    volatile unsigned long long count;  ///< Samples recorded in the window
+    volatile unsigned long long sum;    ///< Sum of the samples in nanoseconds (two's complement)
+    volatile unsigned long long min;    ///< Smallest sample, biased by FLUENT_LIBC_CLOCK_WINDOW_BIAS
+    volatile unsigned long long max;    ///< Largest sample, biased by FLUENT_LIBC_CLOCK_WINDOW_BIAS
+    hr_histogram_t *hist;               ///< Per-window histogram, or NULL
+} hr_window_bucket_t;
+
+/**
+ * \struct hr_window_series_t
+ * \brief A fixed number of consecutive windows of equal length.
+ */
+typedef struct
+{
+    hr_window_bucket_t *buckets;         ///< The ring, \p windows slots
+    hr_histogram_t *histograms;          ///< One histogram per slot, or NULL
+    unsigned int windows;                ///< Number of slots (windows retained)
+    long long interval_ns;               ///< Window length in nanoseconds
+    volatile unsigned long long dropped; ///< Samples whose window had already been recycled
+} hr_window_series_t;
+
+/**
+ * \struct hr_window_t
+ * \brief A snapshot of one window.
+ */
+typedef struct
+{
+    long long start;          ///< Start of the window on the get_nano_time() timeline
+    unsigned long long count; ///< Samples recorded
+    long long sum;            ///< Sum of the samples in nanoseconds
+    long long min;            ///< Smallest sample (0 if count is 0)
+    long long max;            ///< Largest sample (0 if count is 0)
+    int complete;             ///< Non-zero if the window has ended at the snapshot time
+} hr_window_t;
+
+/**
+ * \brief Initializes a series and allocates its ring.
+ *
+ * This is the only allocation; recording and snapshots use the ring as is.
+ *
+ * \param series Pointer to the \p hr_window_series_t to initialize.
+ * \param windows Number of windows retained (the ring size).
+ * \param interval The window length, in \p unit.
+ * \param unit The unit of \p interval.
+ * \param histograms Non-zero to keep an \p hr_histogram_t per window.
+ * \return Non-zero on success, 0 if an argument is invalid or allocation failed.
+ */
+static inline int hr_window_series_init(
+    hr_window_series_t *const series,
+    const unsigned int windows,
+    const long long interval,
+    const hr_clock_time_unit_t unit,
+    const int histograms
+)
+{
+    if (series == NULL || windows == 0 || interval <= 0 || (unsigned int)unit > (unsigned int)CLOCK_DAYS)
+    {
+        return 0; // Handle null pointer or invalid arguments
+    }
+
+    const long long unit_nanos = hr_clock_unit_nanos[unit];
+    if (interval > 0x7FFFFFFFFFFFFFFFLL / unit_nanos)
+    {
+        return 0;
+    }
+
+    series->buckets = (hr_window_bucket_t *)malloc((size_t)windows * sizeof(hr_window_bucket_t));
+    if (series->buckets == NULL)
+    {
+        return 0;
+    }
+
+    series->histograms = NULL;
+    if (histograms)
+    {
+        series->histograms = (hr_histogram_t *)calloc(windows, sizeof(hr_histogram_t));
+        if (series->histograms == NULL)
+        {
+            free(series->buckets);
+            series->buckets = NULL;
+            return 0;
+        }
+    }
+
+    for (unsigned int i = 0; i < windows; i++)
+    {
+        hr_window_bucket_t *const bucket = &series->buckets[i];
+        bucket->window = 0;
+        bucket->count = 0;
+        bucket->sum = 0;
+        bucket->min = ~0ULL;
+        bucket->max = 0;
+        bucket->hist = series->histograms != NULL ? &series->histograms[i] : NULL;
+    }
+
+    series->windows = windows;
+    series->interval_ns = interval * unit_nanos;
+    series->dropped = 0;
+    return 1;
+}
+
+/**
+ * \brief Releases the ring. No thread may record into the series afterwards.
+ *
+ * \param series Pointer to the \p hr_window_series_t to destroy.
+ */
+static inline void hr_window_series_destroy(hr_window_series_t *const series)
+{
+    if (series == NULL)
+    {
+        return; // Handle null pointer
+    }
+
+    free(series->buckets);
+    free(series->histograms);
+    series->buckets = NULL;
+    series->histograms = NULL;
+    series->windows = 0;
+}
+
+/**
+ * \brief Returns the slot holding window number \p id (window + 1), taking it over if it is stale.
+ *
+ * \return The slot, or NULL if it already holds a later window.
+ */
+static inline hr_window_bucket_t *hr_window_series_claim(hr_window_series_t *const series, const unsigned long long id)
+{
+    hr_window_bucket_t *const bucket = &series->buckets[(id - 1) % series->windows];
+    for (;;)
+    {
+        const unsigned long long current = hr_atomic_load_u64(&bucket->window);
+        if (current == id)
+        {
+            return bucket;
+        }
+
+        if (current == FLUENT_LIBC_CLOCK_WINDOW_CLAIMED)
+        {
+            hr_cpu_relax(); // Another recorder is resetting the slot for this or a later window
+            continue;
+        }
+
+        if (current > id)
+        {
+            return NULL;
+        }
+
+        if (hr_atomic_cas_u64(&bucket->window, current, FLUENT_LIBC_CLOCK_WINDOW_CLAIMED))
+        {
+            hr_atomic_store_u64_relaxed(&bucket->count, 0);
+            hr_atomic_store_u64_relaxed(&bucket->sum, 0);
+            hr_atomic_store_u64_relaxed(&bucket->min, ~0ULL);
+            hr_atomic_store_u64_relaxed(&bucket->max, 0);
+            hr_histogram_reset(bucket->hist);
+            hr_atomic_store_u64(&bucket->window, id);
+            return bucket;
+        }
+    }
+}
+
+/**
+ * \brief Records a sample into the window containing \p now.
+ *
+ * \param series Pointer to the \p hr_window_series_t to record into.
+ * \param nanos The sample, in nanoseconds.
+ * \param now The time of the sample on the get_nano_time() timeline.
+ * \return Non-zero if recorded, 0 if the pointer is NULL, \p now is negative
+ *         or the window has already been recycled (counted in \p dropped).
+ */
+static inline int hr_window_series_record_at(hr_window_series_t *const series, const long long nanos, const long long now)
+{
+    if (series == NULL || series->buckets == NULL || now < 0)
+    {
+        return 0; // Handle null pointer or invalid time
+    }
+
+    hr_window_bucket_t *const bucket = hr_window_series_claim(
+        series, (unsigned long long)(now / series->interval_ns) + 1);
+    if (bucket == NULL)
+    {
+        hr_atomic_fetch_add_u64_relaxed(&series->dropped, 1);
+        return 0;
+    }
+
+    const unsigned long long biased = (unsigned long long)nanos + FLUENT_LIBC_CLOCK_WINDOW_BIAS;
+    hr_atomic_fetch_add_u64_relaxed(&bucket->count, 1);
+    hr_atomic_fetch_add_u64_relaxed(&bucket->sum, (unsigned long long)nanos);
+
+    unsigned long long seen = hr_atomic_load_u64_relaxed(&bucket->min);
+    while (biased < seen && !hr_atomic_cas_u64(&bucket->min, seen, biased))
+    {
+        seen = hr_atomic_load_u64_relaxed(&bucket->min);
+    }
+
+    seen = hr_atomic_load_u64_relaxed(&bucket->max);
+    while (biased > seen && !hr_atomic_cas_u64(&bucket->max, seen, biased))
+    {
+        seen = hr_atomic_load_u64_relaxed(&bucket->max);
+    }
+
+    hr_histogram_record(bucket->hist, nanos);
+    return 1;
+}
+
+/**
+ * \brief Records a sample into the current window.
+ *
+ * \param series Pointer to the \p hr_window_series_t to record into.
+ * \param nanos The sample, in nanoseconds.
+ * \return Non-zero if recorded; see hr_window_series_record_at().
+ */
+static inline int hr_window_series_record(hr_window_series_t *const series, const long long nanos)
+{
+    return hr_window_series_record_at(series, nanos, get_nano_time());
+}
+
+/**
+ * \brief Records the time elapsed since \p clock was started, in the current window.
+ *
+ * For the monotonic sources the reading that ends the interval also picks
+ * the window; the CPU-time sources are on another timeline, so the window
+ * comes from a separate get_nano_time() call.
+ *
+ * \param series Pointer to the \p hr_window_series_t to record into.
+ * \param clock Pointer to the \p hr_clock_t holding the start time.
+ * \return The recorded duration in nanoseconds, or -1 if a pointer is NULL
+ *         or the sample was dropped.
+ */
+static inline long long hr_window_series_record_clock(hr_window_series_t *const series, const hr_clock_t *const clock)
+{
+    if (series == NULL || clock == NULL)
+    {
+        return -1l; // Handle null pointer
+    }
+
+    const hr_clock_source_t source = hr_clock_source_of(clock);
+    const long long end = get_nano_time_ex(source);
+    const long long now = source >= CLOCK_SOURCE_THREAD_CPUTIME ? get_nano_time() : end;
+    const long long elapsed = end - clock->start_time;
+    return hr_window_series_record_at(series, elapsed, now) ? elapsed : -1l;
+}
+
+/**
+ * \brief Reads window number \p id (window + 1) if its slot still holds it.
+ *
+ * The slot's window number is checked before and after the copy, so a slot
+ * recycled mid-read is reported as missing rather than mixing two windows.
+ *
+ * \return Non-zero if \p out was filled.
+ */
+static inline int hr_window_series_read(
+    const hr_window_series_t *const series,
+    const unsigned long long id,
+    hr_window_t *const out
+)
+{
+    hr_window_bucket_t *const bucket = &series->buckets[(id - 1) % series->windows];
+    if (hr_atomic_load_u64(&bucket->window) != id)
+    {
+        return 0;
+    }
+
+    const unsigned long long count = hr_atomic_load_u64_relaxed(&bucket->count);
+    const unsigned long long sum = hr_atomic_load_u64_relaxed(&bucket->sum);
+    const unsigned long long min = hr_atomic_load_u64_relaxed(&bucket->min);
+    const unsigned long long max = hr_atomic_load_u64_relaxed(&bucket->max);
+
+    hr_atomic_fence_acquire();
+    if (hr_atomic_load_u64_relaxed(&bucket->window) != id)
+    {
+        return 0;
+    }
+
+    out->start = (long long)(id - 1) * series->interval_ns;
+    out->count = count;
+    out->sum = (long long)sum;
+    out->min = count != 0 && min != ~0ULL ? (long long)(min - FLUENT_LIBC_CLOCK_WINDOW_BIAS) : 0;
+    out->max = count != 0 && max != 0 ? (long long)(max - FLUENT_LIBC_CLOCK_WINDOW_BIAS) : 0;
+    return 1;
+}
+
+/**
+ * \brief Copies every retained window that has samples, oldest first.
+ *
+ * Lock-free and safe to call while other threads record. The windows
+ * considered are the \p windows most recent ones up to the one containing
+ * \p now; that last one is still filling and has \p complete set to 0.
+ * Counters of a window are read one by one, so a window that is still
+ * receiving samples may be copied between two of its updates.
+ *
+ * \param series Pointer to the \p hr_window_series_t to read.
+ * \param now The snapshot time on the get_nano_time() timeline.
+ * \param out Destination array.
+ * \param capacity Number of entries \p out can hold.
+ * \return The number of windows written to \p out.
+ */
+static inline size_t hr_window_series_snapshot(
+    const hr_window_series_t *const series,
+    const long long now,
+    hr_window_t *const out,
+    const size_t capacity
+)
+{
+    if (series == NULL || series->buckets == NULL || out == NULL || now < 0)
+    {
+        return 0; // Handle null pointer or invalid time
+    }
+
+    const unsigned long long current = (unsigned long long)(now / series->interval_ns) + 1;
+    const unsigned long long oldest = current > series->windows ? current - series->windows + 1 : 1;
+
+    size_t written = 0;
+    for (unsigned long long id = oldest; id <= current && written < capacity; id++)
+    {
+        if (hr_window_series_read(series, id, &out[written]) && out[written].count != 0)
+        {
+            out[written].complete = id != current;
+            written++;
+        }
+    }
+
+    return written;
+}
+
+/**
+ * \brief Copies the histogram of the window starting at or containing \p start.
+ *
+ * Lock-free; fails if the series has no histograms or the window is no
+ * longer (or not yet) held by its slot.
+ *
+ * \param series Pointer to the \p hr_window_series_t to read.
+ * \param start Any time within the window, typically \p hr_window_t.start.
+ * \param out The \p hr_histogram_t to overwrite.
+ * \return Non-zero if \p out was filled.
+ */
+static inline int hr_window_series_histogram(
+    const hr_window_series_t *const series,
+    const long long start,
+    hr_histogram_t *const out
+)
+{
+    if (series == NULL || series->buckets == NULL || series->histograms == NULL || out == NULL || start < 0)
+    {
+        return 0; // Handle null pointer or invalid time
+    }
+
+    const unsigned long long id = (unsigned long long)(start / series->interval_ns) + 1;
+    hr_window_bucket_t *const bucket = &series->buckets[(id - 1) % series->windows];
+    if (hr_atomic_load_u64(&bucket->window) != id)
+    {
+        return 0;
+    }
+
+    for (unsigned int i = 0; i < FLUENT_LIBC_CLOCK_HISTOGRAM_BUCKETS; i++)
+    {
+        hr_atomic_store_u64_relaxed(&out->counts[i], hr_atomic_load_u64_relaxed(&bucket->hist->counts[i]));
+    }
+
+    hr_atomic_fence_acquire();
+    return hr_atomic_load_u64_relaxed(&bucket->window) == id;
+}
+
+/**
+ * \brief Number of samples dropped because their window had been recycled.
+ */
+static inline unsigned long long hr_window_series_dropped(const hr_window_series_t *const series)
+{
+    if (series == NULL)
+    {
+        return 0; // Handle null pointer
+    }
+
+    return hr_atomic_load_u64_relaxed(&series->dropped);
+}
+
+// ============= FLUENT LIB C++ =============
+#if defined(__cplusplus)
+}
+#endif
+
+#endif //FLUENT_LIBC_CLOCK_WINDOW_H
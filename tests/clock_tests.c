@@ -0,0 +1,75 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type `show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type `show c' for details.
+*/
+
+// ============= FLUENT LIB C =============
+// clock_tests: correctness and accuracy checks
+// ----------------------------------------
+// Usage: clock_tests [--format table|json|csv] [--filter TEXT] [--drift-s N]
+//                    [--quick]
+//
+// Runs the checks of checks/clock_checks.h whose name contains --filter and exits
+// with status 1 if any fails. ctest runs each group as its own test; the
+// drift check runs for minutes and carries the `long` label, so
+// `ctest -LE long` skips it.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../clock.h"
+#include "../checks/clock_checks.h"
+
+static void usage(const char *const program)
+{
+    fprintf(
+        stderr,
+        "Usage: %s [--format table|json|csv] [--filter TEXT] [--drift-s N]\n"
+        "          [--quick]\n",
+        program
+    );
+}
+
+int main(const int argc, char **argv)
+{
+    const char *format = "table";
+    const char *filter = NULL;
+    long long drift_s = 10;
+    long long random_values = 1LL << 22;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const int has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--format") == 0 && has_value)
+        {
+            format = argv[++i];
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && has_value)
+        {
+            filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--drift-s") == 0 && has_value)
+        {
+            drift_s = atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--quick") == 0)
+        {
+            drift_s = 2;
+            random_values = 1LL << 16;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    hr_clock_init();
+    return clock_run_checks(format, filter, drift_s, random_values);
+}